@@ -0,0 +1,82 @@
+// file: bench/EventPoolBench.cpp
+// Heap allocations per order entered for events created through ModelEvents::make_event. Market makers with a fixed
+// 100us round trip to the exchange quote for a number of steps; every event created would have been one heap
+// allocation with make_shared, while the pools only reach the heap when a block type's free list is empty.
+//
+//   EventPoolBench [steps] [market makers]
+
+#include "src/Model.h"
+#include "src/EventBus.h"
+#include "src/TradingSimulation.h"
+#include "src/ZeroIntelligenceMarketMaker.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+
+namespace {
+
+const ModelEvents::SymbolType SYMBOL = "BTC/USD";
+
+struct OrderCounter : TradingSimulation::PrePublishHookInterface {
+    std::uint64_t orders = 0;
+
+    void on_pre_publish(EventBusSystem::AgentId, EventBusSystem::TopicId, const EventVariant& event,
+                        EventBusSystem::Timestamp, const ModelEventBus<>*) override {
+        std::visit([this](const auto& event_ptr) {
+            using E = std::decay_t<decltype(*event_ptr)>;
+            if constexpr (std::is_same_v<E, ModelEvents::LimitOrderEvent> || std::is_same_v<E, ModelEvents::MarketOrderEvent>) {
+                ++orders;
+            }
+        }, event);
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long steps = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int market_makers = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    TradingSimulation sim(SYMBOL, 47);
+    OrderCounter counter;
+    sim.get_event_bus().register_pre_publish_hook(&counter);
+
+    auto adapter_id = sim.get_exchange_adapter(SYMBOL)->get_id();
+    for (int i = 0; i < market_makers; ++i) {
+        auto trader = std::make_shared<trading::algo::ZeroIntelligenceMarketMaker>(
+                SYMBOL, 1 + i % 5, 10 + i % 40, 0.01, 0.3, 1 + i % 3, 5, "lognormal", 2.0, 0.8, 1.5, 5.0, 0.1, 0.5, 10.0, 1000 + i);
+        auto trader_id = sim.add_trader(trader);
+        sim.get_event_bus().set_inter_agent_latency(trader_id, adapter_id, EventBusSystem::LatencyParameters::Fixed(100.0, 100.0));
+        sim.get_event_bus().set_inter_agent_latency(adapter_id, trader_id, EventBusSystem::LatencyParameters::Fixed(100.0, 100.0));
+    }
+
+    TradingSimulation::FloatOrderBookLevel bids, asks;
+    for (int l = 0; l < 5; ++l) {
+        bids.push_back({50000.0 - 20 * l, 1.0 + 0.2 * l});
+        asks.push_back({50200.0 + 20 * l, 1.0 + 0.2 * l});
+    }
+    sim.create_order_book_snapshot(bids, asks);
+
+    ModelEvents::EventPoolStats before = ModelEvents::event_pool_stats();
+    auto start = std::chrono::steady_clock::now();
+    long step = 0;
+    for (; step < steps && sim.get_event_bus().get_event_queue_size() > 0; ++step) {
+        sim.get_event_bus().step();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ModelEvents::EventPoolStats after = ModelEvents::event_pool_stats();
+    sim.get_event_bus().deregister_pre_publish_hook(&counter);
+
+    std::uint64_t events = after.events_created - before.events_created;
+    std::uint64_t heap_allocations = after.heap_allocations - before.heap_allocations;
+    double orders = counter.orders ? static_cast<double>(counter.orders) : 1.0;
+    std::printf("%d market makers, fixed 100us latency, %ld steps, %.3f s\n", market_makers, step, seconds);
+    std::printf("orders %llu, events %llu, heap allocations %llu\n", static_cast<unsigned long long>(counter.orders),
+                static_cast<unsigned long long>(events), static_cast<unsigned long long>(heap_allocations));
+    std::printf("allocations per order: %.3f with make_shared (one per event), %.4f pooled\n",
+                events / orders, heap_allocations / orders);
+    return 0;
+}
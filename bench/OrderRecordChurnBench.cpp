@@ -0,0 +1,92 @@
+// file: bench/OrderRecordChurnBench.cpp
+// Order record lookups of the exchange adapter under quote churn. Market makers with a fixed 100us round trip to the
+// exchange keep replacing their quotes; the run is repeated with exchange-side expiry and with CancelFairy, and
+// reports the adapter's hash map operations and direct table probes (OrderRecordTableStats) per order entered.
+// It also checks that the adapter ends up holding records for the resting orders only, and fails if not.
+//
+//   OrderRecordChurnBench [steps] [market makers]
+
+#include "src/Model.h"
+#include "src/EventBus.h"
+#include "src/TradingSimulation.h"
+#include "src/ZeroIntelligenceMarketMaker.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+
+namespace {
+
+const ModelEvents::SymbolType SYMBOL = "BTC/USD";
+
+struct OrderCounter : TradingSimulation::PrePublishHookInterface {
+    std::uint64_t orders = 0;
+
+    void on_pre_publish(EventBusSystem::AgentId, EventBusSystem::TopicId, const EventVariant& event,
+                        EventBusSystem::Timestamp, const ModelEventBus<>*) override {
+        std::visit([this](const auto& event_ptr) {
+            using E = std::decay_t<decltype(*event_ptr)>;
+            if constexpr (std::is_same_v<E, ModelEvents::LimitOrderEvent> || std::is_same_v<E, ModelEvents::MarketOrderEvent>) {
+                ++orders;
+            }
+        }, event);
+    }
+};
+
+bool run(const char* label, bool use_cancel_fairy, long steps, int market_makers) {
+    TradingSimulation sim(SYMBOL, 47, use_cancel_fairy);
+    OrderCounter counter;
+    sim.get_event_bus().register_pre_publish_hook(&counter);
+
+    auto adapter_id = sim.get_exchange_adapter(SYMBOL)->get_id();
+    for (int i = 0; i < market_makers; ++i) {
+        auto trader = std::make_shared<trading::algo::ZeroIntelligenceMarketMaker>(
+                SYMBOL, 1 + i % 5, 10 + i % 40, 0.01, 0.3, 1 + i % 3, 5, "lognormal", 2.0, 0.8, 1.5, 5.0, 0.1, 0.5, 10.0, 1000 + i);
+        auto trader_id = sim.add_trader(trader);
+        sim.get_event_bus().set_inter_agent_latency(trader_id, adapter_id, EventBusSystem::LatencyParameters::Fixed(100.0, 100.0));
+        sim.get_event_bus().set_inter_agent_latency(adapter_id, trader_id, EventBusSystem::LatencyParameters::Fixed(100.0, 100.0));
+    }
+
+    TradingSimulation::FloatOrderBookLevel bids, asks;
+    for (int l = 0; l < 5; ++l) {
+        bids.push_back({50000.0 - 20 * l, 1.0 + 0.2 * l});
+        asks.push_back({50200.0 + 20 * l, 1.0 + 0.2 * l});
+    }
+    sim.create_order_book_snapshot(bids, asks);
+
+    auto start = std::chrono::steady_clock::now();
+    long step = 0;
+    for (; step < steps && sim.get_event_bus().get_event_queue_size() > 0; ++step) {
+        sim.get_event_bus().step();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EventModelExchangeAdapter& adapter = *sim.get_exchange_adapter(SYMBOL);
+    const OrderRecordTableStats& stats = adapter.order_record_stats();
+    double orders = counter.orders ? static_cast<double>(counter.orders) : 1.0;
+    std::size_t records = adapter.order_record_count();
+    std::size_t resting = adapter.resting_order_count();
+    std::printf("%-12s %10ld %10llu %12.2f %12.2f %10zu %10zu %10.3f\n", label, step, static_cast<unsigned long long>(counter.orders),
+                stats.hash_probes / orders, stats.table_probes / orders, records, resting, seconds);
+    sim.get_event_bus().deregister_pre_publish_hook(&counter);
+    return records == resting;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long steps = argc > 1 ? std::atol(argv[1]) : 2000000;
+    int market_makers = argc > 2 ? std::atoi(argv[2]) : 50;
+    std::printf("%d market makers, fixed 100us latency, up to %ld steps\n", market_makers, steps);
+    std::printf("%-12s %10s %10s %12s %12s %10s %10s %10s\n", "expiry", "steps", "orders", "hash/order", "table/order",
+                "records", "resting", "wall (s)");
+    bool records_match = run("native", false, steps, market_makers);
+    records_match = run("CancelFairy", true, steps, market_makers) && records_match;
+    if (!records_match) {
+        std::printf("order records left behind for orders that no longer rest\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+// file: bench/PriceLevelBench.cpp
+// Level search cost of SetLevels vs LadderLevels. Each side holds 200 levels spaced `gap` ticks apart; market
+// orders alternate sides and sweep 1-8 levels, and every swept level is refilled one gap behind the new best
+// price, so the book keeps its shape while the ladder has to skip `gap` empty ticks per level it visits.
+//
+//   PriceLevelBench [orders]
+
+#include "src/EventBus.h"
+#include "src/OrderBookCore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+constexpr int LEVELS_PER_SIDE = 200;
+constexpr SIZE_TYPE LEVEL_QUANTITY = 5;
+constexpr PRICE_TYPE MID = 100000;
+
+template <typename LevelPolicy>
+double run(long orders, PRICE_TYPE gap, long& checksum) {
+    OrderBookWrapper<LevelPolicy> book;
+    for (int l = 0; l < LEVELS_PER_SIDE; ++l) {
+        book.template book_price_quantity<DOUBLEOPTION::BACK>(SIDE::ASK, MID + 1 + l * gap, LEVEL_QUANTITY);
+        book.template book_price_quantity<DOUBLEOPTION::BACK>(SIDE::BID, MID - l * gap, LEVEL_QUANTITY);
+    }
+
+    std::mt19937 rng(7);
+    auto ignore_fill = [](auto&&...) {};
+    long filled = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < orders; ++i) {
+        SIDE side = (i % 2) ? SIDE::BID : SIDE::ASK;
+        SIDE resting_side = (side == SIDE::BID) ? SIDE::ASK : SIDE::BID;
+        int swept_levels = 1 + static_cast<int>(rng() % 8);
+        filled += book.template market_match_quantity<DOUBLEOPTION::FRONT>(side, swept_levels * LEVEL_QUANTITY, ignore_fill);
+        for (int k = 0; k < swept_levels; ++k) {
+            PRICE_TYPE price;
+            if (resting_side == SIDE::ASK) {
+                auto best = book.get_best_ask();
+                price = best ? best->first - gap : MID + 1;
+            } else {
+                auto best = book.get_best_bid();
+                price = best ? best->first + gap : MID;
+            }
+            book.template book_price_quantity<DOUBLEOPTION::BACK>(resting_side, price, LEVEL_QUANTITY);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    checksum += filled + static_cast<long>(book.get_num_orders());
+    return seconds;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    long orders = argc > 1 ? std::atol(argv[1]) : 200000;
+    long checksum = 0;
+    std::printf("%ld market orders, %d levels per side\n", orders, LEVELS_PER_SIDE);
+    std::printf("%-6s %12s %12s\n", "gap", "set (s)", "ladder (s)");
+    for (PRICE_TYPE gap : {1, 16, 256}) {
+        double set_seconds = run<SetLevels>(orders, gap, checksum);
+        double ladder_seconds = run<BasicLadderLevels<1, (1 << 20)>>(orders, gap, checksum);
+        std::printf("%-6lld %12.3f %12.3f\n", static_cast<long long>(gap), set_seconds, ladder_seconds);
+    }
+    std::printf("checksum %ld\n", checksum);
+    return 0;
+}
@@ -21,6 +21,8 @@
 #include <type_traits>      // For static_assert or type checks
 #include <limits>           // For numeric limits (if needed)
 #include <map>              // For potential state management in derived classes
+#include <algorithm>        // For std::lower_bound (LocalL2Book)
+#include <cstdint>
 
 
 namespace trading {
@@ -58,6 +60,99 @@ namespace trading {
             }
         }
 
+/**
+ * @brief Local copy of one symbol's L2 book, kept current from LTwoDeltaEvents and/or LTwoOrderBookEvents.
+ *
+ * A delta snapshot replaces the book, and deltas are applied on top of it while their sequence numbers run on: after
+ * a gap the book stays as it was and ignores deltas until the next snapshot. A full LTwoOrderBookEvent seeds the book
+ * (or resyncs it after a gap) but is ignored while the book follows the delta feed, since it may come from another
+ * publisher (e.g. the simulation's initial snapshot) and deltas are only valid against the adapter's own book.
+ */
+        class LocalL2Book {
+        public:
+            /** @brief Applies an incremental update. Returns false if it was ignored because the book is out of sync. */
+            bool apply(const ModelEvents::LTwoDeltaEvent& event) {
+                if (event.is_snapshot) {
+                    bids_.assign(event.bids.begin(), event.bids.end());
+                    asks_.assign(event.asks.begin(), event.asks.end());
+                    synced_ = true;
+                    last_sequence_ = event.sequence;
+                    return true;
+                }
+                if (!synced_) {
+                    return false;
+                }
+                if (last_sequence_ && event.sequence != *last_sequence_ + 1) {
+                    synced_ = false; // Missed an update; wait for the next snapshot
+                    return false;
+                }
+                for (const auto& level : event.bids) _apply_level(bids_, level, true);
+                for (const auto& level : event.asks) _apply_level(asks_, level, false);
+                last_sequence_ = event.sequence;
+                return true;
+            }
+
+            /**
+             * @brief Replaces the book with a full L2 event unless the book follows the delta feed. Returns false if
+             * ignored. After a replace the next delta is accepted whatever its sequence; its levels carry absolute
+             * quantities, so a delta mirroring the full event changes nothing.
+             */
+            bool apply(const ModelEvents::LTwoOrderBookEvent& event) {
+                if (synced_ && last_sequence_) {
+                    return false;
+                }
+                bids_.assign(event.bids.begin(), event.bids.end());
+                asks_.assign(event.asks.begin(), event.asks.end());
+                synced_ = true;
+                last_sequence_.reset();
+                return true;
+            }
+
+            void clear() {
+                bids_.clear();
+                asks_.clear();
+                synced_ = false;
+                last_sequence_.reset();
+            }
+
+            bool is_synced() const { return synced_; }
+            std::optional<std::uint64_t> last_sequence() const { return last_sequence_; }
+
+            /** @brief Levels sorted best-first: bids descending, asks ascending. */
+            const ModelEvents::OrderBookLevel& bids() const { return bids_; }
+            const ModelEvents::OrderBookLevel& asks() const { return asks_; }
+
+            std::optional<ModelEvents::PriceQuantityPair> best_bid() const {
+                if (bids_.empty()) return std::nullopt;
+                return bids_.front();
+            }
+            std::optional<ModelEvents::PriceQuantityPair> best_ask() const {
+                if (asks_.empty()) return std::nullopt;
+                return asks_.front();
+            }
+
+        private:
+            static void _apply_level(ModelEvents::OrderBookLevel& levels, const ModelEvents::PriceQuantityPair& update, bool descending) {
+                auto it = std::lower_bound(levels.begin(), levels.end(), update.first,
+                                           [descending](const ModelEvents::PriceQuantityPair& level, PriceType p) {
+                                               return descending ? level.first > p : level.first < p;
+                                           });
+                bool present = (it != levels.end() && it->first == update.first);
+                if (update.second == 0) {
+                    if (present) levels.erase(it);
+                } else if (present) {
+                    it->second = update.second;
+                } else {
+                    levels.insert(it, update);
+                }
+            }
+
+            ModelEvents::OrderBookLevel bids_;
+            ModelEvents::OrderBookLevel asks_;
+            bool synced_ = false;
+            std::optional<std::uint64_t> last_sequence_;
+        };
+
 /**
  * @brief Abstract CRTP base class for trading algorithms.
  *
@@ -101,6 +196,7 @@ namespace trading {
                 // ID is now set by the bus, so this->get_id() is valid here if called after registration.
                 LogMessage(LogLevel::INFO, this->get_logger_source(), "AlgoBase agent " + std::to_string(this->get_id()) + " setting up subscriptions for exchange: " + exchange_name_);
                 this->subscribe(this->format_topic("LTwoOrderBookEvent", exchange_name_));
+                this->subscribe(this->format_topic("LTwoDeltaEvent", exchange_name_));
                 this->subscribe(this->format_topic("LimitOrderAckEvent", this->get_id()));
                 this->subscribe(this->format_topic("FullFillLimitOrderEvent", this->get_id()));
                 this->subscribe(this->format_topic("PartialFillLimitOrderEvent", this->get_id()));
@@ -122,6 +218,7 @@ namespace trading {
                 this->subscribe(this->format_topic("PartialCancelLimitAckEvent", this->get_id()));
                 this->subscribe(this->format_topic("PartialCancelMarketAckEvent", this->get_id()));
                 this->subscribe(this->format_topic("FullCancelMarketOrderAckEvent", this->get_id()));
+                this->subscribe(this->format_topic("MassCancelLimitOrderAckEvent", this->get_id()));
             }
 
             // Prevent copying and assignment
@@ -144,6 +241,9 @@ namespace trading {
             /** @brief Get the name of the exchange this algo trades on. */
             const SymbolType& get_exchange_name() const { return exchange_name_; }
 
+            /** @brief The exchange's L2 book as last seen on either market-data feed. */
+            const LocalL2Book& local_book() const { return local_book_; }
+
             //--------------------------------------------------------------------------
             // Order Management API (Public methods for derived classes)
             //--------------------------------------------------------------------------
@@ -173,6 +273,32 @@ namespace trading {
                 }
             }
 
+            // Cancels all resting limit orders of this algo with a single request, optionally only on `side` and within
+            // [min_price, max_price]. The inventory drops each order when the MassCancelLimitOrderAckEvent arrives.
+            std::optional<ClientOrderIdType> create_mass_cancel_limit_orders(
+                    std::optional<ModelEvents::Side> side = std::nullopt,
+                    std::optional<PriceType> min_price = std::nullopt,
+                    std::optional<PriceType> max_price = std::nullopt
+            ) {
+                if (!this->bus_) {
+                    LogMessage(LogLevel::ERROR, this->get_logger_source(), "Cannot create mass cancel: EventBus not set.");
+                    return std::nullopt;
+                }
+
+                ClientOrderIdType cid_cancel = next_client_order_id_++;
+                Timestamp current_time = this->bus_->get_current_time();
+                auto cancel_evt_ptr = ModelEvents::make_event<ModelEvents::MassCancelLimitOrderEvent>(
+                        current_time, exchange_name_, cid_cancel, side, min_price, max_price
+                );
+
+                std::string stream_id = format_stream_id("order", this->get_id(), cid_cancel);
+                std::string topic = format_topic("MassCancelLimitOrderEvent", exchange_name_);
+                publish_wrapper(topic, stream_id, cancel_evt_ptr);
+
+                LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Created mass cancel for limit orders: CancelCID=" + std::to_string(cid_cancel));
+                return cid_cancel;
+            }
+
 
             std::optional<ClientOrderIdType> create_market_order(
                     const SymbolType& symbol,
@@ -199,7 +325,7 @@ namespace trading {
                     inventory_.market_order_create_new(cid, symbol, quantity, ModelSideToInventorySide(side));
 
                     Timestamp current_time = this->bus_->get_current_time();
-                    auto order_evt_ptr = std::make_shared<const ModelEvents::MarketOrderEvent>(
+                    auto order_evt_ptr = ModelEvents::make_event<ModelEvents::MarketOrderEvent>(
                             current_time, symbol, side, quantity, timeout, cid
                     );
 
@@ -251,7 +377,7 @@ namespace trading {
                     inventory_.limit_order_create_new(ModelSideToInventorySide(side), price, quantity, cid, symbol);
 
                     Timestamp current_time = this->bus_->get_current_time();
-                    auto order_evt_ptr = std::make_shared<const ModelEvents::LimitOrderEvent>(
+                    auto order_evt_ptr = ModelEvents::make_event<ModelEvents::LimitOrderEvent>(
                             current_time, symbol, side, price, quantity, timeout, cid
                     );
 
@@ -309,7 +435,7 @@ namespace trading {
                     inventory_.limit_order_partial_cancel_create(cid_cancel, cid_target_order, cancel_quantity);
 
                     Timestamp current_time = this->bus_->get_current_time();
-                    auto cancel_evt_ptr = std::make_shared<const ModelEvents::PartialCancelLimitOrderEvent>(
+                    auto cancel_evt_ptr = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderEvent>(
                             current_time, exchange_name_, cid_target_order, cancel_quantity, cid_cancel
                     );
 
@@ -359,7 +485,7 @@ namespace trading {
                     inventory_.limit_order_full_cancel_create(cid_cancel, cid_target_order);
 
                     Timestamp current_time = this->bus_->get_current_time();
-                    auto cancel_evt_ptr = std::make_shared<const ModelEvents::FullCancelLimitOrderEvent>(
+                    auto cancel_evt_ptr = ModelEvents::make_event<ModelEvents::FullCancelLimitOrderEvent>(
                             current_time, exchange_name_, cid_target_order, cid_cancel
                     );
 
@@ -408,7 +534,7 @@ namespace trading {
                     inventory_.market_order_full_cancel_create(cid_cancel, cid_target_order);
 
                     Timestamp current_time = this->bus_->get_current_time();
-                    auto cancel_evt_ptr = std::make_shared<const ModelEvents::FullCancelMarketOrderEvent>(
+                    auto cancel_evt_ptr = ModelEvents::make_event<ModelEvents::FullCancelMarketOrderEvent>(
                             current_time, exchange_name_, cid_target_order, cid_cancel
                     );
 
@@ -468,7 +594,7 @@ namespace trading {
                     inventory_.market_order_partial_cancel_create(cid_cancel, cid_target_order, cancel_quantity);
 
                     Timestamp current_time = this->bus_->get_current_time();
-                    auto cancel_evt_ptr = std::make_shared<const ModelEvents::PartialCancelMarketOrderEvent>(
+                    auto cancel_evt_ptr = ModelEvents::make_event<ModelEvents::PartialCancelMarketOrderEvent>(
                             current_time, exchange_name_, cid_target_order, cancel_quantity, cid_cancel
                     );
 
@@ -501,11 +627,30 @@ namespace trading {
 
             void handle_event(const ModelEvents::LTwoOrderBookEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
                 if (event.symbol != exchange_name_) return;
+                bool book_updated = local_book_.apply(event);
                 try { on_LTwoOrderBookEvent(event); }
                 catch (const std::exception& e) { handle_exception("on_LTwoOrderBookEvent", e); }
                 catch (...) { handle_unknown_exception("on_LTwoOrderBookEvent"); }
+                if (book_updated) {
+                    notify_local_book_updated();
+                }
+            }
+
+            void handle_event(const ModelEvents::LTwoDeltaEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
+                if (event.symbol != exchange_name_) return;
+                if (!local_book_.apply(event)) {
+                    LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Local L2 book out of sync, ignoring delta " + std::to_string(event.sequence));
+                    return;
+                }
+                try { on_LTwoDeltaEvent(event); }
+                catch (const std::exception& e) { handle_exception("on_LTwoDeltaEvent", e); }
+                catch (...) { handle_unknown_exception("on_LTwoDeltaEvent"); }
+                notify_local_book_updated();
             }
 
+            // Exchange adapters schedule these for themselves only.
+            void handle_event(const ModelEvents::L2PublishTimerEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+
             void handle_event(const ModelEvents::TradeEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
                 if (event.symbol != exchange_name_) return;
                 try { on_TradeEvent(event); }
@@ -577,6 +722,19 @@ namespace trading {
                 catch (...) { handle_unknown_exception("on_FullCancelLimitOrderAckEvent"); }
             }
 
+            void handle_event(const ModelEvents::MassCancelLimitOrderAckEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
+                if (event.symbol != exchange_name_) return;
+                for (const auto& cancelled : event.cancelled_orders) {
+                    try {
+                        inventory_.limit_order_execute_mass_cancel_acknowledge(cancelled.target_order_id);
+                    } catch (const std::out_of_range& e) { handle_inventory_exception("limit_order_execute_mass_cancel_acknowledge", cancelled.target_order_id, e); }
+                    catch (const std::logic_error& e) { handle_inventory_exception("limit_order_execute_mass_cancel_acknowledge", cancelled.target_order_id, e); }
+                }
+                try { on_MassCancelLimitOrderAckEvent(event); }
+                catch (const std::exception& e) { handle_exception("on_MassCancelLimitOrderAckEvent", e); }
+                catch (...) { handle_unknown_exception("on_MassCancelLimitOrderAckEvent"); }
+            }
+
             void handle_event(const ModelEvents::PartialCancelLimitAckEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
                 if (event.symbol != exchange_name_) return;
                 try {
@@ -701,6 +859,7 @@ namespace trading {
             }
 
             void handle_event(const ModelEvents::Bang& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
+                local_book_.clear();
                 try { on_Bang(event); }
                 catch (const std::exception& e) { handle_exception("on_Bang", e); }
                 catch (...) { handle_unknown_exception("on_Bang"); }
@@ -759,6 +918,9 @@ namespace trading {
                 catch (const std::exception& e) { handle_exception("on_FullCancelMarketOrderEvent", e); }
                 catch (...) { handle_unknown_exception("on_FullCancelMarketOrderEvent"); }
             }
+            void handle_event(const ModelEvents::MassCancelLimitOrderEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
+                LogMessage(LogLevel::WARNING, this->get_logger_source(), "AlgoBase received MassCancelLimitOrderEvent (typically outgoing): " + event.to_string());
+            }
             void handle_event(const ModelEvents::TriggerExpiredLimitOrderEvent& event, TopicId pub_topic_id, AgentId pub_id, Timestamp time, StreamId s_id, SequenceNumber seq) {
                 LogMessage(LogLevel::WARNING, this->get_logger_source(), "AlgoBase received TriggerExpiredLimitOrderEvent (typically internal to exchange adapter): " + event.to_string());
                 try { on_TriggerExpiredLimitOrderEvent(event); }
@@ -807,6 +969,17 @@ namespace trading {
             virtual void on_TriggerExpiredLimitOrderEvent(const ModelEvents::TriggerExpiredLimitOrderEvent& event) = 0;
             virtual void on_RejectTriggerExpiredLimitOrderEvent(const ModelEvents::RejectTriggerExpiredLimitOrderEvent& event) = 0;
 
+            // Runs after the inventory has dropped every order listed in the ack. Not pure so that algos which never
+            // send a mass cancel need not override it.
+            virtual void on_MassCancelLimitOrderAckEvent(const ModelEvents::MassCancelLimitOrderAckEvent& event) {}
+
+            // Runs after local_book() has taken the delta in; not called for deltas dropped on a sequence gap.
+            virtual void on_LTwoDeltaEvent(const ModelEvents::LTwoDeltaEvent& event) {}
+
+            // Runs once per update local_book() takes in from either feed, after the feed's own handler. With both feeds
+            // on, a book change arrives twice but the book takes in only one copy, so this is the place to react to it.
+            virtual void on_local_book_updated() {}
+
 
             template <typename E>
             void publish_wrapper(const std::string& topic, const std::string& stream_id_str, const std::shared_ptr<const E>& event_ptr) {
@@ -840,6 +1013,12 @@ namespace trading {
                 LogMessage(LogLevel::ERROR, this->get_logger_source(), std::string("Unknown exception in ") + handler_name);
             }
 
+            void notify_local_book_updated() {
+                try { on_local_book_updated(); }
+                catch (const std::exception& e) { handle_exception("on_local_book_updated", e); }
+                catch (...) { handle_unknown_exception("on_local_book_updated"); }
+            }
+
             void handle_inventory_exception(const char* inventory_method_name, ClientOrderIdType cid, const std::exception& e) {
                 LogMessage(LogLevel::ERROR, this->get_logger_source(), "Inventory exception in " + std::string(inventory_method_name) + " for CID " + std::to_string(cid) + ": " + e.what());
                 LogMessage(LogLevel::ERROR, this->get_logger_source(), "Inventory Snapshot:\n" + inventory_.snapshot());
@@ -850,6 +1029,7 @@ namespace trading {
             const SymbolType exchange_name_;
             ClientOrderIdType next_client_order_id_;
             InventoryCore inventory_;
+            LocalL2Book local_book_;
 
         };
 
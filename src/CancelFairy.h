@@ -56,6 +56,7 @@ public:
         this->subscribe("LimitOrderAckEvent"); // Subscribes to all LimitOrderAckEvents
         this->subscribe("FullFillLimitOrderEvent"); // Subscribes to all FullFillLimitOrderEvents
         this->subscribe("FullCancelLimitOrderAckEvent"); // Subscribes to all FullCancelLimitOrderAckEvents
+        this->subscribe("MassCancelLimitOrderAckEvent"); // Subscribes to all MassCancelLimitOrderAckEvents
         // Subscribes to events specifically targeted at this CancelFairy instance
         this->subscribe("CheckLimitOrderExpirationEvent." + std::to_string(this->get_id()));
         this->subscribe("RejectTriggerExpiredLimitOrderEvent." + std::to_string(this->get_id()));
@@ -88,7 +89,7 @@ public:
         Timestamp current_sim_time = this->bus_->get_current_time();
         Timestamp expiration_timestamp = current_sim_time + event.timeout;
 
-        auto check_event_ptr = std::make_shared<const ModelEvents::CheckLimitOrderExpirationEvent>(
+        auto check_event_ptr = ModelEvents::make_event<ModelEvents::CheckLimitOrderExpirationEvent>(
                 current_sim_time,
                 event.order_id,
                 event.timeout
@@ -114,6 +115,13 @@ public:
         process_terminal_event(event.order_id);
     }
 
+    void handle_event(const ModelEvents::MassCancelLimitOrderAckEvent& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
+        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Processing MassCancelLimitOrderAckEvent with " + std::to_string(event.cancelled_orders.size()) + " cancelled orders.");
+        for (const auto& cancelled : event.cancelled_orders) {
+            process_terminal_event(cancelled.order_id);
+        }
+    }
+
     void handle_event(const ModelEvents::CheckLimitOrderExpirationEvent& event, TopicId, AgentId, Timestamp current_sim_time, StreamId, SequenceNumber) {
         LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Processing CheckLimitOrderExpirationEvent for XID: " + std::to_string(event.target_exchange_order_id) +
                                              " at time " + ModelEvents::format_timestamp(current_sim_time));
@@ -130,7 +138,7 @@ public:
                                                 " is active, attempting to trigger expiration. Symbol: " + metadata.symbol +
                                                 ", Original Trader: " + std::to_string(metadata.original_trader_id));
 
-            auto trigger_event_ptr = std::make_shared<const ModelEvents::TriggerExpiredLimitOrderEvent>(
+            auto trigger_event_ptr = ModelEvents::make_event<ModelEvents::TriggerExpiredLimitOrderEvent>(
                     current_sim_time,
                     metadata.symbol,
                     event.target_exchange_order_id,
@@ -186,12 +194,15 @@ public:
 
     // Empty handlers for other events (as before)
     void handle_event(const ModelEvents::LTwoOrderBookEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+    void handle_event(const ModelEvents::LTwoDeltaEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+    void handle_event(const ModelEvents::L2PublishTimerEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::LimitOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::MarketOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::PartialCancelLimitOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::PartialCancelMarketOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::FullCancelLimitOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::FullCancelMarketOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+    void handle_event(const ModelEvents::MassCancelLimitOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::MarketOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::FullCancelMarketOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::PartialCancelLimitAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
@@ -130,4 +130,16 @@ public:
     void handle_event(const ModelEvents::AckTriggerExpiredLimitOrderEvent& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
         // LOG_DEBUG(this->get_logger_source(), "Ignoring AckTriggerExpiredLimitOrderEvent: " + event.to_string());
     }
+    void handle_event(const ModelEvents::MassCancelLimitOrderEvent& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
+        // LOG_DEBUG(this->get_logger_source(), "Ignoring MassCancelLimitOrderEvent: " + event.to_string());
+    }
+    void handle_event(const ModelEvents::MassCancelLimitOrderAckEvent& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
+        // LOG_DEBUG(this->get_logger_source(), "Ignoring MassCancelLimitOrderAckEvent: " + event.to_string());
+    }
+    void handle_event(const ModelEvents::LTwoDeltaEvent& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
+        // LOG_DEBUG(this->get_logger_source(), "Ignoring LTwoDeltaEvent: " + event.to_string());
+    }
+    void handle_event(const ModelEvents::L2PublishTimerEvent& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
+        // LOG_DEBUG(this->get_logger_source(), "Ignoring L2PublishTimerEvent: " + event.to_string());
+    }
 };
\ No newline at end of file
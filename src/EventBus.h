@@ -47,6 +47,12 @@ namespace EventBusSystem {
     using TopicId = InternedStringId;
     using StreamId = InternedStringId;
 
+    // Stream IDs with the top bit set are numeric handles picked by the publisher instead of interned strings, so a
+    // publisher with many short-lived streams (e.g. one per order) need not build and intern a name for each.
+    constexpr StreamId NUMERIC_STREAM_ID_FLAG = StreamId(1) << 63;
+    inline constexpr StreamId make_numeric_stream_id(std::uint64_t key) { return NUMERIC_STREAM_ID_FLAG | key; }
+    inline constexpr bool is_numeric_stream_id(StreamId id) { return (id & NUMERIC_STREAM_ID_FLAG) != 0; }
+
     // --- Wildcard Constants ---
     const std::string SINGLE_LEVEL_WILDCARD = "*";
     const std::string MULTI_LEVEL_WILDCARD = "#";
@@ -513,6 +519,17 @@ namespace EventBusSystem {
             bus_->schedule_at(this->id_, this->id_, full_topic_str_for_self, event_ptr, target_execution_time, stream_id_str);
         }
 
+        // Same, for a topic interned up front (get_topic_id) and an interned or numeric stream ID.
+        template<typename E>
+        void schedule_for_self_at(Timestamp target_execution_time, const std::shared_ptr<const E>& event_ptr,
+                                  TopicId topic_id, StreamId stream_id = INVALID_ID_UINT64) {
+            if (!bus_) {
+                LogMessage(LogLevel::ERROR, this->get_logger_source(), "Cannot schedule_for_self_at: EventBus is not set.");
+                return;
+            }
+            bus_->schedule_at(this->id_, this->id_, topic_id, event_ptr, target_execution_time, stream_id);
+        }
+
         template<typename E>
         void publish(const std::string &topic_str, const std::shared_ptr<const E> &event_ptr,
                      const std::string &stream_id_str = "") {
@@ -527,6 +544,16 @@ namespace EventBusSystem {
             bus_->publish(id_, topic_str, event_ptr, stream_id_str);
         }
 
+        // Same, for a topic interned up front (get_topic_id) and an interned or numeric stream ID.
+        template<typename E>
+        void publish(TopicId topic_id, const std::shared_ptr<const E> &event_ptr, StreamId stream_id = INVALID_ID_UINT64) {
+            if (!bus_) {
+                LogMessage(LogLevel::ERROR, this->get_logger_source(), "Cannot publish: EventBus is not set.");
+                return;
+            }
+            bus_->publish(id_, topic_id, event_ptr, stream_id);
+        }
+
         void subscribe(const std::string &topic_str) {
             if (!bus_) { LogMessage(LogLevel::ERROR, this->get_logger_source(), "Cannot subscribe: EventBus is not set."); return; }
             bus_->subscribe(id_, topic_str);
@@ -562,6 +589,7 @@ namespace EventBusSystem {
 
         StringInterner string_interner_;
         TrieNode topic_trie_root_;
+        std::unordered_map<TopicId, TrieNode *> topic_nodes_; // Every trie node but the root, by its topic ID
         std::unordered_map<AgentId, std::unordered_set<std::string> > agent_exact_subscriptions_;
         std::unordered_map<AgentId, std::unordered_set<std::string> > agent_wildcard_subscriptions_;
 
@@ -612,6 +640,7 @@ namespace EventBusSystem {
                     }
                     current = inserted_it->second.get();
                     current->topic_id = string_interner_.intern(current_path_str);
+                    topic_nodes_[current->topic_id] = current;
                 } else {
                     current = it->second.get();
                 }
@@ -659,10 +688,11 @@ namespace EventBusSystem {
                     LogMessage(LogLevel::ERROR, get_logger_source(), "Pruning error: Node (part_key: '" + current->part_key + "') has no parent.");
                     break;
                 }
-                const std::string &key_to_remove = current->part_key;
+                const std::string key_to_remove = current->part_key; // Copied: the erase below frees `current`
                 if (key_to_remove.empty() && current != &topic_trie_root_) {
                     LogMessage(LogLevel::WARNING, get_logger_source(), "Pruning node with empty part_key.");
                 }
+                topic_nodes_.erase(current->topic_id);
                 size_t removed_count = parent->children.erase(key_to_remove);
                 if (removed_count == 0) {
                     LogMessage(LogLevel::WARNING, get_logger_source(), "Pruning anomaly: Node (topic_id: " + std::to_string(current->topic_id) +
@@ -892,64 +922,84 @@ namespace EventBusSystem {
             }
             if (topic_str.empty()) { LogMessage(LogLevel::DEBUG, get_logger_source(), "Publishing to empty topic (root)."); }
 
-            TopicId interned_topic_id_for_hook = string_interner_.intern(topic_str);
-            Timestamp publish_time_for_hook = current_time_;
-            EventVariant event_variant_for_hook = event_ptr;
+            TopicId topic_id = string_interner_.intern(topic_str);
+            StreamId stream_id = stream_id_str.empty() ? INVALID_ID_UINT64 : string_interner_.intern(stream_id_str);
+            publish_interned(publisher_id, topic_id, event_ptr, stream_id);
+        }
+
+        // Publishes to a topic interned up front (intern_topic) without building or hashing any string. `stream_id`
+        // is an interned stream or a numeric handle (make_numeric_stream_id).
+        template<typename E>
+        void publish(
+                AgentId publisher_id,
+                TopicId topic_id,
+                const std::shared_ptr<const E> &event_ptr,
+                StreamId stream_id = INVALID_ID_UINT64
+        ) {
+            static_assert((std::is_same_v<E, EventTypes> || ...), "Event type E is not in the list of EventTypes for this EventBus.");
+            if (!event_ptr) {
+                LogMessage(LogLevel::WARNING, get_logger_source(), "Publish null event for topic ID " + std::to_string(topic_id) + ". Ignored.");
+                return;
+            }
+            publish_interned(publisher_id, topic_id, event_ptr, stream_id);
+        }
+
+    private:
+        template<typename E>
+        void publish_interned(AgentId publisher_id, TopicId topic_id, const std::shared_ptr<const E> &event_ptr, StreamId stream_id) {
+            Timestamp original_publish_time = current_time_;
+            EventVariant event_variant = event_ptr;
 
             if (!pre_publish_hooks_.empty()) {
                 for (PrePublishHookInterface* hook : pre_publish_hooks_) {
                     try {
                         hook->on_pre_publish(
                                 publisher_id,
-                                interned_topic_id_for_hook,
-                                event_variant_for_hook,
-                                publish_time_for_hook,
+                                topic_id,
+                                event_variant,
+                                original_publish_time,
                                 this
                         );
                     } catch (const std::exception& e) {
                         LogMessage(LogLevel::ERROR, get_logger_source(),
                                    "Exception in pre-publish hook '" + hook->get_hook_name() +
-                                   "' for topic '" + get_topic_string(interned_topic_id_for_hook) + "': " + e.what());
+                                   "' for topic '" + get_topic_string(topic_id) + "': " + e.what());
                     } catch (...) {
                         LogMessage(LogLevel::ERROR, get_logger_source(),
                                    "Unknown exception in pre-publish hook '" + hook->get_hook_name() +
-                                   "' for topic '" + get_topic_string(interned_topic_id_for_hook) + "'.");
+                                   "' for topic '" + get_topic_string(topic_id) + "'.");
                     }
                 }
             }
 
-            TopicId published_topic_id = interned_topic_id_for_hook;
-            StreamId stream_id = stream_id_str.empty() ? INVALID_ID_UINT64 : string_interner_.intern(stream_id_str);
-            Timestamp original_publish_time = publish_time_for_hook;
-            EventVariant event_variant = event_variant_for_hook;
-
             std::unordered_set<AgentId> subscribers_to_notify;
-            TrieNode *exact_node = find_node(topic_str);
-            if (exact_node) {
-                subscribers_to_notify.insert(exact_node->subscribers.begin(), exact_node->subscribers.end());
-            }
-            if (topic_str.empty() && exact_node == &topic_trie_root_) {
+            if (topic_id == INVALID_ID_UINT64) {
                 subscribers_to_notify.insert(topic_trie_root_.subscribers.begin(), topic_trie_root_.subscribers.end());
+            } else if (auto node_it = topic_nodes_.find(topic_id); node_it != topic_nodes_.end()) {
+                subscribers_to_notify.insert(node_it->second->subscribers.begin(), node_it->second->subscribers.end());
             }
 
-            for (const auto &[agent_id, wildcard_set] : agent_wildcard_subscriptions_) {
-                if (subscribers_to_notify.count(agent_id)) continue;
-                for (const std::string &pattern : wildcard_set) {
-                    if (topic_matches_wildcard(pattern, topic_str)) {
-                        subscribers_to_notify.insert(agent_id);
-                        break;
+            if (!agent_wildcard_subscriptions_.empty()) {
+                const std::string &topic_str = string_interner_.resolve(topic_id);
+                for (const auto &[agent_id, wildcard_set] : agent_wildcard_subscriptions_) {
+                    if (subscribers_to_notify.count(agent_id)) continue;
+                    for (const std::string &pattern : wildcard_set) {
+                        if (topic_matches_wildcard(pattern, topic_str)) {
+                            subscribers_to_notify.insert(agent_id);
+                            break;
+                        }
                     }
                 }
             }
 
-            if (subscribers_to_notify.empty()) {
-                LogMessage(LogLevel::DEBUG, get_logger_source(), "No subscribers for topic: '" + topic_str + "'. Event not queued.");
+            if (subscribers_to_notify.empty() && LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+                LogMessage(LogLevel::DEBUG, get_logger_source(), "No subscribers for topic: '" + get_topic_string(topic_id) + "'. Event not queued.");
             }
 
             for (AgentId sub_id : subscribers_to_notify) {
                 ProcessorInterface *receiver = entities_.count(sub_id) ? entities_.at(sub_id) : nullptr;
                 if (!receiver) {
-                    LogMessage(LogLevel::WARNING, get_logger_source(), "Sub ID " + std::to_string(sub_id) + " in sub lists but not entities. Dropping event for '" + topic_str + "'.");
+                    LogMessage(LogLevel::WARNING, get_logger_source(), "Sub ID " + std::to_string(sub_id) + " in sub lists but not entities. Dropping event for '" + get_topic_string(topic_id) + "'.");
                     continue;
                 }
 
@@ -982,14 +1032,14 @@ namespace EventBusSystem {
                 final_scheduled_time = std::max(final_scheduled_time, current_time_ + LatencyUnit(1));
 
                 SequenceNumber next_seq_num = ++global_schedule_sequence_counter_;
-                ScheduledEvent scheduled_event{final_scheduled_time, event_variant, published_topic_id, publisher_id, sub_id, original_publish_time, stream_id, next_seq_num};
+                ScheduledEvent scheduled_event{final_scheduled_time, event_variant, topic_id, publisher_id, sub_id, original_publish_time, stream_id, next_seq_num};
 
                 if (stream_id != INVALID_ID_UINT64) {
                     subscriber_stream_last_scheduled_ts_[{stream_id, sub_id}] = final_scheduled_time;
                 }
 
                 if (receiver->is_processing()) {
-                    LogMessage(LogLevel::DEBUG, get_logger_source(), "Queueing re-entrant event for busy Agent " + std::to_string(sub_id) + " (Topic: " + get_topic_string(published_topic_id) + ", Seq: " + std::to_string(next_seq_num) + ")");
+                    if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) LogMessage(LogLevel::DEBUG, get_logger_source(), "Queueing re-entrant event for busy Agent " + std::to_string(sub_id) + " (Topic: " + get_topic_string(topic_id) + ", Seq: " + std::to_string(next_seq_num) + ")");
                     receiver->queue_reentrant_event(std::move(scheduled_event));
                 } else {
                     event_queue_.push(std::move(scheduled_event));
@@ -997,6 +1047,7 @@ namespace EventBusSystem {
             }
         }
 
+    public:
         std::optional<ScheduledEvent> peak() const {
             if (event_queue_.empty()) return std::nullopt;
             return event_queue_.top();
@@ -1067,12 +1118,26 @@ namespace EventBusSystem {
                 Timestamp target_execution_time,
                 const std::string& stream_id_str = ""
         ) {
-            static_assert((std::is_same_v<E, EventTypes> || ...), "Scheduled event type E not in EventVariant list");
             if (!event_ptr) { LogMessage(LogLevel::WARNING, get_logger_source(), "schedule_at: null event_ptr for topic '" + topic_str + "'. Ignoring."); return; }
-            if (!entities_.count(subscriber_id)) { LogMessage(LogLevel::WARNING, get_logger_source(), "schedule_at: sub " + std::to_string(subscriber_id) + " not found. Ignoring."); return; }
-
             TopicId topic_id = string_interner_.intern(topic_str);
             StreamId stream_id = stream_id_str.empty() ? INVALID_ID_UINT64 : string_interner_.intern(stream_id_str);
+            schedule_at(publisher_id, subscriber_id, topic_id, event_ptr, target_execution_time, stream_id);
+        }
+
+        // Same, for a topic interned up front (intern_topic) and an interned or numeric stream ID.
+        template<typename E>
+        void schedule_at(
+                AgentId publisher_id,
+                AgentId subscriber_id,
+                TopicId topic_id,
+                const std::shared_ptr<const E>& event_ptr,
+                Timestamp target_execution_time,
+                StreamId stream_id = INVALID_ID_UINT64
+        ) {
+            static_assert((std::is_same_v<E, EventTypes> || ...), "Scheduled event type E not in EventVariant list");
+            if (!event_ptr) { LogMessage(LogLevel::WARNING, get_logger_source(), "schedule_at: null event_ptr for topic ID " + std::to_string(topic_id) + ". Ignoring."); return; }
+            if (!entities_.count(subscriber_id)) { LogMessage(LogLevel::WARNING, get_logger_source(), "schedule_at: sub " + std::to_string(subscriber_id) + " not found. Ignoring."); return; }
+
             Timestamp call_time = current_time_;
             Timestamp final_time = target_execution_time;
             const Duration min_future = LatencyUnit(1);
@@ -1087,12 +1152,20 @@ namespace EventBusSystem {
             ScheduledEvent sev{final_time, event_ptr, topic_id, publisher_id, subscriber_id, call_time, stream_id, seq_num};
             if (stream_id != INVALID_ID_UINT64) subscriber_stream_last_scheduled_ts_[{stream_id, subscriber_id}] = final_time;
             event_queue_.push(std::move(sev));
-            LogMessage(LogLevel::DEBUG, get_logger_source(), "Scheduled event via schedule_at for Agent " + std::to_string(subscriber_id) + " (Topic: '" + topic_str + "', FinalTime: " + format_timestamp(final_time) + ", Seq: " + std::to_string(seq_num) + ")");
+            if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+                LogMessage(LogLevel::DEBUG, get_logger_source(), "Scheduled event via schedule_at for Agent " + std::to_string(subscriber_id) + " (Topic: '" + get_topic_string(topic_id) + "', FinalTime: " + format_timestamp(final_time) + ", Seq: " + std::to_string(seq_num) + ")");
+            }
         }
 
         Timestamp get_current_time() const { return current_time_; }
         const std::string &get_topic_string(TopicId id) const { return string_interner_.resolve(id); }
-        const std::string &get_stream_string(StreamId id) const { return string_interner_.resolve(id); }
+        const std::string &get_stream_string(StreamId id) const {
+            if (is_numeric_stream_id(id)) {
+                static const std::string numeric_stream_str = "[Numeric stream]";
+                return numeric_stream_str;
+            }
+            return string_interner_.resolve(id);
+        }
         TopicId intern_topic(const std::string &topic_str) { return string_interner_.intern(topic_str); }
         StreamId intern_stream(const std::string &stream_str) { return string_interner_.intern(stream_str); }
         size_t get_event_queue_size() const { return event_queue_.size(); }
@@ -3,6 +3,8 @@
 
 #include "Model.h"
 #include "ExchangeServer.h"
+#include "ExchangeShardGroup.h"
+#include "OrderRecordTable.h"
 #include "Globals.h"
 #include <string>
 #include <vector>
@@ -10,7 +12,7 @@
 #include <optional>
 #include <memory>
 #include <algorithm>
-#include <sstream>
+#include <array>
 #include <iomanip> // For std::fixed and std::setprecision in logging average price
 
 
@@ -38,6 +40,21 @@ public:
     using ExchangeTimeType = ::TIME_TYPE;
     using ExchangeSide = ::SIDE;
 
+    // Which L2 market-data events go out after a book change (see set_l2_publish_mode).
+    enum class L2PublishMode {
+        SNAPSHOT, // LTwoOrderBookEvent with both full sides
+        DELTA,    // LTwoDeltaEvent with the changed levels only
+        BOTH
+    };
+
+    // Which L2 updates go out and how deep (see set_l2_publish_policy). The default publishes the whole book after
+    // every change.
+    struct L2PublishPolicy {
+        std::size_t max_depth = 0;         // Levels per side; 0 publishes every level
+        Duration min_interval{0};          // Conflation window: changes inside it go out as one update at its end
+        bool top_of_book_only = false;     // Publish only when the best bid or ask (price or size) changes
+    };
+
     // Enum for internal order type tracking
     enum class MappedOrderType {
         UNKNOWN,
@@ -52,12 +69,14 @@ public:
                                               // Using double for value to maintain precision for average price calculation
     };
 
-    EventModelExchangeAdapter(SymbolType symbol)
+    // `id_space` selects the order ID space of this symbol's book (see uoid_space_base); give each symbol its own
+    // to keep exchange order IDs unique across adapters.
+    EventModelExchangeAdapter(SymbolType symbol, ID_TYPE id_space = 0)
             : Base(),
-              exchange_(), // ExchangeServer will be default constructed
+              exchange_(id_space, ExchangeListener(*this)),
               symbol_(std::move(symbol)),
-              auto_publish_orderbook_(true) {
-        _setup_callbacks();
+              auto_publish_orderbook_(true),
+              order_records_(exchange_.uoid_base(), exchange_.transient_order_id_start(), uoid_space_base(1)) {
         LogMessage(LogLevel::INFO, this->get_logger_source(), "EventModelExchangeAdapter constructed for symbol: " + symbol_ + ". Agent ID will be set upon registration.");
     }
 
@@ -73,32 +92,291 @@ public:
         this->subscribe(std::string("MarketOrderEvent.") + symbol_);
         this->subscribe(std::string("FullCancelLimitOrderEvent.") + symbol_);
         this->subscribe(std::string("FullCancelMarketOrderEvent.") + symbol_);
+        this->subscribe(std::string("MassCancelLimitOrderEvent.") + symbol_);
         this->subscribe(std::string("PartialCancelLimitOrderEvent.") + symbol_);
         this->subscribe(std::string("PartialCancelMarketOrderEvent.") + symbol_);
         this->subscribe("Bang");
         this->subscribe(std::string("TriggerExpiredLimitOrderEvent.") + symbol_);
+
+        for (std::size_t i = 0; i < TRADER_TOPIC_COUNT; ++i) {
+            generic_topic_ids_[i] = this->get_topic_id(TRADER_TOPIC_NAMES[i]);
+        }
+        bang_topic_id_ = this->get_topic_id("Bang");
+        trade_topic_id_ = this->get_topic_id(std::string("TradeEvent.") + symbol_);
+        l2_topic_id_ = this->get_topic_id(std::string("LTwoOrderBookEvent.") + symbol_);
+        l2_delta_topic_id_ = this->get_topic_id(std::string("LTwoDeltaEvent.") + symbol_);
+        expiry_wakeup_topic_id_ = this->get_topic_id("CheckLimitOrderExpirationEvent." + std::to_string(this->get_id()));
+        l2_timer_topic_id_ = this->get_topic_id("L2PublishTimerEvent." + std::to_string(this->get_id()));
+        l2_stream_id_ = this->get_stream_id("l2_stream_" + symbol_);
+    }
+
+    // Interns the per-trader topics of `trader_id` ahead of its first order (TradingSimulation::add_trader calls
+    // this for every adapter). Traders not prepared are interned on their first order entry instead.
+    void prepare_trader(AgentId trader_id) {
+        _trader_topics(trader_id);
+    }
+
+    // Batching of same-timestamp order entries (on by default). Turning it off restores one L2 update per entry.
+    void set_batch_order_entry(bool enabled) {
+        batch_order_entry_ = enabled;
+        if (!enabled && !pending_orders_.empty()) {
+            _execute_pending_orders();
+            _publish_orderbook_snapshot_if_changed();
+        }
     }
 
+    // Aggregated execution reports (off by default): a sweep publishes each TradeEvent to maker and taker and one
+    // maker fill event per fill, plus a single taker fill event instead of a taker partial fill per fill.
+    void set_aggregate_execution_reports(bool enabled) {
+        exchange_.set_aggregate_execution_reports(enabled);
+    }
+
+    // Exchange-side order expiry (off by default). Resting limit orders expire on ExchangeServer's timing wheel,
+    // driven by the bus clock through one self-scheduled wake-up at the next due time, so no
+    // TriggerExpiredLimitOrderEvent round trip through a CancelFairyApp is needed. An order expires exactly its
+    // timeout after it rests, without the fairy's two latency hops.
+    void set_native_expiry(bool enabled) {
+        _execute_pending_orders();
+        exchange_.set_expiry_enabled(enabled);
+        expiry_wakeup_time_ = std::nullopt;
+        _sync_exchange_clock();
+    }
+
+    // L2 market data (SNAPSHOT by default). DELTA publishes LTwoDeltaEvent on "LTwoDeltaEvent.<symbol>" instead of
+    // LTwoOrderBookEvent: the changed levels only, plus a full snapshot on the first update, after a Bang, and after
+    // every `snapshot_interval` deltas so that a subscriber that missed one can resync (0: never periodically).
+    // BOTH publishes the two feeds side by side.
+    void set_l2_publish_mode(L2PublishMode mode, std::uint32_t snapshot_interval = 100) {
+        l2_publish_mode_ = mode;
+        l2_snapshot_interval_ = snapshot_interval;
+        l2_deltas_since_snapshot_ = 0;
+        delta_bids_l2_.clear();
+        delta_asks_l2_.clear();
+        // Restart from a full snapshot so the new feed is complete from its first event.
+        last_published_bids_l2_ = std::nullopt;
+        last_published_asks_l2_ = std::nullopt;
+    }
+
+    L2PublishMode l2_publish_mode() const { return l2_publish_mode_; }
+
+    // Probe counts of the per-order record table (see OrderRecordTable).
+    const OrderRecordTableStats& order_record_stats() const { return order_records_.stats(); }
+
+    // Records the adapter holds, one per order it still tracks; between order entries that is the resting orders.
+    std::size_t order_record_count() const { return order_records_.size(); }
+    std::size_t resting_order_count() { return exchange_.get_order_count(); }
+
+    // Applies to both L2 feeds. A depth-limited delta feed describes the top `max_depth` levels only: a level that
+    // drops out of them is reported with quantity 0. Conflation wake-ups are scheduled through the bus; a Bang, or
+    // a change of policy, still publishes a full update right away.
+    void set_l2_publish_policy(const L2PublishPolicy& policy) {
+        l2_publish_policy_ = policy;
+        last_l2_publish_time_ = std::nullopt;
+        l2_changes_pending_ = false;
+        delta_bids_l2_.clear();
+        delta_asks_l2_.clear();
+        last_published_bids_l2_ = std::nullopt;
+        last_published_asks_l2_ = std::nullopt;
+    }
+
+    const L2PublishPolicy& l2_publish_policy() const { return l2_publish_policy_; }
+
+    using ShardGroup = ExchangeShardGroup<EventModelExchangeAdapter>;
+
+    // Group this adapter runs its batches with, if it is one of several per-symbol shards (see ExchangeShardGroup).
+    ShardGroup* shard_group() const { return shard_group_; }
+
     EventModelExchangeAdapter(const EventModelExchangeAdapter&) = delete;
     EventModelExchangeAdapter& operator=(const EventModelExchangeAdapter&) = delete;
     EventModelExchangeAdapter(EventModelExchangeAdapter&&) = delete;
     EventModelExchangeAdapter& operator=(EventModelExchangeAdapter&&) = delete;
 
 private:
-    ExchangeServer exchange_;
+    friend ShardGroup;
+
+    // Forwards the exchange's hooks to the adapter's _on_* handlers; bound at compile time, so each call inlines.
+    // on_order_quantity_modified(_rejected) and the amend hooks keep NullExchangeListener's no-ops.
+    struct ExchangeListener : NullExchangeListener {
+        explicit ExchangeListener(EventModelExchangeAdapter& adapter) : adapter_(adapter) {}
+        EventModelExchangeAdapter& adapter_;
+
+        void on_limit_order_acknowledged(ExchangeIDType xid, ExchangeSide s, ExchangePriceType p, ExchangeQuantityType q, ExchangeQuantityType rq, AgentId tid, ClientOrderIdType cid, ExchangeTimeType tus) {
+            adapter_._on_limit_order_acknowledged(xid, s, p, q, rq, tid, cid, tus);
+        }
+        void on_market_order_acknowledged(ExchangeSide s, ExchangeQuantityType rq, ExchangeQuantityType eq, ExchangeQuantityType uq, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_market_order_acknowledged(s, rq, eq, uq, tid, cid);
+        }
+        void on_partial_cancel_limit(ExchangeIDType xid, ExchangePriceType p, ExchangeQuantityType cq, AgentId tid_req, ClientOrderIdType cid_req) {
+            adapter_._on_partial_cancel_limit(xid, p, cq, tid_req, cid_req);
+        }
+        void on_partial_cancel_limit_reject(ExchangeIDType xid, AgentId tid_req, ClientOrderIdType cid_req) {
+            adapter_._on_partial_cancel_limit_reject(xid, tid_req, cid_req);
+        }
+        void on_full_cancel_limit(ExchangeIDType xid, ExchangePriceType p, ExchangeQuantityType q, ExchangeSide s, AgentId tid_req, ClientOrderIdType cid_req) {
+            adapter_._on_full_cancel_limit(xid, p, q, s, tid_req, cid_req);
+        }
+        void on_full_cancel_limit_reject(ExchangeIDType xid, AgentId tid_req, ClientOrderIdType cid_req) {
+            adapter_._on_full_cancel_limit_reject(xid, tid_req, cid_req);
+        }
+        void on_mass_cancel_limit(const std::vector<CancelledOrder>& cancelled, AgentId tid_req, ClientOrderIdType cid_req) {
+            adapter_._on_mass_cancel_limit(cancelled, tid_req, cid_req);
+        }
+        void on_trade(ExchangeIDType mxid, ExchangeSide m_side, ExchangeIDType txid, ExchangeSide t_side, ExchangePriceType p, ExchangeQuantityType q, bool mex, AgentId mtid, ClientOrderIdType mcid, AgentId ttid, ClientOrderIdType tcid) {
+            adapter_._on_trade(mxid, m_side, txid, t_side, p, q, mex, mtid, mcid, ttid, tcid);
+        }
+
+        // Maker fills
+        void on_maker_partial_fill_limit(ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_maker_partial_fill_limit(mxid, p, q_seg, maker_s, tid, cid);
+        }
+        void on_maker_full_fill_limit(ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType total_q, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_maker_full_fill_limit(mxid, p, total_q, maker_s, tid, cid);
+        }
+        void on_maker_partial_fill_market(ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_maker_partial_fill_market(mxid, p, q_seg, maker_s, tid, cid);
+        }
+        void on_maker_full_fill_market(ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType total_q, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_maker_full_fill_market(mxid, p, total_q, maker_s, tid, cid);
+        }
+
+        // Taker fills
+        void on_taker_partial_fill_limit(ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeQuantityType lq, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_taker_partial_fill_limit(txid, taker_s, p, q_seg, lq, tid, cid);
+        }
+        void on_taker_full_fill_limit(ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType total_q, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_taker_full_fill_limit(txid, taker_s, p, total_q, tid, cid);
+        }
+        void on_taker_partial_fill_market(ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeQuantityType lq, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_taker_partial_fill_market(txid, taker_s, p, q_seg, lq, tid, cid);
+        }
+        void on_taker_full_fill_market(ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType total_q, AgentId tid, ClientOrderIdType cid) {
+            adapter_._on_taker_full_fill_market(txid, taker_s, p, total_q, tid, cid);
+        }
+
+        void on_execution_report(const ExecutionReport& report) {
+            adapter_._on_execution_report(report);
+        }
+
+        void on_order_book_snapshot(const std::vector<L2_DATA_TYPE>& b, const std::vector<L2_DATA_TYPE>& a) {
+            adapter_._on_order_book_snapshot(b, a);
+        }
+        void on_acknowledge_trigger_expiration(ExchangeIDType xid, ExchangePriceType p, ExchangeQuantityType q, AgentId tid, ClientOrderIdType cid, ExchangeTimeType tus) {
+            adapter_._on_acknowledge_trigger_expiration(xid, p, q, tid, cid, tus);
+        }
+        void on_reject_trigger_expiration(ExchangeIDType xid, AgentId tid, ClientOrderIdType cid, ExchangeTimeType tus) {
+            adapter_._on_reject_trigger_expiration(xid, tid, cid, tus);
+        }
+    };
+    using Exchange = ExchangeServer<ExchangeListener>;
+
+    Exchange exchange_;
     SymbolType symbol_;
     bool auto_publish_orderbook_;
 
-    std::unordered_map<std::pair<AgentId, ClientOrderIdType>, ExchangeOrderIdType, EventBusSystem::PairHasher> trader_client_to_exchange_map_;
-    std::unordered_map<ExchangeOrderIdType, std::pair<AgentId, ClientOrderIdType>> exchange_to_trader_client_map_;
-    std::unordered_map<ExchangeOrderIdType, MappedOrderType> order_type_map_;
-    std::unordered_map<ExchangeOrderIdType, AgentId> expiration_trigger_sender_map_;
-    std::unordered_map<ExchangeOrderIdType, PartialFillState> partial_fill_tracker_;
+    // What the adapter tracks per exchange order ID. A record lives while any of its parts is in use: the mapping to
+    // the order's (trader, client order ID), which is the table's owner link, a pending expiration trigger, or fill
+    // state.
+    struct OrderRecord {
+        MappedOrderType order_type = MappedOrderType::UNKNOWN; // UNKNOWN unless mapped
+        AgentId expiration_trigger_sender = EventBusSystem::INVALID_AGENT_ID;
+        bool has_fill_state = false;
+        PartialFillState fill_state;
+    };
+    OrderRecordTable<OrderRecord> order_records_;
 
 
     std::optional<ModelEvents::OrderBookLevel> last_published_bids_l2_;
     std::optional<ModelEvents::OrderBookLevel> last_published_asks_l2_;
 
+    // Delta feed state: levels changed since the last LTwoDeltaEvent (best-first, absolute quantities) and its
+    // per-symbol sequence numbering.
+    L2PublishMode l2_publish_mode_ = L2PublishMode::SNAPSHOT;
+    std::uint32_t l2_snapshot_interval_ = 100;
+    std::uint32_t l2_deltas_since_snapshot_ = 0;
+    std::uint64_t l2_sequence_ = 0;
+    ModelEvents::OrderBookLevel delta_bids_l2_;
+    ModelEvents::OrderBookLevel delta_asks_l2_;
+
+    // Publishing policy state. last_published_*_l2_ always mirror the full book; published_*_l2_ hold the levels
+    // the last update actually showed (only kept with a depth limit), published_best_* its top of book.
+    L2PublishPolicy l2_publish_policy_;
+    bool l2_changes_pending_ = false;                 // Book changed since the last update went out
+    std::optional<Timestamp> last_l2_publish_time_;
+    std::optional<Timestamp> l2_wakeup_time_;         // Conflation wake-up scheduled on the bus
+    ModelEvents::OrderBookLevel published_bids_l2_;
+    ModelEvents::OrderBookLevel published_asks_l2_;
+    std::optional<ModelEvents::PriceQuantityPair> published_best_bid_;
+    std::optional<ModelEvents::PriceQuantityPair> published_best_ask_;
+
+    // Order entries delivered back-to-back at the same simulated time are collected here and run through
+    // ExchangeServer::process_batch in one go, followed by a single L2 update.
+    bool batch_order_entry_ = true;
+    std::vector<Exchange::OrderInstruction> pending_orders_;
+
+    // Exchange time of the earliest CheckLimitOrderExpirationEvent this adapter has scheduled for itself.
+    std::optional<ExchangeTimeType> expiry_wakeup_time_;
+
+    // Set by ShardGroup::add_shard. While a batch runs on a shard worker, publications are held here instead of
+    // reaching the bus, and go out in order from _release_shard_batch.
+    ShardGroup* shard_group_ = nullptr;
+    struct HeldPublication {
+        TopicId topic_;
+        StreamId stream_id_;
+        EventVariant event_;
+    };
+    bool hold_publications_ = false;
+    std::vector<HeldPublication> held_publications_;
+
+    // Events published both on "<event>" and on "<event>.<trader>"; see _trader_topics.
+    enum class TraderTopic : std::size_t {
+        LimitOrderAckEvent,
+        MarketOrderAckEvent,
+        PartialCancelLimitAckEvent,
+        FullCancelLimitOrderAckEvent,
+        MassCancelLimitOrderAckEvent,
+        PartialCancelLimitOrderRejectEvent,
+        FullCancelLimitOrderRejectEvent,
+        PartialCancelMarketOrderRejectEvent,
+        FullCancelMarketOrderRejectEvent,
+        PartialFillLimitOrderEvent,
+        FullFillLimitOrderEvent,
+        PartialFillMarketOrderEvent,
+        FullFillMarketOrderEvent,
+        AckTriggerExpiredLimitOrderEvent,
+        RejectTriggerExpiredLimitOrderEvent,
+        COUNT
+    };
+    static constexpr std::size_t TRADER_TOPIC_COUNT = static_cast<std::size_t>(TraderTopic::COUNT);
+    inline static const std::array<std::string, TRADER_TOPIC_COUNT> TRADER_TOPIC_NAMES = {
+        "LimitOrderAckEvent",
+        "MarketOrderAckEvent",
+        "PartialCancelLimitAckEvent",
+        "FullCancelLimitOrderAckEvent",
+        "MassCancelLimitOrderAckEvent",
+        "PartialCancelLimitOrderRejectEvent",
+        "FullCancelLimitOrderRejectEvent",
+        "PartialCancelMarketOrderRejectEvent",
+        "FullCancelMarketOrderRejectEvent",
+        "PartialFillLimitOrderEvent",
+        "FullFillLimitOrderEvent",
+        "PartialFillMarketOrderEvent",
+        "FullFillMarketOrderEvent",
+        "AckTriggerExpiredLimitOrderEvent",
+        "RejectTriggerExpiredLimitOrderEvent"
+    };
+    using TraderTopicIds = std::array<TopicId, TRADER_TOPIC_COUNT>;
+
+    // Topic and stream IDs interned by setup_subscriptions and prepare_trader.
+    std::unordered_map<AgentId, TraderTopicIds> trader_topic_ids_;
+    TraderTopicIds generic_topic_ids_{};
+    TopicId bang_topic_id_ = EventBusSystem::INVALID_ID_UINT64;
+    TopicId trade_topic_id_ = EventBusSystem::INVALID_ID_UINT64;
+    TopicId l2_topic_id_ = EventBusSystem::INVALID_ID_UINT64;
+    TopicId l2_delta_topic_id_ = EventBusSystem::INVALID_ID_UINT64;
+    TopicId expiry_wakeup_topic_id_ = EventBusSystem::INVALID_ID_UINT64; // Self-scheduled wake-ups
+    TopicId l2_timer_topic_id_ = EventBusSystem::INVALID_ID_UINT64;
+    StreamId l2_stream_id_ = EventBusSystem::INVALID_ID_UINT64;
+
     std::string _mapped_order_type_to_string(MappedOrderType type) const {
         switch (type) {
             case MappedOrderType::LIMIT: return "limit";
@@ -109,136 +387,415 @@ private:
     }
 
     template <typename E>
-    void publish_wrapper(const std::string& topic_str, const std::string& stream_id_str, const std::shared_ptr<const E>& event_ptr) {
+    void publish_wrapper(TopicId topic_id, StreamId stream_id, const std::shared_ptr<const E>& event_ptr) {
         if (!this->bus_) {
-            LogMessage(LogLevel::ERROR, this->get_logger_source(), "EventBus not set, cannot publish event for topic: " + topic_str);
+            LogMessage(LogLevel::ERROR, this->get_logger_source(), "EventBus not set, cannot publish event for topic ID: " + std::to_string(topic_id));
             return;
         }
         if (!event_ptr) {
-            LogMessage(LogLevel::WARNING, this->get_logger_source(), "Attempted to publish a null event_ptr. Topic: " + topic_str);
+            LogMessage(LogLevel::WARNING, this->get_logger_source(), "Attempted to publish a null event_ptr. Topic ID: " + std::to_string(topic_id));
             return;
         }
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Publishing to topic '" + topic_str + "' on stream '" + stream_id_str + "': " + event_ptr->to_string());
-        this->publish(topic_str, event_ptr, stream_id_str);
-    }
-
-    template <typename E>
-    void publish_wrapper(const std::string& topic_str, const std::shared_ptr<const E>& event_ptr) {
-        if (!this->bus_) {
-            LogMessage(LogLevel::ERROR, this->get_logger_source(), "EventBus not set, cannot publish event for topic: " + topic_str);
+        if (hold_publications_) {
+            held_publications_.push_back(HeldPublication{topic_id, stream_id, EventVariant(event_ptr)});
             return;
         }
-        if (!event_ptr) {
-            LogMessage(LogLevel::WARNING, this->get_logger_source(), "Attempted to publish a null event_ptr. Topic: " + topic_str);
-            return;
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Publishing to topic '" + this->bus_->get_topic_string(topic_id) + "' on stream '" + this->bus_->get_stream_string(stream_id) + "': " + event_ptr->to_string());
         }
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Publishing to topic '" + topic_str + "': " + event_ptr->to_string());
-        this->publish(topic_str, event_ptr);
+        this->publish(topic_id, event_ptr, stream_id);
+    }
+
+    template <typename E>
+    void publish_wrapper(TopicId topic_id, const std::shared_ptr<const E>& event_ptr) {
+        publish_wrapper(topic_id, EventBusSystem::INVALID_ID_UINT64, event_ptr);
     }
 
     void _register_order_mapping(AgentId trader_id, ClientOrderIdType client_order_id,
                                  ExchangeOrderIdType exchange_order_id, MappedOrderType order_type) {
-        std::pair<AgentId, ClientOrderIdType> trader_client_key = {trader_id, client_order_id};
-        trader_client_to_exchange_map_[trader_client_key] = exchange_order_id;
-        exchange_to_trader_client_map_[exchange_order_id] = trader_client_key;
-        order_type_map_[exchange_order_id] = order_type;
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Registered mapping: Trader " + std::to_string(trader_id) +
-                                             ", CID " + std::to_string(client_order_id) + " -> XID " + std::to_string(exchange_order_id) +
-                                             " (Type: " + _mapped_order_type_to_string(order_type) + ")");
+        order_records_.emplace(exchange_order_id).order_type = order_type;
+        order_records_.link_owner(exchange_order_id, trader_id, client_order_id);
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Registered mapping: Trader " + std::to_string(trader_id) +
+                                                 ", CID " + std::to_string(client_order_id) + " -> XID " + std::to_string(exchange_order_id) +
+                                                 " (Type: " + _mapped_order_type_to_string(order_type) + ")");
+        }
     }
 
     void _remove_order_mapping(ExchangeOrderIdType exchange_order_id) {
-        auto it_xid_map = exchange_to_trader_client_map_.find(exchange_order_id);
-        if (it_xid_map != exchange_to_trader_client_map_.end()) {
-            std::pair<AgentId, ClientOrderIdType> trader_client_key = it_xid_map->second;
-
-            trader_client_to_exchange_map_.erase(trader_client_key);
-            exchange_to_trader_client_map_.erase(it_xid_map);
-            order_type_map_.erase(exchange_order_id);
-            partial_fill_tracker_.erase(exchange_order_id); // Also remove from partial fill tracker
-            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Removed mapping and partial fill state for XID " + std::to_string(exchange_order_id));
+        OrderRecord* record = order_records_.find(exchange_order_id);
+        if (record && order_records_.unlink_owner(exchange_order_id)) {
+            record->order_type = MappedOrderType::UNKNOWN;
+            if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+                LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Removed mapping and partial fill state for XID " + std::to_string(exchange_order_id));
+            }
         } else {
-            LogMessage(LogLevel::WARNING, this->get_logger_source(), "Attempted to remove mapping for non-existent XID " + std::to_string(exchange_order_id) + ". Partial fill state also not removed if it existed under this XID.");
+            LogMessage(LogLevel::WARNING, this->get_logger_source(), "Attempted to remove mapping for non-existent XID " + std::to_string(exchange_order_id) + ".");
+        }
+        // The order is done with, so its fill state goes too, mapped or not (e.g. a transient taker ID)
+        if (record) {
+            _clear_fill_state(exchange_order_id, *record);
         }
     }
 
-    std::optional<ExchangeOrderIdType> _get_exchange_order_id(AgentId trader_id, ClientOrderIdType client_order_id) const {
-        auto it = trader_client_to_exchange_map_.find({trader_id, client_order_id});
-        if (it != trader_client_to_exchange_map_.end()) {
-            return it->second;
+    // Drops the fill state of an order that gets no further fills.
+    void _clear_fill_state(ExchangeOrderIdType exchange_order_id) {
+        if (OrderRecord* record = order_records_.find(exchange_order_id)) {
+            _clear_fill_state(exchange_order_id, *record);
         }
-        return std::nullopt;
     }
 
-    std::optional<std::pair<AgentId, ClientOrderIdType>> _get_trader_and_client_ids(ExchangeOrderIdType exchange_order_id) const {
-        auto it = exchange_to_trader_client_map_.find(exchange_order_id);
-        if (it != exchange_to_trader_client_map_.end()) {
-            return it->second;
+    void _clear_fill_state(ExchangeOrderIdType exchange_order_id, OrderRecord& record) {
+        record.has_fill_state = false;
+        record.fill_state = PartialFillState{};
+        _release_order_record_if_unused(exchange_order_id, record);
+    }
+
+    void _release_order_record_if_unused(ExchangeOrderIdType exchange_order_id, const OrderRecord& record) {
+        if (record.order_type == MappedOrderType::UNKNOWN && !record.has_fill_state &&
+            record.expiration_trigger_sender == EventBusSystem::INVALID_AGENT_ID) {
+            order_records_.erase(exchange_order_id);
         }
-        return std::nullopt;
     }
 
-    std::string _format_topic_for_trader(const std::string& base_event_name, AgentId trader_id) {
-        return base_event_name + "." + std::to_string(trader_id);
+    MappedOrderType _mapped_order_type(ExchangeOrderIdType exchange_order_id) {
+        const OrderRecord* record = order_records_.find(exchange_order_id);
+        return record ? record->order_type : MappedOrderType::UNKNOWN;
     }
 
-    std::string _format_stream_id(AgentId trader_id, ClientOrderIdType client_order_id) {
-        std::ostringstream oss;
-        oss << "order_" << trader_id << "_" << client_order_id;
-        return oss.str();
+    // Fill state of an order, started on its first fill.
+    PartialFillState& _fill_state(ExchangeOrderIdType exchange_order_id) {
+        OrderRecord& record = order_records_.emplace(exchange_order_id);
+        record.has_fill_state = true;
+        return record.fill_state;
+    }
+
+    PartialFillState* _find_fill_state(ExchangeOrderIdType exchange_order_id) {
+        OrderRecord* record = order_records_.find(exchange_order_id);
+        return record && record->has_fill_state ? &record->fill_state : nullptr;
+    }
+
+    // Takes the sender of the pending TriggerExpiredLimitOrderEvent for an order, if any.
+    AgentId _take_expiration_trigger_sender(ExchangeOrderIdType exchange_order_id) {
+        OrderRecord* record = order_records_.find(exchange_order_id);
+        if (!record) {
+            return EventBusSystem::INVALID_AGENT_ID;
+        }
+        AgentId sender = std::exchange(record->expiration_trigger_sender, EventBusSystem::INVALID_AGENT_ID);
+        _release_order_record_if_unused(exchange_order_id, *record);
+        return sender;
+    }
+
+    std::optional<ExchangeOrderIdType> _get_exchange_order_id(AgentId trader_id, ClientOrderIdType client_order_id) {
+        return order_records_.find_by_owner(trader_id, client_order_id);
+    }
+
+    std::optional<std::pair<AgentId, ClientOrderIdType>> _get_trader_and_client_ids(ExchangeOrderIdType exchange_order_id) {
+        return order_records_.owner(exchange_order_id);
+    }
+
+    // Per-trader topics ("<event>.<trader>") are interned once per trader, so the order path neither builds nor
+    // hashes a topic string.
+    const TraderTopicIds& _trader_topics(AgentId trader_id) {
+        auto it = trader_topic_ids_.find(trader_id);
+        if (it == trader_topic_ids_.end()) {
+            TraderTopicIds ids{};
+            std::string suffix = "." + std::to_string(trader_id);
+            for (std::size_t i = 0; i < TRADER_TOPIC_COUNT; ++i) {
+                ids[i] = this->get_topic_id(TRADER_TOPIC_NAMES[i] + suffix);
+            }
+            it = trader_topic_ids_.emplace(trader_id, ids).first;
+        }
+        return it->second;
+    }
+
+    TopicId _trader_topic(TraderTopic topic, AgentId trader_id) {
+        return _trader_topics(trader_id)[static_cast<std::size_t>(topic)];
+    }
+
+    TopicId _generic_topic(TraderTopic topic) const {
+        return generic_topic_ids_[static_cast<std::size_t>(topic)];
+    }
+
+    // Every order's events go out on a stream of their own; its ID is a numeric handle packing the trader (upper
+    // 23 bits) and the client order ID (lower 40 bits).
+    static StreamId _order_stream_id(AgentId trader_id, ClientOrderIdType client_order_id) {
+        constexpr std::uint64_t CLIENT_ORDER_ID_BITS = 40;
+        constexpr std::uint64_t client_order_id_mask = (std::uint64_t(1) << CLIENT_ORDER_ID_BITS) - 1;
+        return EventBusSystem::make_numeric_stream_id((static_cast<std::uint64_t>(trader_id) << CLIENT_ORDER_ID_BITS) |
+                                                      (static_cast<std::uint64_t>(client_order_id) & client_order_id_mask));
     }
 
     void _publish_orderbook_snapshot_if_changed() {
         if (!auto_publish_orderbook_ || !this->bus_) {
+            // Not publishing: drop the journal so it stays bounded, and start from a full snapshot next time.
+            exchange_.clear_book_changes();
+            last_published_bids_l2_ = std::nullopt;
+            last_published_asks_l2_ = std::nullopt;
+            return;
+        }
+        if (!last_published_bids_l2_ || !last_published_asks_l2_) {
+            exchange_.clear_book_changes();
+            // This call will trigger the _on_order_book_snapshot callback, which publishes only if the book has changed.
+            exchange_.get_order_book_snapshot();
+            return;
+        }
+        // The last published levels equal the book as of the previous call, so the level-change journal is
+        // applied to them instead of walking and diffing the whole book.
+        if (exchange_.has_book_changes()) {
+            _apply_book_changes();
+        }
+        if (l2_changes_pending_) {
+            _publish_l2_if_due();
+        }
+    }
+
+    // Number of levels of `levels` an update shows under the depth limit.
+    std::size_t _l2_view_size(const ModelEvents::OrderBookLevel& levels) const {
+        std::size_t depth = l2_publish_policy_.max_depth;
+        return depth == 0 ? levels.size() : std::min(depth, levels.size());
+    }
+
+    ModelEvents::OrderBookLevel _l2_view(const ModelEvents::OrderBookLevel& levels) const {
+        return ModelEvents::OrderBookLevel(levels.begin(), levels.begin() + _l2_view_size(levels));
+    }
+
+    static std::optional<ModelEvents::PriceQuantityPair> _best_level(const ModelEvents::OrderBookLevel& levels) {
+        if (levels.empty()) return std::nullopt;
+        return levels.front();
+    }
+
+    // Whether the book differs from the last update in a way the policy publishes.
+    bool _l2_view_changed() const {
+        if (l2_publish_policy_.top_of_book_only) {
+            return _best_level(*last_published_bids_l2_) != published_best_bid_ ||
+                   _best_level(*last_published_asks_l2_) != published_best_ask_;
+        }
+        if (l2_publish_policy_.max_depth != 0) {
+            auto view_differs = [this](const ModelEvents::OrderBookLevel& book, const ModelEvents::OrderBookLevel& shown) {
+                std::size_t n = _l2_view_size(book);
+                return n != shown.size() || !std::equal(shown.begin(), shown.end(), book.begin());
+            };
+            return view_differs(*last_published_bids_l2_, published_bids_l2_) ||
+                   view_differs(*last_published_asks_l2_, published_asks_l2_);
+        }
+        return true; // The journal only reports real level changes
+    }
+
+    // Writes to `out` the levels that differ between two sides sorted best-first, with the new quantity (0 if gone).
+    static void _diff_levels(const ModelEvents::OrderBookLevel& before, const ModelEvents::OrderBookLevel& after,
+                             bool descending, ModelEvents::OrderBookLevel& out) {
+        auto better = [descending](PriceType a, PriceType b) { return descending ? a > b : a < b; };
+        auto b = before.begin();
+        auto a = after.begin();
+        while (b != before.end() || a != after.end()) {
+            if (a == after.end() || (b != before.end() && better(b->first, a->first))) {
+                out.emplace_back(b->first, 0);
+                ++b;
+            } else if (b == before.end() || better(a->first, b->first)) {
+                out.push_back(*a);
+                ++a;
+            } else {
+                if (a->second != b->second) out.push_back(*a);
+                ++a;
+                ++b;
+            }
+        }
+    }
+
+    // Schedules the wake-up that ends the current conflation window, unless one is already due by then.
+    void _schedule_l2_wakeup() {
+        if (hold_publications_ || !last_l2_publish_time_) {
+            return;
+        }
+        Timestamp due = *last_l2_publish_time_ + l2_publish_policy_.min_interval;
+        if (l2_wakeup_time_ && *l2_wakeup_time_ <= due) {
+            return;
+        }
+        l2_wakeup_time_ = due;
+        auto wakeup_event = ModelEvents::make_event<ModelEvents::L2PublishTimerEvent>(this->bus_->get_current_time(), symbol_);
+        this->schedule_for_self_at(due, wakeup_event, l2_timer_topic_id_);
+    }
+
+    // Applies one journal entry to a side sorted best-first. Returns false if the level already had that quantity.
+    static bool _apply_level_change(ModelEvents::OrderBookLevel& levels, PriceType price, QuantityType quantity, bool descending) {
+        auto it = std::lower_bound(levels.begin(), levels.end(), price,
+                                   [descending](const ModelEvents::PriceQuantityPair& level, PriceType p) {
+                                       return descending ? level.first > p : level.first < p;
+                                   });
+        bool present = (it != levels.end() && it->first == price);
+        if (quantity == 0) {
+            if (!present) return false;
+            levels.erase(it);
+            return true;
+        }
+        if (!present) {
+            levels.insert(it, {price, quantity});
+            return true;
+        }
+        if (it->second == quantity) return false;
+        it->second = quantity;
+        return true;
+    }
+
+    // Records a level's new quantity in a delta side sorted best-first; unlike the book, 0 is kept as an entry.
+    static void _record_delta_level(ModelEvents::OrderBookLevel& levels, PriceType price, QuantityType quantity, bool descending) {
+        auto it = std::lower_bound(levels.begin(), levels.end(), price,
+                                   [descending](const ModelEvents::PriceQuantityPair& level, PriceType p) {
+                                       return descending ? level.first > p : level.first < p;
+                                   });
+        if (it != levels.end() && it->first == price) {
+            it->second = quantity;
+        } else {
+            levels.insert(it, {price, quantity});
+        }
+    }
+
+    void _apply_book_changes();
+    void _publish_l2_if_due();
+    // Publishes the feeds selected by l2_publish_mode_; `full_book` forces the delta feed to send a snapshot.
+    void _publish_l2_update(bool full_book);
+    void _publish_last_l2_snapshot();
+    void _publish_l2_delta(bool full_book);
+
+    // True if the next event on the bus is another batchable order entry for this adapter at the current time.
+    // The bus pops events strictly in (time, sequence) order, so nothing else can run in between.
+    bool _next_event_extends_batch() const {
+        if (!batch_order_entry_ || !this->bus_) {
+            return false;
+        }
+        std::optional<ScheduledEvent> next = this->bus_->peak();
+        return next && next->scheduled_time == this->bus_->get_current_time() && _accepts_order_entry(*next);
+    }
+
+    // Whether `next` is an order entry this adapter would add to its batch.
+    bool _accepts_order_entry(const ScheduledEvent& next) const {
+        if (next.subscriber_id != this->get_id()) {
+            return false;
+        }
+        return std::visit([this](const auto& event_ptr) {
+            using E = std::remove_const_t<typename std::decay_t<decltype(event_ptr)>::element_type>;
+            if constexpr (std::is_same_v<E, ModelEvents::LimitOrderEvent> ||
+                          std::is_same_v<E, ModelEvents::MarketOrderEvent> ||
+                          std::is_same_v<E, ModelEvents::FullCancelLimitOrderEvent>) {
+                return event_ptr->symbol == symbol_;
+            } else {
+                return false;
+            }
+        }, next.event);
+    }
+
+    // Queues one order entry; the batch runs as soon as the next event no longer extends it.
+    void _enqueue_order(const Exchange::OrderInstruction& instruction) {
+        pending_orders_.push_back(instruction);
+        _finish_order_entry();
+    }
+
+    void _finish_order_entry() {
+        if (_next_event_extends_batch()) {
             return;
         }
-        // This call will trigger the _on_order_book_snapshot callback if the book has changed
-        // (or even if not, the callback will decide based on its internal state)
-        exchange_.get_order_book_snapshot();
+        if (!shard_group_) {
+            _execute_pending_orders();
+            _publish_orderbook_snapshot_if_changed();
+            return;
+        }
+        // Without batching the entry runs on its own right away, but the shard window may still have to close.
+        if (!batch_order_entry_) {
+            _execute_pending_orders();
+            _publish_orderbook_snapshot_if_changed();
+        }
+        shard_group_->finish_order_entry(*this, this->bus_->peak(), this->bus_->get_current_time(), batch_order_entry_);
     }
 
-    void _setup_callbacks();
+    // Shard side of ShardGroup::run_window. Only touches this adapter and its exchange, so shards run concurrently.
+    void _run_shard_batch() {
+        hold_publications_ = true;
+        _execute_pending_orders();
+        _publish_orderbook_snapshot_if_changed();
+        hold_publications_ = false;
+    }
+
+    void _release_shard_batch() {
+        for (const HeldPublication& held : held_publications_) {
+            std::visit([this, &held](const auto& event_ptr) {
+                publish_wrapper(held.topic_, held.stream_id_, event_ptr);
+            }, held.event_);
+        }
+        held_publications_.clear();
+        // Wake-ups are scheduled here, on the bus thread
+        _sync_exchange_clock();
+        if (l2_changes_pending_) {
+            _schedule_l2_wakeup();
+        }
+    }
+
+    void _on_self_wakeup() {
+        _execute_pending_orders();
+        _sync_exchange_clock();
+        _publish_orderbook_snapshot_if_changed();
+    }
+
+    void _execute_pending_orders();
+    void _sync_exchange_clock();
+    void _on_order_instruction_done(const Exchange::OrderInstruction& instruction, const Exchange::OrderInstructionResult& result);
+
 
 public:
     // Event handlers from ModelEventProcessor
     void handle_event(const ModelEvents::LimitOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _trader_topics(sender_id); // Interned here, on the bus thread, as the batch may run on a shard worker
         _process_limit_order(event, sender_id);
     }
     void handle_event(const ModelEvents::MarketOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _trader_topics(sender_id); // Interned here, on the bus thread, as the batch may run on a shard worker
         _process_market_order(event, sender_id);
     }
     void handle_event(const ModelEvents::FullCancelLimitOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _trader_topics(sender_id); // Interned here, on the bus thread, as the batch may run on a shard worker
         _process_full_cancel_limit_order(event, sender_id);
     }
     void handle_event(const ModelEvents::FullCancelMarketOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _execute_pending_orders();
         _process_full_cancel_market_order(event, sender_id);
     }
+    void handle_event(const ModelEvents::MassCancelLimitOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
+        if (event.symbol != symbol_) return;
+        _execute_pending_orders();
+        _process_mass_cancel_limit_order(event, sender_id);
+    }
     void handle_event(const ModelEvents::PartialCancelLimitOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _execute_pending_orders();
         _process_partial_cancel_limit_order(event, sender_id);
     }
     void handle_event(const ModelEvents::PartialCancelMarketOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _execute_pending_orders();
         _process_partial_cancel_market_order(event, sender_id);
     }
     void handle_event(const ModelEvents::Bang& event, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {
+        _execute_pending_orders();
         _process_bang(event);
     }
     void handle_event(const ModelEvents::TriggerExpiredLimitOrderEvent& event, TopicId, AgentId sender_id, Timestamp, StreamId, SequenceNumber) {
         if (event.symbol != symbol_) return;
+        _execute_pending_orders();
         _process_trigger_expired_limit_order_event(event, sender_id);
     }
 
     // Empty handlers for events this adapter publishes but does not consume
     void handle_event(const ModelEvents::LTwoOrderBookEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+    void handle_event(const ModelEvents::LTwoDeltaEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::LimitOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::MarketOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::FullCancelLimitOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::FullCancelMarketOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+    void handle_event(const ModelEvents::MassCancelLimitOrderAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::PartialCancelLimitAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::PartialCancelMarketAckEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::PartialCancelLimitOrderRejectEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
@@ -256,13 +813,27 @@ public:
     void handle_event(const ModelEvents::TradeEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::RejectTriggerExpiredLimitOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
     void handle_event(const ModelEvents::AckTriggerExpiredLimitOrderEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
-    void handle_event(const ModelEvents::CheckLimitOrderExpirationEvent&, TopicId, AgentId, Timestamp, StreamId, SequenceNumber) {}
+    // Self wake-up for exchange-side expiry, scheduled by _sync_exchange_clock
+    void handle_event(const ModelEvents::CheckLimitOrderExpirationEvent&, TopicId, AgentId, Timestamp now, StreamId, SequenceNumber) {
+        if (expiry_wakeup_time_ && *expiry_wakeup_time_ <= std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count()) {
+            expiry_wakeup_time_ = std::nullopt;
+        }
+        _on_self_wakeup();
+    }
+    // Self wake-up at the end of a conflation window, scheduled by _schedule_l2_wakeup
+    void handle_event(const ModelEvents::L2PublishTimerEvent&, TopicId, AgentId, Timestamp now, StreamId, SequenceNumber) {
+        if (l2_wakeup_time_ && *l2_wakeup_time_ <= now) {
+            l2_wakeup_time_ = std::nullopt;
+        }
+        _on_self_wakeup();
+    }
 
 private:
     void _process_limit_order(const ModelEvents::LimitOrderEvent& event, AgentId trader_id);
     void _process_market_order(const ModelEvents::MarketOrderEvent& event, AgentId trader_id);
     void _process_full_cancel_limit_order(const ModelEvents::FullCancelLimitOrderEvent& event, AgentId trader_id);
     void _process_full_cancel_market_order(const ModelEvents::FullCancelMarketOrderEvent& event, AgentId trader_id);
+    void _process_mass_cancel_limit_order(const ModelEvents::MassCancelLimitOrderEvent& event, AgentId trader_id);
     void _process_partial_cancel_limit_order(const ModelEvents::PartialCancelLimitOrderEvent& event, AgentId trader_id);
     void _process_partial_cancel_market_order(const ModelEvents::PartialCancelMarketOrderEvent& event, AgentId trader_id);
     void _process_bang(const ModelEvents::Bang& event);
@@ -275,6 +846,7 @@ private:
     void _on_partial_cancel_limit_reject(ExchangeIDType xid, AgentId trader_id_req, ClientOrderIdType client_order_id_req);
     void _on_full_cancel_limit(ExchangeIDType xid, ExchangePriceType price, ExchangeQuantityType qty, ExchangeSide ex_side, AgentId trader_id_req, ClientOrderIdType client_order_id_req);
     void _on_full_cancel_limit_reject(ExchangeIDType xid, AgentId trader_id_req, ClientOrderIdType client_order_id_req);
+    void _on_mass_cancel_limit(const std::vector<CancelledOrder>& cancelled, AgentId trader_id_req, ClientOrderIdType client_order_id_req);
     void _on_trade(ExchangeIDType maker_xid, ExchangeSide m_side, ExchangeIDType taker_xid, ExchangeSide t_side, ExchangePriceType price, ExchangeQuantityType qty, bool maker_exhausted, AgentId maker_trader_id, ClientOrderIdType maker_client_id, AgentId taker_trader_id, ClientOrderIdType taker_client_id);
 
     // Maker Fill Callbacks (Limit Order as Maker)
@@ -293,6 +865,9 @@ private:
     void _on_taker_partial_fill_market(ExchangeIDType taker_xid, ExchangeSide taker_ex_side, ExchangePriceType price, ExchangeQuantityType qty_filled_this_segment, ExchangeQuantityType leaves_qty_on_taker_order, AgentId trader_id, ClientOrderIdType client_order_id);
     void _on_taker_full_fill_market(ExchangeIDType taker_xid, ExchangeSide taker_ex_side, ExchangePriceType price, ExchangeQuantityType total_qty_filled_for_taker, AgentId trader_id, ClientOrderIdType client_order_id);
 
+    // Aggregated mode: replaces _on_trade and the maker/taker fill callbacks for one incoming order
+    void _on_execution_report(const ExecutionReport& report);
+
     void _on_order_book_snapshot(const std::vector<L2_DATA_TYPE>& bids, const std::vector<L2_DATA_TYPE>& asks);
     void _on_acknowledge_trigger_expiration(ExchangeIDType xid, ExchangePriceType price, ExchangeQuantityType qty_expired, AgentId original_placer_trader_id, ClientOrderIdType original_placer_client_order_id, ExchangeTimeType timeout_us_rep);
     void _on_reject_trigger_expiration(ExchangeIDType xid, AgentId original_placer_trader_id, ClientOrderIdType original_placer_client_order_id, ExchangeTimeType timeout_us_rep);
@@ -310,150 +885,152 @@ private:
 };
 
 
-void EventModelExchangeAdapter::_setup_callbacks() {
-    exchange_.on_limit_order_acknowledged = [this](ExchangeIDType xid, ExchangeSide s, ExchangePriceType p, ExchangeQuantityType q, ExchangeQuantityType rq, AgentId tid, ClientOrderIdType cid, ExchangeTimeType tus) {
-        this->_on_limit_order_acknowledged(xid, s, p, q, rq, tid, cid, tus);
-    };
-    exchange_.on_market_order_acknowledged = [this](ExchangeSide s, ExchangeQuantityType rq, ExchangeQuantityType eq, ExchangeQuantityType uq, AgentId tid, ClientOrderIdType cid) {
-        this->_on_market_order_acknowledged(s, rq, eq, uq, tid, cid);
-    };
-    exchange_.on_partial_cancel_limit = [this](ExchangeIDType xid, ExchangePriceType p, ExchangeQuantityType cq, AgentId tid_req, ClientOrderIdType cid_req) {
-        this->_on_partial_cancel_limit(xid, p, cq, tid_req, cid_req);
-    };
-    exchange_.on_partial_cancel_limit_reject = [this](ExchangeIDType xid, AgentId tid_req, ClientOrderIdType cid_req) {
-        this->_on_partial_cancel_limit_reject(xid, tid_req, cid_req);
-    };
-    exchange_.on_full_cancel_limit = [this](ExchangeIDType xid, ExchangePriceType p, ExchangeQuantityType q, ExchangeSide s, AgentId tid_req, ClientOrderIdType cid_req) {
-        this->_on_full_cancel_limit(xid, p, q, s, tid_req, cid_req);
-    };
-    exchange_.on_full_cancel_limit_reject = [this](ExchangeIDType xid, AgentId tid_req, ClientOrderIdType cid_req) {
-        this->_on_full_cancel_limit_reject(xid, tid_req, cid_req);
-    };
-    exchange_.on_trade = [this](ExchangeIDType mxid, ExchangeSide m_side, ExchangeIDType txid, ExchangeSide t_side, ExchangePriceType p, ExchangeQuantityType q, bool mex, AgentId mtid, ClientOrderIdType mcid, AgentId ttid, ClientOrderIdType tcid) {
-        this->_on_trade(mxid, m_side, txid, t_side, p, q, mex, mtid, mcid, ttid, tcid);
-    };
-
-    // Maker fills
-    exchange_.on_maker_partial_fill_limit = [this](ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
-        this->_on_maker_partial_fill_limit(mxid, p, q_seg, maker_s, tid, cid);
-    };
-    exchange_.on_maker_full_fill_limit = [this](ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType total_q, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
-        this->_on_maker_full_fill_limit(mxid, p, total_q, maker_s, tid, cid);
-    };
-    exchange_.on_maker_partial_fill_market = [this](ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
-        this->_on_maker_partial_fill_market(mxid, p, q_seg, maker_s, tid, cid);
-    };
-    exchange_.on_maker_full_fill_market = [this](ExchangeIDType mxid, ExchangePriceType p, ExchangeQuantityType total_q, ExchangeSide maker_s, AgentId tid, ClientOrderIdType cid) {
-        this->_on_maker_full_fill_market(mxid, p, total_q, maker_s, tid, cid);
-    };
-
-    // Taker fills
-    exchange_.on_taker_partial_fill_limit = [this](ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeQuantityType lq, AgentId tid, ClientOrderIdType cid) {
-        this->_on_taker_partial_fill_limit(txid, taker_s, p, q_seg, lq, tid, cid);
-    };
-    exchange_.on_taker_full_fill_limit = [this](ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType total_q, AgentId tid, ClientOrderIdType cid) {
-        this->_on_taker_full_fill_limit(txid, taker_s, p, total_q, tid, cid);
-    };
-    exchange_.on_taker_partial_fill_market = [this](ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType q_seg, ExchangeQuantityType lq, AgentId tid, ClientOrderIdType cid) {
-        this->_on_taker_partial_fill_market(txid, taker_s, p, q_seg, lq, tid, cid);
-    };
-    exchange_.on_taker_full_fill_market = [this](ExchangeIDType txid, ExchangeSide taker_s, ExchangePriceType p, ExchangeQuantityType total_q, AgentId tid, ClientOrderIdType cid) {
-        this->_on_taker_full_fill_market(txid, taker_s, p, total_q, tid, cid);
-    };
-
-    exchange_.on_order_book_snapshot = [this](const std::vector<L2_DATA_TYPE>& b, const std::vector<L2_DATA_TYPE>& a) {
-        this->_on_order_book_snapshot(b, a);
-    };
-    exchange_.on_acknowledge_trigger_expiration = [this](ExchangeIDType xid, ExchangePriceType p, ExchangeQuantityType q, AgentId tid, ClientOrderIdType cid, ExchangeTimeType tus) {
-        this->_on_acknowledge_trigger_expiration(xid, p, q, tid, cid, tus);
-    };
-    exchange_.on_reject_trigger_expiration = [this](ExchangeIDType xid, AgentId tid, ClientOrderIdType cid, ExchangeTimeType tus) {
-        this->_on_reject_trigger_expiration(xid, tid, cid, tus);
-    };
+void EventModelExchangeAdapter::_process_limit_order(const ModelEvents::LimitOrderEvent& event, AgentId trader_id) {
+    Exchange::OrderInstruction instruction;
+    instruction.type_ = Exchange::OrderInstruction::Type::LIMIT;
+    instruction.side_ = _to_exchange_side(event.side);
+    instruction.price_ = event.price;
+    instruction.quantity_ = event.quantity;
+    instruction.timeout_us_rep_ = std::chrono::duration_cast<std::chrono::microseconds>(event.timeout).count();
+    instruction.trader_id_ = trader_id;
+    instruction.client_order_id_ = event.client_order_id;
+    _enqueue_order(instruction);
 }
 
+void EventModelExchangeAdapter::_process_market_order(const ModelEvents::MarketOrderEvent& event, AgentId trader_id) {
+    Exchange::OrderInstruction instruction;
+    instruction.type_ = Exchange::OrderInstruction::Type::MARKET;
+    instruction.side_ = _to_exchange_side(event.side);
+    instruction.quantity_ = event.quantity;
+    instruction.trader_id_ = trader_id;
+    instruction.client_order_id_ = event.client_order_id;
+    _enqueue_order(instruction);
+}
 
-void EventModelExchangeAdapter::_process_limit_order(const ModelEvents::LimitOrderEvent& event, AgentId trader_id) {
-    ExchangeSide ex_side = _to_exchange_side(event.side);
-    ExchangeTimeType timeout_us_rep = std::chrono::duration_cast<std::chrono::microseconds>(event.timeout).count();
+void EventModelExchangeAdapter::_execute_pending_orders() {
+    if (pending_orders_.empty()) {
+        return;
+    }
+    _sync_exchange_clock(); // Orders due by now leave the book before the batch can match them
+    exchange_.process_batch(pending_orders_, [this](std::size_t i, const Exchange::OrderInstructionResult& result) {
+        _on_order_instruction_done(pending_orders_[i], result);
+    });
+    pending_orders_.clear();
+    _sync_exchange_clock(); // Schedules a wake-up for the orders that just rested
+}
 
-    ExchangeIDType xid = exchange_.place_limit_order(
-            ex_side, event.price, event.quantity, timeout_us_rep,
-            trader_id, event.client_order_id
-    );
+// Moves the exchange clock to bus time, expiring what is due, and makes sure a wake-up is scheduled for the next
+// expiry. A wake-up already scheduled no later than that is kept; superseded ones arrive as harmless no-ops.
+void EventModelExchangeAdapter::_sync_exchange_clock() {
+    if (!exchange_.expiry_enabled() || !this->bus_) {
+        return;
+    }
+    Timestamp current_time = this->bus_->get_current_time();
+    exchange_.advance_time(std::chrono::duration_cast<std::chrono::microseconds>(current_time.time_since_epoch()).count());
+    if (hold_publications_) {
+        return;
+    }
 
-    if (xid != ID_DEFAULT) { // ID_DEFAULT means it was fully filled aggressively and didn't rest
-        _register_order_mapping(trader_id, event.client_order_id, xid, MappedOrderType::LIMIT);
-    } else {
-        // If xid is ID_DEFAULT, it means the order was fully filled as a taker
-        // and did not rest on the book. ExchangeServer will use a transient ID for these fills.
-        // We still need a way to map responses for this client_order_id if an ack is expected
-        // even for fully aggressive fills. The current _on_limit_order_acknowledged uses
-        // `ack_exchange_order_id` which is `xid` here.
-        // A transient ID *should* be generated by ExchangeServer and used in fills,
-        // and the ack might report ID_DEFAULT or the transient ID.
-        // For now, we don't register a mapping if it didn't rest. The fill events will carry
-        // the client_order_id.
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Limit order for Trader " + std::to_string(trader_id) +
-                                             ", CID " + std::to_string(event.client_order_id) + " did not rest (XID=ID_DEFAULT). No persistent mapping registered.");
+    std::optional<ExchangeTimeType> next_expiry = exchange_.next_expiry_time();
+    if (!next_expiry || (expiry_wakeup_time_ && *expiry_wakeup_time_ <= *next_expiry)) {
+        return;
     }
-    _publish_orderbook_snapshot_if_changed();
+    expiry_wakeup_time_ = next_expiry;
+    auto wakeup_event = ModelEvents::make_event<ModelEvents::CheckLimitOrderExpirationEvent>(current_time, ID_DEFAULT, Duration{});
+    this->schedule_for_self_at(Timestamp(std::chrono::microseconds(*next_expiry)), wakeup_event, expiry_wakeup_topic_id_);
 }
 
-void EventModelExchangeAdapter::_process_market_order(const ModelEvents::MarketOrderEvent& event, AgentId trader_id) {
-    ExchangeSide ex_side = _to_exchange_side(event.side);
-
-    ExchangeIDType transient_xid = exchange_.place_market_order(
-            ex_side, event.quantity,
-            trader_id, event.client_order_id
-    );
-    // Market orders always get a transient ID from ExchangeServer.
-    // We register this mapping to correlate ACKs and Fills.
-    _register_order_mapping(trader_id, event.client_order_id, transient_xid, MappedOrderType::MARKET);
-    _publish_orderbook_snapshot_if_changed();
+// Runs right after each batched instruction, before the next one, so later instructions see its mappings.
+void EventModelExchangeAdapter::_on_order_instruction_done(const Exchange::OrderInstruction& instruction,
+                                                           const Exchange::OrderInstructionResult& result) {
+    switch (instruction.type_) {
+        case Exchange::OrderInstruction::Type::LIMIT:
+            if (result.order_id_ != ID_DEFAULT) { // ID_DEFAULT means it was fully filled aggressively and didn't rest
+                _register_order_mapping(instruction.trader_id_, instruction.client_order_id_, result.order_id_, MappedOrderType::LIMIT);
+            } else {
+                // If xid is ID_DEFAULT, it means the order was fully filled as a taker
+                // and did not rest on the book. ExchangeServer will use a transient ID for these fills.
+                // We still need a way to map responses for this client_order_id if an ack is expected
+                // even for fully aggressive fills. The current _on_limit_order_acknowledged uses
+                // `ack_exchange_order_id` which is `xid` here.
+                // A transient ID *should* be generated by ExchangeServer and used in fills,
+                // and the ack might report ID_DEFAULT or the transient ID.
+                // For now, we don't register a mapping if it didn't rest. The fill events will carry
+                // the client_order_id.
+                if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+                    LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Limit order for Trader " + std::to_string(instruction.trader_id_) +
+                                                         ", CID " + std::to_string(instruction.client_order_id_) + " did not rest (XID=ID_DEFAULT). No persistent mapping registered.");
+                }
+            }
+            break;
+        case Exchange::OrderInstruction::Type::MARKET:
+            // Market orders never rest: by now their ack and fills have gone out under the transient ID and any
+            // unfilled remainder is dropped, so nothing is left to map. Fill state started by partial fills that
+            // were not followed by a full fill goes too.
+            _clear_fill_state(result.order_id_);
+            break;
+        case Exchange::OrderInstruction::Type::CANCEL:
+            // Rejection is handled by _on_full_cancel_limit_reject callback
+            break;
+    }
 }
 
 void EventModelExchangeAdapter::_process_full_cancel_limit_order(const ModelEvents::FullCancelLimitOrderEvent& event, AgentId trader_id) {
+    // Earlier entries of the batch may have placed the target, so they run before it is looked up.
+    _execute_pending_orders();
     std::optional<ExchangeOrderIdType> xid_opt = _get_exchange_order_id(trader_id, event.target_order_id);
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
     if (!xid_opt) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "FullCancelLimitOrder: XID not found for Trader " + std::to_string(trader_id) + ", TargetCID " + std::to_string(event.target_order_id));
-        auto reject_event = std::make_shared<const ModelEvents::FullCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::FullCancelLimitOrderRejectEvent>(
                 current_time, event.client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("FullCancelLimitOrderRejectEvent", trader_id),
-                        _format_stream_id(trader_id, event.client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::FullCancelLimitOrderRejectEvent, trader_id),
+                        _order_stream_id(trader_id, event.client_order_id), reject_event);
+        _finish_order_entry();
         return;
     }
     ExchangeOrderIdType xid = *xid_opt;
 
-    auto order_type_it = order_type_map_.find(xid);
-    if (order_type_it == order_type_map_.end() || order_type_it->second != MappedOrderType::LIMIT) {
+    if (_mapped_order_type(xid) != MappedOrderType::LIMIT) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "FullCancelLimitOrder: Target XID " + std::to_string(xid) + " is not a limit order or mapping missing.");
-        auto reject_event = std::make_shared<const ModelEvents::FullCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::FullCancelLimitOrderRejectEvent>(
                 current_time, event.client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("FullCancelLimitOrderRejectEvent", trader_id),
-                        _format_stream_id(trader_id, event.client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::FullCancelLimitOrderRejectEvent, trader_id),
+                        _order_stream_id(trader_id, event.client_order_id), reject_event);
+        _finish_order_entry();
         return;
     }
 
-    bool success = exchange_.cancel_order(xid, trader_id, event.client_order_id);
-    if (success) {
-        _publish_orderbook_snapshot_if_changed();
-    }
+    Exchange::OrderInstruction instruction;
+    instruction.type_ = Exchange::OrderInstruction::Type::CANCEL;
+    instruction.target_order_id_ = xid;
+    instruction.trader_id_ = trader_id;
+    instruction.client_order_id_ = event.client_order_id;
+    _enqueue_order(instruction);
     // Rejection is handled by _on_full_cancel_limit_reject callback
 }
 
+void EventModelExchangeAdapter::_process_mass_cancel_limit_order(const ModelEvents::MassCancelLimitOrderEvent& event, AgentId trader_id) {
+    std::optional<ExchangeSide> side;
+    if (event.side) {
+        side = _to_exchange_side(*event.side);
+    }
+    // The exchange walks only this trader's resting orders; the ack is published by _on_mass_cancel_limit and the
+    // book update goes out once for the whole request.
+    exchange_.mass_cancel_orders(trader_id, side, event.min_price, event.max_price, event.client_order_id);
+    _publish_orderbook_snapshot_if_changed();
+}
+
 void EventModelExchangeAdapter::_process_full_cancel_market_order(const ModelEvents::FullCancelMarketOrderEvent& event, AgentId trader_id) {
     std::optional<ExchangeOrderIdType> xid_opt = _get_exchange_order_id(trader_id, event.target_order_id);
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
     if (xid_opt) {
         ExchangeOrderIdType xid = *xid_opt;
-        auto order_type_it = order_type_map_.find(xid);
-        if (order_type_it != order_type_map_.end() && order_type_it->second == MappedOrderType::MARKET) {
+        if (_mapped_order_type(xid) == MappedOrderType::MARKET) {
             // Market orders are typically FOK or fill-what-you-can-immediately.
             // Cancelling a market order that has already been processed might not be possible.
             // ExchangeServer's cancel_order is generic; it might succeed if the order somehow still exists.
@@ -470,11 +1047,11 @@ void EventModelExchangeAdapter::_process_full_cancel_market_order(const ModelEve
     }
 
     // Generally, market orders cannot be cancelled after they've been accepted and processed.
-    auto reject_event = std::make_shared<const ModelEvents::FullCancelMarketOrderRejectEvent>(
+    auto reject_event = ModelEvents::make_event<ModelEvents::FullCancelMarketOrderRejectEvent>(
             current_time, event.client_order_id, symbol_
     );
-    publish_wrapper(_format_topic_for_trader("FullCancelMarketOrderRejectEvent", trader_id),
-                    _format_stream_id(trader_id, event.client_order_id), reject_event);
+    publish_wrapper(_trader_topic(TraderTopic::FullCancelMarketOrderRejectEvent, trader_id),
+                    _order_stream_id(trader_id, event.client_order_id), reject_event);
 }
 
 void EventModelExchangeAdapter::_process_partial_cancel_limit_order(const ModelEvents::PartialCancelLimitOrderEvent& event, AgentId trader_id) {
@@ -483,42 +1060,41 @@ void EventModelExchangeAdapter::_process_partial_cancel_limit_order(const ModelE
 
     if (!xid_opt) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "PartialCancelLimitOrder: XID not found for Trader " + std::to_string(trader_id) + ", TargetCID " + std::to_string(event.target_order_id));
-        auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(
                 current_time, event.client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", trader_id),
-                        _format_stream_id(trader_id, event.client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, trader_id),
+                        _order_stream_id(trader_id, event.client_order_id), reject_event);
         return;
     }
     ExchangeOrderIdType xid = *xid_opt;
 
-    auto order_type_it = order_type_map_.find(xid);
-    if (order_type_it == order_type_map_.end() || order_type_it->second != MappedOrderType::LIMIT) {
+    if (_mapped_order_type(xid) != MappedOrderType::LIMIT) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "PartialCancelLimitOrder: Target XID " + std::to_string(xid) + " is not a limit order or mapping missing.");
-        auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(
                 current_time, event.client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", trader_id),
-                        _format_stream_id(trader_id, event.client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, trader_id),
+                        _order_stream_id(trader_id, event.client_order_id), reject_event);
         return;
     }
 
     std::optional<std::tuple<ExchangePriceType, ExchangeQuantityType, ExchangeSide>> details_opt = exchange_.get_order_details(xid);
     if (!details_opt) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "PartialCancelLimitOrder: Could not get details for XID " + std::to_string(xid) + ". Order might be gone.");
-        auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(
                 current_time, event.client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", trader_id),
-                        _format_stream_id(trader_id, event.client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, trader_id),
+                        _order_stream_id(trader_id, event.client_order_id), reject_event);
         return;
     }
 
     ExchangeQuantityType current_qty_on_book = std::get<1>(*details_opt);
     if (event.cancel_qty <= 0) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "PartialCancelLimitOrder: Cancel quantity (" + std::to_string(event.cancel_qty) + ") must be positive. Rejecting.");
-        auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(current_time, event.client_order_id, symbol_);
-        publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", trader_id), _format_stream_id(trader_id, event.client_order_id), reject_event);
+        auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(current_time, event.client_order_id, symbol_);
+        publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, trader_id), _order_stream_id(trader_id, event.client_order_id), reject_event);
         return;
     }
 
@@ -541,38 +1117,40 @@ void EventModelExchangeAdapter::_process_partial_cancel_market_order(const Model
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
     LogMessage(LogLevel::WARNING, this->get_logger_source(), "PartialCancelMarketOrder: Market orders cannot typically be partially cancelled after submission. Rejecting. Trader " + std::to_string(trader_id) + ", TargetCID " + std::to_string(event.target_order_id));
 
-    auto reject_event = std::make_shared<const ModelEvents::PartialCancelMarketOrderRejectEvent>(
+    auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelMarketOrderRejectEvent>(
             current_time, event.client_order_id, symbol_
     );
-    publish_wrapper(_format_topic_for_trader("PartialCancelMarketOrderRejectEvent", trader_id),
-                    _format_stream_id(trader_id, event.client_order_id), reject_event);
+    publish_wrapper(_trader_topic(TraderTopic::PartialCancelMarketOrderRejectEvent, trader_id),
+                    _order_stream_id(trader_id, event.client_order_id), reject_event);
 }
 
 void EventModelExchangeAdapter::_process_bang(const ModelEvents::Bang& /*event unused*/) {
     LogMessage(LogLevel::INFO, this->get_logger_source(), "Processing Bang event. Flushing exchange and all local mappings.");
-    trader_client_to_exchange_map_.clear();
-    exchange_to_trader_client_map_.clear();
-    order_type_map_.clear();
-    expiration_trigger_sender_map_.clear();
-    partial_fill_tracker_.clear(); // Clear partial fill states
+    order_records_.clear(); // Mappings, pending expiration triggers and partial fill states
 
     last_published_bids_l2_ = std::nullopt;
     last_published_asks_l2_ = std::nullopt;
+    delta_bids_l2_.clear();
+    delta_asks_l2_.clear();
+    l2_changes_pending_ = false;
+    last_l2_publish_time_ = std::nullopt; // The empty book goes out now, whatever the conflation window
 
     exchange_.flush(); // Flushes ExchangeServer's internal state
 
     Timestamp current_time_for_bang = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
-    publish_wrapper("Bang", std::make_shared<const ModelEvents::Bang>(current_time_for_bang));
+    publish_wrapper(bang_topic_id_, ModelEvents::make_event<ModelEvents::Bang>(current_time_for_bang));
     _publish_orderbook_snapshot_if_changed(); // Will publish empty book if auto_publish is on
 }
 
 void EventModelExchangeAdapter::_process_trigger_expired_limit_order_event(const ModelEvents::TriggerExpiredLimitOrderEvent& event, AgentId trigger_sender_id) {
-    LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Processing TriggerExpiredLimitOrderEvent for XID: " + std::to_string(event.target_exchange_order_id) + " from sender: " + std::to_string(trigger_sender_id));
+    if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Processing TriggerExpiredLimitOrderEvent for XID: " + std::to_string(event.target_exchange_order_id) + " from sender: " + std::to_string(trigger_sender_id));
+    }
 
     ExchangeIDType xid_to_cancel = event.target_exchange_order_id;
     ExchangeTimeType timeout_us_rep = std::chrono::duration_cast<std::chrono::microseconds>(event.timeout_value).count();
 
-    expiration_trigger_sender_map_[xid_to_cancel] = trigger_sender_id;
+    order_records_.emplace(xid_to_cancel).expiration_trigger_sender = trigger_sender_id;
 
     bool call_succeeded = exchange_.cancel_expired_order(xid_to_cancel, timeout_us_rep);
 
@@ -580,7 +1158,7 @@ void EventModelExchangeAdapter::_process_trigger_expired_limit_order_event(const
         _publish_orderbook_snapshot_if_changed();
     }
     // Callbacks (_on_acknowledge_trigger_expiration / _on_reject_trigger_expiration) will handle publishing ack/reject
-    // and cleaning expiration_trigger_sender_map_.
+    // and clearing the pending trigger sender.
 }
 
 
@@ -601,17 +1179,19 @@ void EventModelExchangeAdapter::_on_limit_order_acknowledged(
     ExchangeOrderIdType ack_xid_to_publish = xid;
 
 
-    auto ack_event = std::make_shared<const ModelEvents::LimitOrderAckEvent>(
+    auto ack_event = ModelEvents::make_event<ModelEvents::LimitOrderAckEvent>(
             current_time, ack_xid_to_publish, client_order_id, model_side, price, quantity, symbol_, timeout_duration,
             trader_id // original_trader_id field in LimitOrderAckEvent
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("LimitOrderAckEvent", trader_id), stream_id_str, ack_event);
-    publish_wrapper("LimitOrderAckEvent", stream_id_str, ack_event); // Generic topic
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::LimitOrderAckEvent, trader_id), stream_id, ack_event);
+    publish_wrapper(_generic_topic(TraderTopic::LimitOrderAckEvent), stream_id, ack_event); // Generic topic
 
     if (xid != ID_DEFAULT && remaining_qty == 0) { // If it had a persistent ID and is now fully gone
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Limit order XID " + std::to_string(xid) + " fully resolved on acknowledgement (remaining_qty=0). Removing mapping.");
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Limit order XID " + std::to_string(xid) + " fully resolved on acknowledgement (remaining_qty=0). Removing mapping.");
+        }
         _remove_order_mapping(xid);
     }
     // If xid was ID_DEFAULT, no mapping was registered in _process_limit_order, so no removal needed here.
@@ -632,17 +1212,19 @@ void EventModelExchangeAdapter::_on_market_order_acknowledged(
     }
 
 
-    auto ack_event = std::make_shared<const ModelEvents::MarketOrderAckEvent>(
+    auto ack_event = ModelEvents::make_event<ModelEvents::MarketOrderAckEvent>(
             current_time, xid_for_ack, client_order_id, model_side, req_qty, symbol_
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("MarketOrderAckEvent", trader_id), stream_id_str, ack_event);
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::MarketOrderAckEvent, trader_id), stream_id, ack_event);
     // No generic publish for MarketOrderAckEvent based on original code, can be added if needed.
 
     // If the market order is fully processed (either fully filled or remaining part is unfillable)
     if (xid_for_ack != ID_DEFAULT && (exec_qty == req_qty || unfill_qty > 0) ) {
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Market order XID " + std::to_string(xid_for_ack) + " fully resolved on acknowledgement. Removing mapping.");
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Market order XID " + std::to_string(xid_for_ack) + " fully resolved on acknowledgement. Removing mapping.");
+        }
         _remove_order_mapping(xid_for_ack);
     }
 }
@@ -655,11 +1237,11 @@ void EventModelExchangeAdapter::_on_partial_cancel_limit(
     if (!original_ids_opt) {
         LogMessage(LogLevel::ERROR, this->get_logger_source(), "PartialCancelLimit ACK for unknown XID: " + std::to_string(xid) + ". Rejecting cancel request CID: " + std::to_string(req_client_order_id));
         Timestamp current_time_reject = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
-        auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(
                 current_time_reject, req_client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", req_trader_id),
-                        _format_stream_id(req_trader_id, req_client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, req_trader_id),
+                        _order_stream_id(req_trader_id, req_client_order_id), reject_event);
         return;
     }
     AgentId original_trader_id = original_ids_opt->first;
@@ -696,15 +1278,15 @@ void EventModelExchangeAdapter::_on_partial_cancel_limit(
         LogMessage(LogLevel::ERROR, this->get_logger_source(), "CRITICAL: _on_partial_cancel_limit called for XID " + std::to_string(xid) + " but get_order_details failed. This implies inconsistency.");
         // Fallback: publish reject for the cancel request if essential info is missing
         Timestamp current_time_reject = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
-        auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(current_time_reject, req_client_order_id, symbol_);
-        publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", req_trader_id), _format_stream_id(req_trader_id, req_client_order_id), reject_event);
+        auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(current_time_reject, req_client_order_id, symbol_);
+        publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, req_trader_id), _order_stream_id(req_trader_id, req_client_order_id), reject_event);
         return;
     }
 
     ModelEvents::Side model_side_original_order = _to_model_side(ex_side_original_order);
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
-    auto ack_event = std::make_shared<const ModelEvents::PartialCancelLimitAckEvent>(
+    auto ack_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitAckEvent>(
             current_time,
             xid,
             req_client_order_id, // CID of the cancel request itself
@@ -716,8 +1298,8 @@ void EventModelExchangeAdapter::_on_partial_cancel_limit(
             remaining_qty_after_cancel // Amount left after this cancel
     );
 
-    std::string stream_id_str = _format_stream_id(original_trader_id, original_client_order_id); // Stream of original order
-    publish_wrapper(_format_topic_for_trader("PartialCancelLimitAckEvent", req_trader_id), stream_id_str, ack_event);
+    StreamId stream_id = _order_stream_id(original_trader_id, original_client_order_id); // Stream of original order
+    publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitAckEvent, req_trader_id), stream_id, ack_event);
 
     // If remaining quantity is 0 due to this partial cancel, the order is effectively fully cancelled.
     // ExchangeServer's modify_order_quantity might have already removed it if new_qty was 0.
@@ -734,19 +1316,19 @@ void EventModelExchangeAdapter::_on_partial_cancel_limit_reject(
         ExchangeIDType xid, AgentId req_trader_id, ClientOrderIdType req_client_order_id) {
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
-    auto reject_event = std::make_shared<const ModelEvents::PartialCancelLimitOrderRejectEvent>(
+    auto reject_event = ModelEvents::make_event<ModelEvents::PartialCancelLimitOrderRejectEvent>(
             current_time, req_client_order_id, symbol_
     );
 
-    std::string stream_id_str;
+    StreamId stream_id;
     auto original_ids_opt = _get_trader_and_client_ids(xid); // xid is of the target order
     if(original_ids_opt) {
-        stream_id_str = _format_stream_id(original_ids_opt->first, original_ids_opt->second);
+        stream_id = _order_stream_id(original_ids_opt->first, original_ids_opt->second);
     } else { // Fallback if target order mapping is already gone or never existed for this XID
-        stream_id_str = _format_stream_id(req_trader_id, req_client_order_id);
+        stream_id = _order_stream_id(req_trader_id, req_client_order_id);
     }
 
-    publish_wrapper(_format_topic_for_trader("PartialCancelLimitOrderRejectEvent", req_trader_id), stream_id_str, reject_event);
+    publish_wrapper(_trader_topic(TraderTopic::PartialCancelLimitOrderRejectEvent, req_trader_id), stream_id, reject_event);
 }
 
 void EventModelExchangeAdapter::_on_full_cancel_limit(
@@ -769,11 +1351,11 @@ void EventModelExchangeAdapter::_on_full_cancel_limit(
         // Consider if ExchangeServer should provide original_client_order_id in its callback if known. (It does not currently)
         // Let's publish a reject for the cancel request if we can't map it, as the ACK event might be ill-formed.
         Timestamp current_time_for_reject = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
-        auto reject_event = std::make_shared<const ModelEvents::FullCancelLimitOrderRejectEvent>(
+        auto reject_event = ModelEvents::make_event<ModelEvents::FullCancelLimitOrderRejectEvent>(
                 current_time_for_reject, req_client_order_id, symbol_
         );
-        publish_wrapper(_format_topic_for_trader("FullCancelLimitOrderRejectEvent", req_trader_id),
-                        _format_stream_id(req_trader_id, req_client_order_id), reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::FullCancelLimitOrderRejectEvent, req_trader_id),
+                        _order_stream_id(req_trader_id, req_client_order_id), reject_event);
         _remove_order_mapping(xid); // Attempt to clean up if any stray mapping exists
         return;
     }
@@ -783,13 +1365,13 @@ void EventModelExchangeAdapter::_on_full_cancel_limit(
     ModelEvents::Side model_side = _to_model_side(ex_side);
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
-    auto ack_event = std::make_shared<const ModelEvents::FullCancelLimitOrderAckEvent>(
+    auto ack_event = ModelEvents::make_event<ModelEvents::FullCancelLimitOrderAckEvent>(
             current_time, xid, req_client_order_id, model_side, original_client_order_id, qty_cancelled, symbol_
     );
 
-    std::string stream_id_str = _format_stream_id(original_trader_id, original_client_order_id);
-    publish_wrapper(_format_topic_for_trader("FullCancelLimitOrderAckEvent", req_trader_id), stream_id_str, ack_event);
-    publish_wrapper("FullCancelLimitOrderAckEvent", stream_id_str, ack_event); // Generic
+    StreamId stream_id = _order_stream_id(original_trader_id, original_client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::FullCancelLimitOrderAckEvent, req_trader_id), stream_id, ack_event);
+    publish_wrapper(_generic_topic(TraderTopic::FullCancelLimitOrderAckEvent), stream_id, ack_event); // Generic
 
     _remove_order_mapping(xid); // Order is gone
 }
@@ -798,19 +1380,43 @@ void EventModelExchangeAdapter::_on_full_cancel_limit_reject(
         ExchangeIDType xid, AgentId req_trader_id, ClientOrderIdType req_client_order_id) {
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
-    auto reject_event = std::make_shared<const ModelEvents::FullCancelLimitOrderRejectEvent>(
+    auto reject_event = ModelEvents::make_event<ModelEvents::FullCancelLimitOrderRejectEvent>(
             current_time, req_client_order_id, symbol_
     );
 
-    std::string stream_id_str;
+    StreamId stream_id;
     auto original_ids_opt = _get_trader_and_client_ids(xid);
     if(original_ids_opt) {
-        stream_id_str = _format_stream_id(original_ids_opt->first, original_ids_opt->second);
+        stream_id = _order_stream_id(original_ids_opt->first, original_ids_opt->second);
     } else {
-        stream_id_str = _format_stream_id(req_trader_id, req_client_order_id);
+        stream_id = _order_stream_id(req_trader_id, req_client_order_id);
+    }
+
+    publish_wrapper(_trader_topic(TraderTopic::FullCancelLimitOrderRejectEvent, req_trader_id), stream_id, reject_event);
+}
+
+void EventModelExchangeAdapter::_on_mass_cancel_limit(
+        const std::vector<CancelledOrder>& cancelled, AgentId req_trader_id, ClientOrderIdType req_client_order_id) {
+    Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
+
+    std::vector<ModelEvents::MassCancelLimitOrderAckEvent::CancelledOrder> cancelled_orders;
+    cancelled_orders.reserve(cancelled.size());
+    for (const CancelledOrder& order : cancelled) {
+        cancelled_orders.push_back({order.order_id_, order.client_order_id_, _to_model_side(order.side_), order.price_, order.quantity_});
+        _remove_order_mapping(order.order_id_); // Order is gone
+    }
+    if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "MassCancelLimit for Trader " + std::to_string(req_trader_id) +
+                                             " removed " + std::to_string(cancelled_orders.size()) + " orders.");
     }
 
-    publish_wrapper(_format_topic_for_trader("FullCancelLimitOrderRejectEvent", req_trader_id), stream_id_str, reject_event);
+    auto ack_event = ModelEvents::make_event<ModelEvents::MassCancelLimitOrderAckEvent>(
+            current_time, symbol_, req_client_order_id, std::move(cancelled_orders)
+    );
+
+    StreamId stream_id = _order_stream_id(req_trader_id, req_client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::MassCancelLimitOrderAckEvent, req_trader_id), stream_id, ack_event);
+    publish_wrapper(_generic_topic(TraderTopic::MassCancelLimitOrderAckEvent), stream_id, ack_event); // Generic
 }
 
 void EventModelExchangeAdapter::_on_trade(
@@ -824,20 +1430,19 @@ void EventModelExchangeAdapter::_on_trade(
     // Taker side is implicitly opposite of maker, or can be derived from taker_ex_side if needed by event.
     // ModelEvents::TradeEvent uses maker_side.
 
-    auto trade_event = std::make_shared<const ModelEvents::TradeEvent>(
+    auto trade_event = ModelEvents::make_event<ModelEvents::TradeEvent>(
             current_time, symbol_, maker_client_id, taker_client_id, maker_xid, taker_xid,
             price, qty, maker_model_side, maker_exhausted
     );
 
-    std::string maker_stream_id_str = _format_stream_id(maker_trader_id, maker_client_id);
-    std::string taker_stream_id_str = _format_stream_id(taker_trader_id, taker_client_id);
+    StreamId maker_stream_id = _order_stream_id(maker_trader_id, maker_client_id);
+    StreamId taker_stream_id = _order_stream_id(taker_trader_id, taker_client_id);
 
-    std::string trade_topic = std::string("TradeEvent.") + symbol_;
     // Publish on maker's stream
-    publish_wrapper(trade_topic, maker_stream_id_str, trade_event);
+    publish_wrapper(trade_topic_id_, maker_stream_id, trade_event);
     // Publish on taker's stream if different (to avoid duplicate delivery if self-trade or same stream concept)
     if (maker_trader_id != taker_trader_id || maker_client_id != taker_client_id) { // Basic check for self-trade
-        publish_wrapper(trade_topic, taker_stream_id_str, trade_event);
+        publish_wrapper(trade_topic_id_, taker_stream_id, trade_event);
     }
 }
 
@@ -866,12 +1471,14 @@ void update_partial_fill_state(
     } else {
         out_avg_price = 0.0; // Or some indicator of no fills yet
     }
-     LogMessage(LogLevel::DEBUG, logger_source, "PartialFill Update for XID " + std::to_string(xid) +
-                                             ": SegmentQty=" + std::to_string(qty_filled_this_segment) +
-                                             ", SegmentPrice=" + std::to_string(price_this_segment) +
-                                             ", CumulativeQty=" + std::to_string(out_cumulative_qty) +
-                                             ", CumulativeValue=" + std::to_string(state.cumulative_value_filled) +
-                                             ", AvgPrice=" + std::to_string(out_avg_price));
+    if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+        LogMessage(LogLevel::DEBUG, logger_source, "PartialFill Update for XID " + std::to_string(xid) +
+                                                ": SegmentQty=" + std::to_string(qty_filled_this_segment) +
+                                                ", SegmentPrice=" + std::to_string(price_this_segment) +
+                                                ", CumulativeQty=" + std::to_string(out_cumulative_qty) +
+                                                ", CumulativeValue=" + std::to_string(state.cumulative_value_filled) +
+                                                ", AvgPrice=" + std::to_string(out_avg_price));
+    }
 }
 
 
@@ -889,18 +1496,18 @@ void EventModelExchangeAdapter::_on_maker_partial_fill_limit(
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "MakerPartialFillLimit: Could not get current details for XID " + std::to_string(maker_xid) + " to find leaves_qty. Assuming 0 if not found (order might be gone).");
     }
 
-    PartialFillState& state = partial_fill_tracker_[maker_xid]; // Creates if not exists
+    PartialFillState& state = _fill_state(maker_xid);
     AveragePriceType avg_price_so_far;
     QuantityType cumulative_qty_filled_so_far;
     update_partial_fill_state(maker_xid, price, qty_filled_this_segment, state, avg_price_so_far, cumulative_qty_filled_so_far, this->get_logger_source());
 
-    auto fill_event = std::make_shared<const ModelEvents::PartialFillLimitOrderEvent>(
+    auto fill_event = ModelEvents::make_event<ModelEvents::PartialFillLimitOrderEvent>(
             current_time, maker_xid, client_order_id, model_side, price, qty_filled_this_segment, current_time, symbol_, true, /*is_maker*/
             leaves_qty, cumulative_qty_filled_so_far, avg_price_so_far
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("PartialFillLimitOrderEvent", trader_id), stream_id_str, fill_event);
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::PartialFillLimitOrderEvent, trader_id), stream_id, fill_event);
 }
 
 void EventModelExchangeAdapter::_on_taker_partial_fill_limit(
@@ -911,18 +1518,18 @@ void EventModelExchangeAdapter::_on_taker_partial_fill_limit(
 
     // Taker XID can be a persistent XID (if limit order rested then became aggressive)
     // or a transient XID (if limit order was immediately aggressive or for market orders).
-    PartialFillState& state = partial_fill_tracker_[taker_xid]; // Creates if not exists
+    PartialFillState& state = _fill_state(taker_xid);
     AveragePriceType avg_price_so_far;
     QuantityType cumulative_qty_filled_so_far;
     update_partial_fill_state(taker_xid, price, qty_filled_this_segment, state, avg_price_so_far, cumulative_qty_filled_so_far, this->get_logger_source());
 
-    auto fill_event = std::make_shared<const ModelEvents::PartialFillLimitOrderEvent>(
+    auto fill_event = ModelEvents::make_event<ModelEvents::PartialFillLimitOrderEvent>(
             current_time, taker_xid, client_order_id, model_side, price, qty_filled_this_segment, current_time, symbol_, false, /*is_maker=false*/
             leaves_qty_on_taker_order, cumulative_qty_filled_so_far, avg_price_so_far
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("PartialFillLimitOrderEvent", trader_id), stream_id_str, fill_event);
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::PartialFillLimitOrderEvent, trader_id), stream_id, fill_event);
 }
 
 void EventModelExchangeAdapter::_on_maker_full_fill_limit(
@@ -933,12 +1540,11 @@ void EventModelExchangeAdapter::_on_maker_full_fill_limit(
 
     AveragePriceType final_avg_price;
     QuantityType final_cumulative_qty;
-    // If there were prior partial fills, their state is in partial_fill_tracker_.
+    // If there were prior partial fills, their state is in the order's record.
     // The 'total_qty_filled_for_maker' is the *total for this order*, not this segment.
     // The 'price' is the price of the *last segment* that caused full fill.
-    auto it = partial_fill_tracker_.find(maker_xid);
-    if (it != partial_fill_tracker_.end()) {
-        PartialFillState& state = it->second;
+    if (PartialFillState* fill_state = _find_fill_state(maker_xid)) {
+        PartialFillState& state = *fill_state;
         // The qty_filled_this_segment that leads to full fill: total_qty_filled_for_maker - state.cumulative_qty_filled
         QuantityType last_segment_qty = total_qty_filled_for_maker - state.cumulative_qty_filled;
         if (last_segment_qty < 0) { // Should not happen if logic is correct
@@ -956,23 +1562,25 @@ void EventModelExchangeAdapter::_on_maker_full_fill_limit(
     } else { // No prior partial fills, this full fill is from one go.
         final_cumulative_qty = total_qty_filled_for_maker;
         final_avg_price = static_cast<AveragePriceType>(price); // If single fill, avg price is the fill price
-         LogMessage(LogLevel::DEBUG, this->get_logger_source(), "MakerFullFillLimit (no prior partials) for XID " + std::to_string(maker_xid) +
-                                                             ": TotalQty=" + std::to_string(final_cumulative_qty) +
-                                                             ", Price=" + std::to_string(price));
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "MakerFullFillLimit (no prior partials) for XID " + std::to_string(maker_xid) +
+                                                                ": TotalQty=" + std::to_string(final_cumulative_qty) +
+                                                                ", Price=" + std::to_string(price));
+        }
     }
 
 
-    auto fill_event = std::make_shared<const ModelEvents::FullFillLimitOrderEvent>(
+    auto fill_event = ModelEvents::make_event<ModelEvents::FullFillLimitOrderEvent>(
             current_time, maker_xid, client_order_id, model_side, price, total_qty_filled_for_maker, /* This is total qty of order */
             current_time, symbol_, true, /*is_maker*/
             final_avg_price
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("FullFillLimitOrderEvent", trader_id), stream_id_str, fill_event);
-    publish_wrapper("FullFillLimitOrderEvent", stream_id_str, fill_event); // Generic
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::FullFillLimitOrderEvent, trader_id), stream_id, fill_event);
+    publish_wrapper(_generic_topic(TraderTopic::FullFillLimitOrderEvent), stream_id, fill_event); // Generic
 
-    _remove_order_mapping(maker_xid); // Clears main maps and partial_fill_tracker_
+    _remove_order_mapping(maker_xid); // Clears the mapping and partial fill state
 }
 
 void EventModelExchangeAdapter::_on_taker_full_fill_limit(
@@ -984,9 +1592,8 @@ void EventModelExchangeAdapter::_on_taker_full_fill_limit(
     AveragePriceType final_avg_price;
     QuantityType final_cumulative_qty;
 
-    auto it = partial_fill_tracker_.find(taker_xid);
-    if (it != partial_fill_tracker_.end()) {
-        PartialFillState& state = it->second;
+    if (PartialFillState* fill_state = _find_fill_state(taker_xid)) {
+        PartialFillState& state = *fill_state;
         QuantityType last_segment_qty = total_qty_filled_for_taker - state.cumulative_qty_filled;
          if (last_segment_qty < 0) {
              LogMessage(LogLevel::ERROR, this->get_logger_source(), "TakerFullFillLimit: Negative last_segment_qty for XID " + std::to_string(taker_xid) + ". total_qty=" + std::to_string(total_qty_filled_for_taker) + ", prev_cum_qty=" + std::to_string(state.cumulative_qty_filled));
@@ -1001,30 +1608,31 @@ void EventModelExchangeAdapter::_on_taker_full_fill_limit(
     } else {
         final_cumulative_qty = total_qty_filled_for_taker;
         final_avg_price = static_cast<AveragePriceType>(price);
-         LogMessage(LogLevel::DEBUG, this->get_logger_source(), "TakerFullFillLimit (no prior partials) for XID " + std::to_string(taker_xid) +
-                                                             ": TotalQty=" + std::to_string(final_cumulative_qty) +
-                                                             ", Price=" + std::to_string(price));
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "TakerFullFillLimit (no prior partials) for XID " + std::to_string(taker_xid) +
+                                                                ": TotalQty=" + std::to_string(final_cumulative_qty) +
+                                                                ", Price=" + std::to_string(price));
+        }
     }
 
-    auto fill_event = std::make_shared<const ModelEvents::FullFillLimitOrderEvent>(
+    auto fill_event = ModelEvents::make_event<ModelEvents::FullFillLimitOrderEvent>(
             current_time, taker_xid, client_order_id, model_side, price, total_qty_filled_for_taker,
             current_time, symbol_, false, /*is_maker=false*/
             final_avg_price
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("FullFillLimitOrderEvent", trader_id), stream_id_str, fill_event);
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::FullFillLimitOrderEvent, trader_id), stream_id, fill_event);
 
     // Publish generic event only if the taker_xid is persistent (not transient from market_order range)
     // This check might be too simple; need a robust way to identify transient IDs if they come from different counters.
     // Assuming transient IDs are large, persistent (resting) IDs are smaller.
-    // Or, more reliably, check if it was in `order_type_map_` as `LIMIT`.
+    // Or, more reliably, check if it is mapped as `LIMIT`.
     // For now, using the provided assert check philosophy.
     assert(taker_xid != ID_DEFAULT && "Taker XID for limit full fill should not be ID_DEFAULT");
     if (taker_xid != ID_DEFAULT) { // Also implies it was a mapped order or should have been
-        auto order_type_it = order_type_map_.find(taker_xid);
-        if (order_type_it != order_type_map_.end() && order_type_it->second == MappedOrderType::LIMIT) {
-            publish_wrapper("FullFillLimitOrderEvent", stream_id_str, fill_event);
+        if (_mapped_order_type(taker_xid) == MappedOrderType::LIMIT) {
+            publish_wrapper(_generic_topic(TraderTopic::FullFillLimitOrderEvent), stream_id, fill_event);
         }
         _remove_order_mapping(taker_xid);
     } else {
@@ -1052,18 +1660,18 @@ void EventModelExchangeAdapter::_on_taker_partial_fill_market(
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
     ModelEvents::Side model_side = _to_model_side(taker_ex_side);
 
-    PartialFillState& state = partial_fill_tracker_[taker_xid]; // Market order XID
+    PartialFillState& state = _fill_state(taker_xid); // Market order XID
     AveragePriceType avg_price_so_far;
     QuantityType cumulative_qty_filled_so_far;
     update_partial_fill_state(taker_xid, price, qty_filled_this_segment, state, avg_price_so_far, cumulative_qty_filled_so_far, this->get_logger_source());
 
-    auto fill_event = std::make_shared<const ModelEvents::PartialFillMarketOrderEvent>(
+    auto fill_event = ModelEvents::make_event<ModelEvents::PartialFillMarketOrderEvent>(
             current_time, taker_xid, client_order_id, model_side, price, qty_filled_this_segment, current_time, symbol_, false, /*is_maker=false*/
             leaves_qty_on_taker_order, cumulative_qty_filled_so_far, avg_price_so_far
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("PartialFillMarketOrderEvent", trader_id), stream_id_str, fill_event);
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::PartialFillMarketOrderEvent, trader_id), stream_id, fill_event);
 }
 
 void EventModelExchangeAdapter::_on_maker_full_fill_market(
@@ -1082,9 +1690,8 @@ void EventModelExchangeAdapter::_on_taker_full_fill_market(
     AveragePriceType final_avg_price;
     QuantityType final_cumulative_qty;
 
-    auto it = partial_fill_tracker_.find(taker_xid);
-    if (it != partial_fill_tracker_.end()) {
-        PartialFillState& state = it->second;
+    if (PartialFillState* fill_state = _find_fill_state(taker_xid)) {
+        PartialFillState& state = *fill_state;
         QuantityType last_segment_qty = total_qty_filled_for_taker - state.cumulative_qty_filled;
          if (last_segment_qty < 0) {
              LogMessage(LogLevel::ERROR, this->get_logger_source(), "TakerFullFillMarket: Negative last_segment_qty for XID " + std::to_string(taker_xid) + ". total_qty=" + std::to_string(total_qty_filled_for_taker) + ", prev_cum_qty=" + std::to_string(state.cumulative_qty_filled));
@@ -1099,19 +1706,21 @@ void EventModelExchangeAdapter::_on_taker_full_fill_market(
     } else {
         final_cumulative_qty = total_qty_filled_for_taker;
         final_avg_price = static_cast<AveragePriceType>(price);
-         LogMessage(LogLevel::DEBUG, this->get_logger_source(), "TakerFullFillMarket (no prior partials) for XID " + std::to_string(taker_xid) +
-                                                             ": TotalQty=" + std::to_string(final_cumulative_qty) +
-                                                             ", Price=" + std::to_string(price));
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "TakerFullFillMarket (no prior partials) for XID " + std::to_string(taker_xid) +
+                                                                ": TotalQty=" + std::to_string(final_cumulative_qty) +
+                                                                ", Price=" + std::to_string(price));
+        }
     }
 
-    auto fill_event = std::make_shared<const ModelEvents::FullFillMarketOrderEvent>(
+    auto fill_event = ModelEvents::make_event<ModelEvents::FullFillMarketOrderEvent>(
             current_time, taker_xid, client_order_id, model_side, price, total_qty_filled_for_taker,
             current_time, symbol_, false, /*is_maker=false*/
             final_avg_price
     );
 
-    std::string stream_id_str = _format_stream_id(trader_id, client_order_id);
-    publish_wrapper(_format_topic_for_trader("FullFillMarketOrderEvent", trader_id), stream_id_str, fill_event);
+    StreamId stream_id = _order_stream_id(trader_id, client_order_id);
+    publish_wrapper(_trader_topic(TraderTopic::FullFillMarketOrderEvent, trader_id), stream_id, fill_event);
 
     // Market orders use transient XIDs that are mapped via (trader_id, client_order_id)
     // So, we should find the original mapped XID to remove.
@@ -1126,6 +1735,87 @@ void EventModelExchangeAdapter::_on_taker_full_fill_market(
     }
 }
 
+void EventModelExchangeAdapter::_on_execution_report(const ExecutionReport& report) {
+    Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
+    ExchangeSide maker_ex_side = (report.side_ == ExchangeSide::BID) ? ExchangeSide::ASK : ExchangeSide::BID;
+    ModelEvents::Side maker_model_side = _to_model_side(maker_ex_side);
+
+    StreamId stream_id = _order_stream_id(report.trader_id_, report.client_order_id_);
+
+    double value_filled = 0.0;
+    for (const MatchFill& fill : report.fills_) {
+        AgentId maker_trader_id = fill.maker_owner_.trader_id_;
+        ClientOrderIdType maker_client_id = fill.maker_owner_.client_order_id_;
+
+        // One trade per maker fill, on both sides' streams as in the per-fill path.
+        auto trade_event = ModelEvents::make_event<ModelEvents::TradeEvent>(
+                current_time, symbol_, maker_client_id, report.client_order_id_, fill.uoid_maker_, report.order_id_,
+                fill.price_, fill.quantity_, maker_model_side, fill.exhausted_
+        );
+        publish_wrapper(trade_topic_id_, _order_stream_id(maker_trader_id, maker_client_id), trade_event);
+        if (maker_trader_id != report.trader_id_ || maker_client_id != report.client_order_id_) {
+            publish_wrapper(trade_topic_id_, stream_id, trade_event);
+        }
+
+        if (fill.exhausted_) {
+            _on_maker_full_fill_limit(fill.uoid_maker_, fill.price_, fill.quantity_, maker_ex_side, maker_trader_id, maker_client_id);
+        } else {
+            _on_maker_partial_fill_limit(fill.uoid_maker_, fill.price_, fill.quantity_, maker_ex_side, maker_trader_id, maker_client_id);
+        }
+        value_filled += static_cast<double>(fill.price_) * fill.quantity_;
+    }
+
+    // One taker event for the whole sweep. A resting limit remainder keeps accumulating under the same XID as a maker.
+    ModelEvents::Side taker_model_side = _to_model_side(report.side_);
+    ExchangePriceType last_price = report.fills_.back().price_;
+    QuantityType leaves_qty = std::max<QuantityType>(0, report.requested_quantity_ - report.filled_quantity_);
+    PartialFillState& state = _fill_state(report.order_id_);
+    state.cumulative_qty_filled += report.filled_quantity_;
+    state.cumulative_value_filled += value_filled;
+    AveragePriceType avg_price = state.cumulative_value_filled / static_cast<double>(state.cumulative_qty_filled);
+
+    if (leaves_qty > 0) {
+        if (report.market_) {
+            auto fill_event = ModelEvents::make_event<ModelEvents::PartialFillMarketOrderEvent>(
+                    current_time, report.order_id_, report.client_order_id_, taker_model_side, last_price, report.filled_quantity_,
+                    current_time, symbol_, false, /*is_maker=false*/
+                    leaves_qty, state.cumulative_qty_filled, avg_price
+            );
+            publish_wrapper(_trader_topic(TraderTopic::PartialFillMarketOrderEvent, report.trader_id_), stream_id, fill_event);
+            // An unfilled market remainder is dropped, so this is the order's last report
+            _clear_fill_state(report.order_id_);
+        } else {
+            auto fill_event = ModelEvents::make_event<ModelEvents::PartialFillLimitOrderEvent>(
+                    current_time, report.order_id_, report.client_order_id_, taker_model_side, last_price, report.filled_quantity_,
+                    current_time, symbol_, false, /*is_maker=false*/
+                    leaves_qty, state.cumulative_qty_filled, avg_price
+            );
+            publish_wrapper(_trader_topic(TraderTopic::PartialFillLimitOrderEvent, report.trader_id_), stream_id, fill_event);
+        }
+        return;
+    }
+
+    if (report.market_) {
+        auto fill_event = ModelEvents::make_event<ModelEvents::FullFillMarketOrderEvent>(
+                current_time, report.order_id_, report.client_order_id_, taker_model_side, last_price, report.requested_quantity_,
+                current_time, symbol_, false, /*is_maker=false*/
+                avg_price
+        );
+        publish_wrapper(_trader_topic(TraderTopic::FullFillMarketOrderEvent, report.trader_id_), stream_id, fill_event);
+    } else {
+        auto fill_event = ModelEvents::make_event<ModelEvents::FullFillLimitOrderEvent>(
+                current_time, report.order_id_, report.client_order_id_, taker_model_side, last_price, report.requested_quantity_,
+                current_time, symbol_, false, /*is_maker=false*/
+                avg_price
+        );
+        publish_wrapper(_trader_topic(TraderTopic::FullFillLimitOrderEvent, report.trader_id_), stream_id, fill_event);
+        if (_mapped_order_type(report.order_id_) == MappedOrderType::LIMIT) {
+            publish_wrapper(_generic_topic(TraderTopic::FullFillLimitOrderEvent), stream_id, fill_event);
+        }
+    }
+    _remove_order_mapping(report.order_id_); // Clears the mapping and partial fill state
+}
+
 void EventModelExchangeAdapter::_on_order_book_snapshot(const std::vector<L2_DATA_TYPE>& bids_flat, const std::vector<L2_DATA_TYPE>& asks_flat) {
     if (!auto_publish_orderbook_ || !this->bus_) return;
 
@@ -1143,23 +1833,102 @@ void EventModelExchangeAdapter::_on_order_book_snapshot(const std::vector<L2_DAT
 
     bool bids_changed = !last_published_bids_l2_ || (*last_published_bids_l2_ != current_bids_level);
     bool asks_changed = !last_published_asks_l2_ || (*last_published_asks_l2_ != current_asks_level);
-    Timestamp current_time = this->bus_->get_current_time();
 
     if (bids_changed || asks_changed) {
-        last_published_bids_l2_ = current_bids_level;
-        last_published_asks_l2_ = current_asks_level;
+        last_published_bids_l2_ = std::move(current_bids_level);
+        last_published_asks_l2_ = std::move(current_asks_level);
+        _publish_l2_update(true);
+    } else if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "L2 snapshot unchanged for " + symbol_ + ", not publishing.");
+    }
+}
 
-        auto ob_event = std::make_shared<const ModelEvents::LTwoOrderBookEvent>(
-                current_time, symbol_, current_time, current_time, // ModelEvent expects created_ts, symbol, exchange_ts, ingress_ts
-                current_bids_level,
-                current_asks_level
-        );
+void EventModelExchangeAdapter::_apply_book_changes() {
+    // A depth-limited delta feed is diffed against what it last showed instead.
+    bool track_deltas = l2_publish_mode_ != L2PublishMode::SNAPSHOT && l2_publish_policy_.max_depth == 0;
+    for (const LevelChange& change : exchange_.get_book_changes()) {
+        bool bid = change.side_ == ExchangeSide::BID;
+        if (!_apply_level_change(bid ? *last_published_bids_l2_ : *last_published_asks_l2_, change.price_, change.new_quantity_, bid)) {
+            continue;
+        }
+        l2_changes_pending_ = true;
+        if (track_deltas) {
+            _record_delta_level(bid ? delta_bids_l2_ : delta_asks_l2_, change.price_, change.new_quantity_, bid);
+        }
+    }
+    exchange_.clear_book_changes();
+}
 
-        std::string stream_id_str = "l2_stream_" + symbol_;
-        publish_wrapper(std::string("LTwoOrderBookEvent.") + symbol_, stream_id_str, ob_event);
-        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Published updated L2 snapshot for " + symbol_);
+void EventModelExchangeAdapter::_publish_l2_if_due() {
+    if (!_l2_view_changed()) {
+        l2_changes_pending_ = false;
+        if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+            LogMessage(LogLevel::DEBUG, this->get_logger_source(), "L2 view unchanged for " + symbol_ + ", not publishing.");
+        }
+        return;
+    }
+    Timestamp current_time = this->bus_->get_current_time();
+    if (l2_publish_policy_.min_interval > Duration::zero() && last_l2_publish_time_ &&
+        current_time < *last_l2_publish_time_ + l2_publish_policy_.min_interval) {
+        _schedule_l2_wakeup(); // Conflated: goes out at the end of the window
+        return;
+    }
+    _publish_l2_update(false);
+}
+
+void EventModelExchangeAdapter::_publish_l2_update(bool full_book) {
+    if (l2_publish_mode_ != L2PublishMode::DELTA) {
+        _publish_last_l2_snapshot();
+    }
+    if (l2_publish_mode_ != L2PublishMode::SNAPSHOT) {
+        _publish_l2_delta(full_book);
+    }
+    l2_changes_pending_ = false;
+    last_l2_publish_time_ = this->bus_->get_current_time();
+    if (l2_publish_policy_.max_depth != 0) {
+        published_bids_l2_ = _l2_view(*last_published_bids_l2_);
+        published_asks_l2_ = _l2_view(*last_published_asks_l2_);
+    }
+    published_best_bid_ = _best_level(*last_published_bids_l2_);
+    published_best_ask_ = _best_level(*last_published_asks_l2_);
+}
+
+void EventModelExchangeAdapter::_publish_l2_delta(bool full_book) {
+    bool snapshot = full_book || (l2_snapshot_interval_ != 0 && l2_deltas_since_snapshot_ >= l2_snapshot_interval_);
+    Timestamp current_time = this->bus_->get_current_time();
+    std::shared_ptr<const ModelEvents::LTwoDeltaEvent> delta_event;
+    if (snapshot) {
+        delta_event = ModelEvents::make_event<ModelEvents::LTwoDeltaEvent>(
+                current_time, symbol_, current_time, current_time, ++l2_sequence_, true,
+                _l2_view(*last_published_bids_l2_), _l2_view(*last_published_asks_l2_));
+        l2_deltas_since_snapshot_ = 0;
     } else {
-        LogMessage(LogLevel::INFO, this->get_logger_source(), "L2 snapshot unchanged for " + symbol_ + ", not publishing."); // Changed to TRACE for less noise
+        if (l2_publish_policy_.max_depth != 0) {
+            _diff_levels(published_bids_l2_, _l2_view(*last_published_bids_l2_), true, delta_bids_l2_);
+            _diff_levels(published_asks_l2_, _l2_view(*last_published_asks_l2_), false, delta_asks_l2_);
+        }
+        delta_event = ModelEvents::make_event<ModelEvents::LTwoDeltaEvent>(
+                current_time, symbol_, current_time, current_time, ++l2_sequence_, false,
+                std::move(delta_bids_l2_), std::move(delta_asks_l2_));
+        ++l2_deltas_since_snapshot_;
+    }
+    delta_bids_l2_.clear();
+    delta_asks_l2_.clear();
+
+    publish_wrapper(l2_delta_topic_id_, l2_stream_id_, delta_event);
+}
+
+void EventModelExchangeAdapter::_publish_last_l2_snapshot() {
+    Timestamp current_time = this->bus_->get_current_time();
+    auto ob_event = ModelEvents::make_event<ModelEvents::LTwoOrderBookEvent>(
+            current_time, symbol_, current_time, current_time, // ModelEvent expects created_ts, symbol, exchange_ts, ingress_ts
+            _l2_view(*last_published_bids_l2_),
+            _l2_view(*last_published_asks_l2_)
+    );
+
+    publish_wrapper(l2_topic_id_, l2_stream_id_, ob_event);
+    if (LoggerConfig::G_CURRENT_LOG_LEVEL <= LogLevel::DEBUG) {
+        LogMessage(LogLevel::DEBUG, this->get_logger_source(), "Published updated L2 snapshot for " + symbol_);
     }
 }
 
@@ -1171,33 +1940,29 @@ void EventModelExchangeAdapter::_on_acknowledge_trigger_expiration(
     Duration timeout_duration = std::chrono::microseconds(timeout_us_rep);
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
 
-    auto ack_event = std::make_shared<const ModelEvents::AckTriggerExpiredLimitOrderEvent>(
+    auto ack_event = ModelEvents::make_event<ModelEvents::AckTriggerExpiredLimitOrderEvent>(
             current_time, symbol_, xid, original_placer_client_order_id, price, qty_expired, timeout_duration
     );
 
-    std::string stream_id_str = _format_stream_id(original_placer_trader_id, original_placer_client_order_id);
+    StreamId stream_id = _order_stream_id(original_placer_trader_id, original_placer_client_order_id);
 
-    AgentId expiration_trigger_sender = EventBusSystem::INVALID_AGENT_ID;
-    auto it_sender = expiration_trigger_sender_map_.find(xid);
-    if (it_sender != expiration_trigger_sender_map_.end()) {
-        expiration_trigger_sender = it_sender->second;
-        expiration_trigger_sender_map_.erase(it_sender); // Clean up map entry
-    } else {
+    AgentId expiration_trigger_sender = _take_expiration_trigger_sender(xid);
+    if (expiration_trigger_sender == EventBusSystem::INVALID_AGENT_ID && !exchange_.expiry_enabled()) { // Exchange-side expiries have no trigger sender
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "Could not find expiration trigger sender for XID " + std::to_string(xid) + ". Ack will not be specifically targeted to trigger sender.");
     }
 
     // Publish to the agent that triggered the expiration check (e.g., CancelFairy)
     if (expiration_trigger_sender != EventBusSystem::INVALID_AGENT_ID) {
-         publish_wrapper(_format_topic_for_trader("AckTriggerExpiredLimitOrderEvent", expiration_trigger_sender), stream_id_str, ack_event);
+         publish_wrapper(_trader_topic(TraderTopic::AckTriggerExpiredLimitOrderEvent, expiration_trigger_sender), stream_id, ack_event);
     }
 
     // Publish to the original placer of the order, if different from trigger sender
     if (original_placer_trader_id != expiration_trigger_sender && original_placer_trader_id != EventBusSystem::INVALID_AGENT_ID) {
-        publish_wrapper(_format_topic_for_trader("AckTriggerExpiredLimitOrderEvent", original_placer_trader_id), stream_id_str, ack_event);
+        publish_wrapper(_trader_topic(TraderTopic::AckTriggerExpiredLimitOrderEvent, original_placer_trader_id), stream_id, ack_event);
     }
 
     // Publish to a generic topic as well
-    publish_wrapper("AckTriggerExpiredLimitOrderEvent", stream_id_str, ack_event);
+    publish_wrapper(_generic_topic(TraderTopic::AckTriggerExpiredLimitOrderEvent), stream_id, ack_event);
 
 
     _remove_order_mapping(xid); // Order is gone
@@ -1209,24 +1974,20 @@ void EventModelExchangeAdapter::_on_reject_trigger_expiration(
     Timestamp current_time = this->bus_ ? this->bus_->get_current_time() : Timestamp{};
     Duration original_timeout_duration = std::chrono::microseconds(timeout_us_rep);
 
-    auto reject_event = std::make_shared<const ModelEvents::RejectTriggerExpiredLimitOrderEvent>(
+    auto reject_event = ModelEvents::make_event<ModelEvents::RejectTriggerExpiredLimitOrderEvent>(
             current_time, symbol_, xid, original_timeout_duration
     );
 
-    std::string stream_id_str = _format_stream_id(original_placer_trader_id, original_placer_client_order_id);
+    StreamId stream_id = _order_stream_id(original_placer_trader_id, original_placer_client_order_id);
 
-    AgentId expiration_trigger_sender = EventBusSystem::INVALID_AGENT_ID;
-    auto it_sender = expiration_trigger_sender_map_.find(xid);
-    if (it_sender != expiration_trigger_sender_map_.end()) {
-        expiration_trigger_sender = it_sender->second;
-        expiration_trigger_sender_map_.erase(it_sender); // Clean up map entry
-    } else {
+    AgentId expiration_trigger_sender = _take_expiration_trigger_sender(xid);
+    if (expiration_trigger_sender == EventBusSystem::INVALID_AGENT_ID) {
         LogMessage(LogLevel::WARNING, this->get_logger_source(), "Could not find expiration trigger sender for XID " + std::to_string(xid) + ". Reject will not be specifically targeted to trigger sender.");
     }
 
     // Publish to the agent that triggered the expiration check
     if (expiration_trigger_sender != EventBusSystem::INVALID_AGENT_ID) {
-        publish_wrapper(_format_topic_for_trader("RejectTriggerExpiredLimitOrderEvent", expiration_trigger_sender), stream_id_str, reject_event);
+        publish_wrapper(_trader_topic(TraderTopic::RejectTriggerExpiredLimitOrderEvent, expiration_trigger_sender), stream_id, reject_event);
     }
     // No need to publish to original placer for reject of expiration trigger usually, unless specified.
     // Generic publish can also be considered.
@@ -5,15 +5,19 @@
 #include "Globals.h"
 #include "OrderBookCore.h"
 #include "Model.h"
+#include "TimingWheel.h"
 
 #include <functional>
 #include <vector>
 #include <string>
 #include <optional>
-#include <unordered_map>
+#include <span>
+#include <istream>
+#include <ostream>
 #include <utility> // For std::pair
 #include <stdexcept> // For std::runtime_error
 #include <algorithm> // For std::min
+#include <type_traits>
 
 
 typedef PRICE_SIZE_TYPE L2_DATA_TYPE; // From Globals.h
@@ -21,25 +25,58 @@ typedef PRICE_SIZE_TYPE L2_DATA_TYPE; // From Globals.h
 using AgentId = EventBusSystem::AgentId; // From Model.h -> EventBus.h
 using ClientOrderIdType = ModelEvents::ClientOrderIdType; // From Model.h
 
+static_assert(sizeof(AgentId) <= sizeof(OrderOwner::trader_id_) && sizeof(ClientOrderIdType) <= sizeof(OrderOwner::client_order_id_),
+              "OrderOwner must be able to carry AgentId and ClientOrderIdType.");
 
-class ExchangeServer {
-public:
-    ExchangeServer() {
-        // Callbacks are std::function, default constructed to empty.
-    }
-    ~ExchangeServer() = default;
 
-    // Callback Signatures (no change to signatures themselves, only internal logic might be affected by renaming counter)
+// One order removed by ExchangeServer::mass_cancel_orders; `client_order_id_` is the ID the owner gave the order itself.
+struct CancelledOrder {
+    ID_TYPE order_id_;
+    SIDE side_;
+    PRICE_TYPE price_;
+    SIZE_TYPE quantity_;
+    ClientOrderIdType client_order_id_;
+};
+
+// One fill of a sweep, as reported by the book's fill sink.
+struct MatchFill {
+    ID_TYPE uoid_maker_;
+    PRICE_TYPE price_;
+    SIZE_TYPE quantity_;
+    bool exhausted_;
+    OrderOwner maker_owner_;
+};
+
+// Everything an incoming order matched, delivered once per order in aggregated mode (see
+// ExchangeServer::set_aggregate_execution_reports). Makers rest on the side opposite `side_`. `fills_` points into
+// the exchange's scratch buffer and is only valid during the callback.
+struct ExecutionReport {
+    ID_TYPE order_id_; // Resting ID if part of the order rested, otherwise its transient taker ID
+    SIDE side_;
+    bool market_;
+    SIZE_TYPE requested_quantity_;
+    SIZE_TYPE filled_quantity_;
+    AgentId trader_id_;
+    ClientOrderIdType client_order_id_;
+    std::span<const MatchFill> fills_;
+};
+
+// Runtime listener: every hook is a std::function that may be left empty. ExchangeServer<> derives from this,
+// so callers assign `exchange.on_trade = ...` as before.
+struct ExchangeCallbacks {
     std::function<void(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType, TIME_TYPE)> on_limit_order_acknowledged;
     std::function<void(SIDE, SIZE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType)> on_market_order_acknowledged;
     std::function<void(ID_TYPE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType)> on_partial_cancel_limit;
     std::function<void(ID_TYPE, AgentId, ClientOrderIdType)> on_partial_cancel_limit_reject;
     std::function<void(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType)> on_full_cancel_limit;
     std::function<void(ID_TYPE, AgentId, ClientOrderIdType)> on_full_cancel_limit_reject;
+    // (cancelled orders, trader, client order ID of the mass-cancel request)
+    std::function<void(const std::vector<CancelledOrder>&, AgentId, ClientOrderIdType)> on_mass_cancel_limit;
     std::function<void(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, bool, AgentId, ClientOrderIdType)> on_order_quantity_modified; // existing, used by modify_order_quantity
     std::function<void(ID_TYPE, const std::string&, AgentId, ClientOrderIdType)> on_order_quantity_modified_rejected;  // existing
-
-    // ... (other modification callbacks, if ever implemented with public methods) ...
+    // (order ID, side, old price, new price, old quantity, new quantity, trader, client order ID)
+    std::function<void(ID_TYPE, SIDE, PRICE_TYPE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType)> on_order_amended;
+    std::function<void(ID_TYPE, const std::string&, AgentId, ClientOrderIdType)> on_order_amend_rejected;
 
     std::function<void(ID_TYPE, SIDE, ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, bool, AgentId, ClientOrderIdType, AgentId, ClientOrderIdType)> on_trade;
 
@@ -52,10 +89,100 @@ public:
     std::function<void(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType)> on_taker_partial_fill_market;
     std::function<void(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType)> on_maker_full_fill_market;
     std::function<void(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType)> on_taker_full_fill_market;
+    // Aggregated mode only: replaces on_trade and the maker/taker fill hooks above for the whole sweep.
+    std::function<void(const ExecutionReport&)> on_execution_report;
 
     std::function<void(const std::vector<L2_DATA_TYPE>&, const std::vector<L2_DATA_TYPE>&)> on_order_book_snapshot;
     std::function<void(ID_TYPE, AgentId, ClientOrderIdType, TIME_TYPE)> on_reject_trigger_expiration;
     std::function<void(ID_TYPE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType, TIME_TYPE)> on_acknowledge_trigger_expiration;
+};
+
+// Static listener: every hook is an empty member function. Derive from it and shadow the hooks you need; the
+// server calls them directly, so they inline and the rest compile away. Argument order matches ExchangeCallbacks.
+struct NullExchangeListener {
+    void on_limit_order_acknowledged(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType, TIME_TYPE) {}
+    void on_market_order_acknowledged(SIDE, SIZE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+    void on_partial_cancel_limit(ID_TYPE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+    void on_partial_cancel_limit_reject(ID_TYPE, AgentId, ClientOrderIdType) {}
+    void on_full_cancel_limit(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType) {}
+    void on_full_cancel_limit_reject(ID_TYPE, AgentId, ClientOrderIdType) {}
+    void on_mass_cancel_limit(const std::vector<CancelledOrder>&, AgentId, ClientOrderIdType) {}
+    void on_order_quantity_modified(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, bool, AgentId, ClientOrderIdType) {}
+    void on_order_quantity_modified_rejected(ID_TYPE, const std::string&, AgentId, ClientOrderIdType) {}
+    void on_order_amended(ID_TYPE, SIDE, PRICE_TYPE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+    void on_order_amend_rejected(ID_TYPE, const std::string&, AgentId, ClientOrderIdType) {}
+
+    void on_trade(ID_TYPE, SIDE, ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, bool, AgentId, ClientOrderIdType, AgentId, ClientOrderIdType) {}
+
+    void on_maker_partial_fill_limit(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType) {}
+    void on_taker_partial_fill_limit(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+    void on_maker_full_fill_limit(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType) {}
+    void on_taker_full_fill_limit(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+
+    void on_maker_partial_fill_market(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType) {}
+    void on_taker_partial_fill_market(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+    void on_maker_full_fill_market(ID_TYPE, PRICE_TYPE, SIZE_TYPE, SIDE, AgentId, ClientOrderIdType) {}
+    void on_taker_full_fill_market(ID_TYPE, SIDE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType) {}
+    void on_execution_report(const ExecutionReport&) {}
+
+    void on_order_book_snapshot(const std::vector<L2_DATA_TYPE>&, const std::vector<L2_DATA_TYPE>&) {}
+    void on_reject_trigger_expiration(ID_TYPE, AgentId, ClientOrderIdType, TIME_TYPE) {}
+    void on_acknowledge_trigger_expiration(ID_TYPE, PRICE_TYPE, SIZE_TYPE, AgentId, ClientOrderIdType, TIME_TYPE) {}
+};
+
+
+// The listener is a base class: either ExchangeCallbacks (default, hooks set at runtime) or a NullExchangeListener
+// derivative whose hooks are resolved at compile time.
+template <typename Listener = ExchangeCallbacks>
+class ExchangeServer : public Listener {
+public:
+    // The book and transient IDs live in ID space `id_space` (see uoid_space_base), so exchanges for different
+    // symbols hand out disjoint order IDs.
+    explicit ExchangeServer(ID_TYPE id_space = 0)
+            : ExchangeServer(id_space, Listener{}) {}
+
+    ExchangeServer(ID_TYPE id_space, Listener listener)
+            : Listener(std::move(listener)),
+              order_book_(id_space),
+              transient_order_id_start_(order_book_.get_uoid_base() + TRANSIENT_ORDER_ID_COUNTER_START_VALUE_),
+              transient_order_id_counter_(transient_order_id_start_) {}
+    ~ExchangeServer() = default;
+
+    // Aggregated mode (off by default): an incoming order's fills go out as one on_execution_report after its ack,
+    // instead of on_trade plus the maker and taker fill hooks per fill.
+    void set_aggregate_execution_reports(bool enabled) { aggregate_execution_reports_ = enabled; }
+    bool aggregate_execution_reports() const { return aggregate_execution_reports_; }
+
+    // Exchange-side expiry (off by default). While enabled, each limit order that rests is put on a timing wheel,
+    // due `timeout_us_rep` after the exchange clock, and advance_time() expires it through cancel_expired_order, so
+    // listeners see the same on_acknowledge_trigger_expiration. Orders gone by then are skipped silently. Enabling
+    // replaces the wheel (dropping pending expiries) with one of resolution `tick`; expiries fire up to a tick late,
+    // so the default fires them exactly when due.
+    void set_expiry_enabled(bool enabled, TIME_TYPE tick = 1) {
+        expiry_enabled_ = enabled;
+        expiry_wheel_ = TimingWheel(tick);
+        expiry_wheel_.reset(current_time_);
+    }
+    bool expiry_enabled() const { return expiry_enabled_; }
+
+    // Resting order IDs count up from uoid_base() + 1, transient taker IDs from transient_order_id_start().
+    ID_TYPE uoid_base() const { return order_book_.get_uoid_base(); }
+    ID_TYPE transient_order_id_start() const { return transient_order_id_start_; }
+
+    // Moves the exchange clock (same units as timeouts) to `now` and expires every order due by then.
+    void advance_time(TIME_TYPE now) {
+        current_time_ = std::max(current_time_, now);
+        expiry_wheel_.advance(current_time_, [this](const TimingWheel::Entry& entry) {
+            if (order_book_.get_order_side(entry.id_)) {
+                cancel_expired_order(entry.id_, entry.timeout_);
+            }
+        });
+    }
+    TIME_TYPE current_time() const { return current_time_; }
+
+    // Exchange time at which advance_time() next expires an order, if any expiry is pending.
+    std::optional<TIME_TYPE> next_expiry_time() const { return expiry_wheel_.next_due_time(); }
+    size_t pending_expiry_count() const { return expiry_wheel_.size(); }
 
 
     ID_TYPE place_limit_order(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity, TIME_TYPE timeout_us_rep,
@@ -63,39 +190,40 @@ public:
         active_taker_metadata_ = std::make_pair(trader_id, client_order_id);
         active_taker_side_ = side;
 
-        // Attempt to match against the book
+        // Attempt to match against the book. Fills are collected into the reused scratch buffer and fanned out
+        // after the ack, which has to go first and already carries the post-sweep resting quantity.
+        fill_scratch_.clear();
         auto result_tuple = order_book_.template limit_match_book_price_quantity<DOUBLEOPTION::FRONT, DOUBLEOPTION::BACK>(
-                side, price, quantity
+                side, price, quantity, OrderOwner{trader_id, client_order_id}, FillCollector{fill_scratch_}
         );
 
         std::optional<std::tuple<ID_TYPE, Price*>> placed_order_info_opt = std::get<0>(result_tuple);
         SIZE_TYPE final_remaining_quantity_on_order = std::get<1>(result_tuple); // Quantity that rested or would rest
-        std::vector<LOBClearResult>& clearings = std::get<2>(result_tuple);
 
         ID_TYPE ack_exchange_order_id_for_callback = ID_DEFAULT; // ID to be reported in LimitOrderAckEvent
         ID_TYPE resting_order_id_if_any = ID_DEFAULT; // Actual ID if any part of the order rests
 
         if (placed_order_info_opt) {
             resting_order_id_if_any = std::get<0>(placed_order_info_opt.value());
-            ack_exchange_order_id_for_callback = resting_order_id_if_any;
-            order_metadata_[resting_order_id_if_any] = {trader_id, client_order_id}; // Map the resting part
+            ack_exchange_order_id_for_callback = resting_order_id_if_any; // Owner of the resting part is kept by the book
         }
         // If placed_order_info_opt is nullopt, it means the order was fully filled as a taker and nothing rested.
         // In this case, ack_exchange_order_id_for_callback remains ID_DEFAULT.
-
-        if (on_limit_order_acknowledged) {
-            on_limit_order_acknowledged(
-                    ack_exchange_order_id_for_callback, // This will be ID_DEFAULT if nothing rested
-                    side,
-                    price,
-                    quantity, // Original requested quantity
-                    final_remaining_quantity_on_order, // Quantity that actually rested (0 if fully aggressive)
-                    trader_id,
-                    client_order_id,
-                    timeout_us_rep
-            );
+        if (expiry_enabled_ && resting_order_id_if_any != ID_DEFAULT) {
+            expiry_wheel_.insert(resting_order_id_if_any, current_time_ + std::max<TIME_TYPE>(timeout_us_rep, 0), timeout_us_rep);
         }
 
+        _notify<&Listener::on_limit_order_acknowledged>(
+                ack_exchange_order_id_for_callback, // This will be ID_DEFAULT if nothing rested
+                side,
+                price,
+                quantity, // Original requested quantity
+                final_remaining_quantity_on_order, // Quantity that actually rested (0 if fully aggressive)
+                trader_id,
+                client_order_id,
+                timeout_us_rep
+        );
+
         SIZE_TYPE original_requested_quantity = quantity;
         SIZE_TYPE total_filled_for_taker = 0;
         PRICE_TYPE last_fill_price = price; // Default to order price, updated by actual fills
@@ -109,41 +237,37 @@ public:
         if (resting_order_id_if_any != ID_DEFAULT) {
             taker_event_id_for_fills = resting_order_id_if_any;
         } else {
-            // Order was fully aggressive, generate a transient ID for its fills.
+            // Order was fully aggressive, generate a transient ID for its fills. Its owner is the active taker.
             taker_event_id_for_fills = transient_order_id_counter_++;
-            order_metadata_[taker_event_id_for_fills] = {trader_id, client_order_id}; // Map this transient ID
+            active_taker_id_ = taker_event_id_for_fills;
         }
         // --- End Transient ID for Taker Fills ---
 
-        for (const auto& clearing : clearings) { // These are fills against resting orders
-            last_fill_price = clearing.price_;
-            for (const auto& trade : clearing.trades_) { // trade.uoid_maker_ is a resting order
-                auto [maker_trader_id, maker_client_id] = _get_trader_client_ids_safe(trade.uoid_maker_);
-                SIDE maker_actual_side = order_book_.get_order_side(trade.uoid_maker_).value_or(SIDE::NONE);
+        if (aggregate_execution_reports_) {
+            total_filled_for_taker = _report_execution(taker_event_id_for_fills, side, false, quantity, trader_id, client_order_id);
+        } else {
+            for (const MatchFill& trade : fill_scratch_) { // These are fills against resting orders
+                last_fill_price = trade.price_;
+                AgentId maker_trader_id = trade.maker_owner_.trader_id_;
+                ClientOrderIdType maker_client_id = trade.maker_owner_.client_order_id_;
+                SIDE maker_actual_side = _opposite_side(side); // Makers always rest on the counter side
                 SIDE taker_actual_side = side; // The side of the incoming limit order
 
-                if (on_trade) {
-                    on_trade(
-                            trade.uoid_maker_, maker_actual_side,
-                            taker_event_id_for_fills, taker_actual_side, // Use the determined taker_event_id
-                            clearing.price_,
-                            trade.quantity_,
-                            trade.exhausted_, // maker_exhausted
-                            maker_trader_id, maker_client_id,
-                            trader_id, client_order_id // Taker's original IDs
-                    );
-                }
+                _notify<&Listener::on_trade>(
+                        trade.uoid_maker_, maker_actual_side,
+                        taker_event_id_for_fills, taker_actual_side, // Use the determined taker_event_id
+                        trade.price_,
+                        trade.quantity_,
+                        trade.exhausted_, // maker_exhausted
+                        maker_trader_id, maker_client_id,
+                        trader_id, client_order_id // Taker's original IDs
+                );
 
                 // Maker side fill callbacks
                 if (trade.exhausted_) {
-                    if (on_maker_full_fill_limit) {
-                        on_maker_full_fill_limit(trade.uoid_maker_, clearing.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
-                    }
-                    _remove_order_metadata_if_exists(trade.uoid_maker_);
+                    _notify<&Listener::on_maker_full_fill_limit>(trade.uoid_maker_, trade.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
                 } else {
-                    if (on_maker_partial_fill_limit) {
-                        on_maker_partial_fill_limit(trade.uoid_maker_, clearing.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
-                    }
+                    _notify<&Listener::on_maker_partial_fill_limit>(trade.uoid_maker_, trade.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
                 }
 
                 SIZE_TYPE new_total_filled_for_taker = total_filled_for_taker + trade.quantity_;
@@ -151,43 +275,29 @@ public:
 
                 // Taker side fill callbacks (for the incoming limit order acting as taker)
                 if (new_total_filled_for_taker < original_requested_quantity) { // Still more to fill for the taker
-                    if (on_taker_partial_fill_limit) {
-                        on_taker_partial_fill_limit(
-                                taker_event_id_for_fills,
-                                side, // Taker's side
-                                clearing.price_,
-                                trade.quantity_, // Quantity filled in this segment for the taker
-                                leaves_qty_on_taker_after_this_segment,
-                                trader_id, client_order_id
-                        );
-                    }
+                    _notify<&Listener::on_taker_partial_fill_limit>(
+                            taker_event_id_for_fills,
+                            side, // Taker's side
+                            trade.price_,
+                            trade.quantity_, // Quantity filled in this segment for the taker
+                            leaves_qty_on_taker_after_this_segment,
+                            trader_id, client_order_id
+                    );
                 }
                 total_filled_for_taker = new_total_filled_for_taker;
             }
-        }
 
-        if (total_filled_for_taker > 0 && total_filled_for_taker >= original_requested_quantity) { // Taker order fully filled
-            if (on_taker_full_fill_limit) {
+            if (total_filled_for_taker > 0 && total_filled_for_taker >= original_requested_quantity) { // Taker order fully filled
                 // Report original_requested_quantity as filled if it met or exceeded request.
                 // This handles cases where book structure might offer more than requested at a price.
                 SIZE_TYPE reported_filled_qty_for_taker = original_requested_quantity;
-                on_taker_full_fill_limit(taker_event_id_for_fills, side, last_fill_price, reported_filled_qty_for_taker, trader_id, client_order_id);
+                _notify<&Listener::on_taker_full_fill_limit>(taker_event_id_for_fills, side, last_fill_price, reported_filled_qty_for_taker, trader_id, client_order_id);
             }
         }
 
-        // Cleanup metadata for transient ID if it was used and the order is now fully resolved
-        // (either fully filled as taker, or any resting part is also gone).
-        if (taker_event_id_for_fills >= TRANSIENT_ORDER_ID_COUNTER_START_VALUE_ && resting_order_id_if_any == ID_DEFAULT) {
-            // If it was a purely aggressive limit order using a transient ID, and it's fully processed.
-             if (total_filled_for_taker >= original_requested_quantity) {
-                _remove_order_metadata_if_exists(taker_event_id_for_fills);
-             }
-        }
-        // If `resting_order_id_if_any` was used for `taker_event_id_for_fills`, its metadata is removed
-        // when the resting part itself is fully filled or cancelled via other callbacks.
-
-        active_taker_metadata_ = std::nullopt;
-        active_taker_side_ = std::nullopt;
+        // If `resting_order_id_if_any` was used for `taker_event_id_for_fills`, its owner lives in the book
+        // and leaves with the resting part when it is fully filled or cancelled. A transient ID is done with here.
+        _clear_active_taker();
 
         return resting_order_id_if_any; // Return the ID if it rested, ID_DEFAULT otherwise
     }
@@ -196,52 +306,46 @@ public:
                                AgentId trader_id = AgentId(0), ClientOrderIdType client_order_id = ClientOrderIdType(0)) {
         // Market orders always get a transient ID.
         ID_TYPE market_order_transient_id = transient_order_id_counter_++;
-        order_metadata_[market_order_transient_id] = {trader_id, client_order_id};
+        active_taker_id_ = market_order_transient_id;
 
         active_taker_metadata_ = {trader_id, client_order_id};
         active_taker_side_ = side;
 
         SIZE_TYPE total_filled_for_taker = 0;
 
-        auto result_tuple = order_book_.template market_match_quantity<DOUBLEOPTION::FRONT>(side, quantity);
-        SIZE_TYPE remaining_quantity_on_market_order = std::get<0>(result_tuple); // Unfilled part of market order
-        std::vector<LOBClearResult>& clearings = std::get<1>(result_tuple);
+        fill_scratch_.clear();
+        SIZE_TYPE remaining_quantity_on_market_order = // Unfilled part of market order
+                order_book_.template market_match_quantity<DOUBLEOPTION::FRONT>(side, quantity, FillCollector{fill_scratch_});
 
         SIZE_TYPE executed_quantity = quantity - remaining_quantity_on_market_order;
 
-        if (on_market_order_acknowledged) {
-            on_market_order_acknowledged(side, quantity, executed_quantity, remaining_quantity_on_market_order, trader_id, client_order_id);
-        }
+        _notify<&Listener::on_market_order_acknowledged>(side, quantity, executed_quantity, remaining_quantity_on_market_order, trader_id, client_order_id);
 
         PRICE_TYPE last_fill_price = PRICE_DEFAULT;
 
-        for (const auto& clearing : clearings) {
-            last_fill_price = clearing.price_;
-            for (const auto& trade : clearing.trades_) {
-                auto [maker_trader_id, maker_client_id] = _get_trader_client_ids_safe(trade.uoid_maker_);
-                SIDE maker_actual_side = order_book_.get_order_side(trade.uoid_maker_).value_or(SIDE::NONE);
+        if (aggregate_execution_reports_) {
+            total_filled_for_taker = _report_execution(market_order_transient_id, side, true, quantity, trader_id, client_order_id);
+        } else {
+            for (const MatchFill& trade : fill_scratch_) {
+                last_fill_price = trade.price_;
+                AgentId maker_trader_id = trade.maker_owner_.trader_id_;
+                ClientOrderIdType maker_client_id = trade.maker_owner_.client_order_id_;
+                SIDE maker_actual_side = _opposite_side(side); // Makers always rest on the counter side
                 SIDE taker_actual_side = side;
 
-                if (on_trade) {
-                    on_trade(
-                            trade.uoid_maker_, maker_actual_side,
-                            market_order_transient_id, taker_actual_side,
-                            clearing.price_, trade.quantity_, trade.exhausted_, // maker_exhausted
-                            maker_trader_id, maker_client_id, trader_id, client_order_id
-                    );
-                }
+                _notify<&Listener::on_trade>(
+                        trade.uoid_maker_, maker_actual_side,
+                        market_order_transient_id, taker_actual_side,
+                        trade.price_, trade.quantity_, trade.exhausted_, // maker_exhausted
+                        maker_trader_id, maker_client_id, trader_id, client_order_id
+                );
 
                 // Maker side (resting order) fill callbacks
                 if (trade.exhausted_) {
                     // Note: ExchangeServer has on_maker_full_fill_market, implies a resting order (limit) was hit by this market order
-                    if (on_maker_full_fill_market) { // Semantically, maker is usually limit, so _market suffix might be confusing
-                        on_maker_full_fill_market(trade.uoid_maker_, clearing.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
-                    }
-                    _remove_order_metadata_if_exists(trade.uoid_maker_);
+                    _notify<&Listener::on_maker_full_fill_market>(trade.uoid_maker_, trade.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
                 } else {
-                    if (on_maker_partial_fill_market) {
-                        on_maker_partial_fill_market(trade.uoid_maker_, clearing.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
-                    }
+                    _notify<&Listener::on_maker_partial_fill_market>(trade.uoid_maker_, trade.price_, trade.quantity_, maker_actual_side, maker_trader_id, maker_client_id);
                 }
 
                 SIZE_TYPE new_total_filled_for_taker = total_filled_for_taker + trade.quantity_;
@@ -249,56 +353,32 @@ public:
 
                 // Taker side (this market order) fill callbacks
                 if (new_total_filled_for_taker < quantity) { // Market order still partially filled
-                    if (on_taker_partial_fill_market) {
-                        on_taker_partial_fill_market(market_order_transient_id, side, clearing.price_, trade.quantity_, leaves_qty_on_taker_after_this_segment, trader_id, client_order_id);
-                    }
+                    _notify<&Listener::on_taker_partial_fill_market>(market_order_transient_id, side, trade.price_, trade.quantity_, leaves_qty_on_taker_after_this_segment, trader_id, client_order_id);
                 }
                 total_filled_for_taker = new_total_filled_for_taker;
             }
-        }
 
-        if (total_filled_for_taker > 0 && total_filled_for_taker >= quantity) { // Market order fully filled
-            if (on_taker_full_fill_market && last_fill_price != PRICE_DEFAULT) { // PRICE_DEFAULT check ensures at least one fill happened
-                on_taker_full_fill_market(market_order_transient_id, side, last_fill_price, quantity, trader_id, client_order_id);
+            if (total_filled_for_taker > 0 && total_filled_for_taker >= quantity) { // Market order fully filled
+                if (last_fill_price != PRICE_DEFAULT) { // PRICE_DEFAULT check ensures at least one fill happened
+                    _notify<&Listener::on_taker_full_fill_market>(market_order_transient_id, side, last_fill_price, quantity, trader_id, client_order_id);
+                }
             }
         }
 
-        // Market order is fully processed (either filled or unfillable part remains after ack).
-        // Metadata for its transient ID is removed here or upon ack processing by adapter.
-        // If MarketOrderAck means it's terminal, then adapter removes. If fills complete it, then here.
-        // Let's assume if it's fully filled (total_filled_for_taker >= quantity) OR if there's an unfillable part (remaining_quantity_on_market_order > 0 from ack),
-        // its lifecycle for fills is over.
-        if (total_filled_for_taker >= quantity || remaining_quantity_on_market_order > 0) {
-            _remove_order_metadata_if_exists(market_order_transient_id);
-        }
-
-        active_taker_metadata_ = std::nullopt;
-        active_taker_side_ = std::nullopt;
+        // Market order is fully processed (either filled or unfillable part remains after ack), so its
+        // transient ID no longer resolves.
+        _clear_active_taker();
         return market_order_transient_id; // Return the transient ID used for this market order
     }
 
     bool cancel_order(ID_TYPE exchange_order_id, AgentId trader_id_req = AgentId(0), ClientOrderIdType client_order_id_req = ClientOrderIdType(0)) {
-        AgentId original_trader_id_of_order = AgentId(0); // Default if not found in metadata
-        // ClientOrderIdType original_client_id_of_order = ClientOrderIdType(0); // Not strictly needed here
-
-        auto meta_it = order_metadata_.find(exchange_order_id);
-        if (meta_it != order_metadata_.end()) {
-            original_trader_id_of_order = meta_it->second.first;
-            // original_client_id_of_order = meta_it->second.second;
-        } else {
-            // If no metadata, it might be a transient ID that was already cleaned up, or an invalid ID.
-            // The cancel will likely fail in OrderBookCore if the ID is not there.
-        }
-
         // The callback should receive the IDs of the *cancel request*, not necessarily the original order's owner.
         AgentId final_trader_id_for_cb = trader_id_req;
         ClientOrderIdType final_client_id_for_cb = client_order_id_req;
 
         std::optional<SIDE> order_side_opt = order_book_.get_order_side(exchange_order_id);
         if (!order_side_opt) {
-            if (on_full_cancel_limit_reject) {
-                on_full_cancel_limit_reject(exchange_order_id, final_trader_id_for_cb, final_client_id_for_cb);
-            }
+            _notify<&Listener::on_full_cancel_limit_reject>(exchange_order_id, final_trader_id_for_cb, final_client_id_for_cb);
             return false; // Indicate call failed to find order to cancel
         }
         SIDE order_side = order_side_opt.value();
@@ -307,32 +387,41 @@ public:
 
         if (result_opt) {
             auto [price, quantity_cancelled] = result_opt.value();
-            order_metadata_.erase(exchange_order_id); // Clean up metadata for the cancelled order
-            if (on_full_cancel_limit) {
-                on_full_cancel_limit(exchange_order_id, price, quantity_cancelled, order_side, final_trader_id_for_cb, final_client_id_for_cb);
-            }
+            _notify<&Listener::on_full_cancel_limit>(exchange_order_id, price, quantity_cancelled, order_side, final_trader_id_for_cb, final_client_id_for_cb);
             return true; // Indicate cancel was successful at core level
         } else {
-            if (on_full_cancel_limit_reject) {
-                on_full_cancel_limit_reject(exchange_order_id, final_trader_id_for_cb, final_client_id_for_cb);
-            }
+            _notify<&Listener::on_full_cancel_limit_reject>(exchange_order_id, final_trader_id_for_cb, final_client_id_for_cb);
             return false; // Indicate cancel failed at core level
         }
     }
 
+    // Cancels every resting order of `trader_id` in one pass over its owner list, optionally only on `side` and
+    // within the inclusive price range [min_price, max_price]. Fires on_mass_cancel_limit once, also when nothing
+    // matched, and returns the cancelled orders.
+    std::vector<CancelledOrder> mass_cancel_orders(AgentId trader_id, std::optional<SIDE> side = std::nullopt,
+                                                   std::optional<PRICE_TYPE> min_price = std::nullopt,
+                                                   std::optional<PRICE_TYPE> max_price = std::nullopt,
+                                                   ClientOrderIdType client_order_id_req = ClientOrderIdType(0)) {
+        std::vector<CancelledOrder> cancelled;
+        order_book_.cancel_orders_of_owner(trader_id, side, min_price, max_price,
+            [&cancelled](ID_TYPE uoid, SIDE order_side, PRICE_TYPE price, SIZE_TYPE quantity, const OrderOwner& owner) {
+                cancelled.push_back({uoid, order_side, price, quantity, ClientOrderIdType(owner.client_order_id_)});
+            });
+        _notify<&Listener::on_mass_cancel_limit>(cancelled, trader_id, client_order_id_req);
+        return cancelled;
+    }
+
     bool cancel_expired_order(ID_TYPE exchange_order_id, TIME_TYPE timeout_us_rep) {
         AgentId original_trader_id = AgentId(0);
         ClientOrderIdType original_client_id = ClientOrderIdType(0);
-        auto meta_it = order_metadata_.find(exchange_order_id);
-        if (meta_it != order_metadata_.end()) {
-            original_trader_id = meta_it->second.first;
-            original_client_id = meta_it->second.second;
+        std::optional<OrderOwner> owner_opt = order_book_.get_order_owner(exchange_order_id);
+        if (owner_opt) {
+            original_trader_id = owner_opt->trader_id_;
+            original_client_id = owner_opt->client_order_id_;
         } else {
-            // Order metadata not found, it might have been filled/cancelled already.
+            // Order not resting any more, it might have been filled/cancelled already.
             // The expiration trigger is "late".
-            if (on_reject_trigger_expiration) {
-                on_reject_trigger_expiration(exchange_order_id, original_trader_id, original_client_id, timeout_us_rep);
-            }
+            _notify<&Listener::on_reject_trigger_expiration>(exchange_order_id, original_trader_id, original_client_id, timeout_us_rep);
             return false; // Indicate call cannot proceed as order metadata is missing
         }
 
@@ -340,34 +429,21 @@ public:
 
         if (result_opt) {
             auto [price, quantity_cancelled] = result_opt.value();
-            order_metadata_.erase(exchange_order_id); // Clean up metadata
-            if (on_acknowledge_trigger_expiration) {
-                on_acknowledge_trigger_expiration(exchange_order_id, price, quantity_cancelled, original_trader_id, original_client_id, timeout_us_rep);
-            }
+            _notify<&Listener::on_acknowledge_trigger_expiration>(exchange_order_id, price, quantity_cancelled, original_trader_id, original_client_id, timeout_us_rep);
             return true;
         } else {
             // Order not found in book (e.g. filled just before expiration)
-            if (on_reject_trigger_expiration) {
-                on_reject_trigger_expiration(exchange_order_id, original_trader_id, original_client_id, timeout_us_rep);
-            }
+            _notify<&Listener::on_reject_trigger_expiration>(exchange_order_id, original_trader_id, original_client_id, timeout_us_rep);
             return false;
         }
     }
 
     bool modify_order_quantity(ID_TYPE exchange_order_id, SIZE_TYPE new_quantity,
                                AgentId trader_id_req = AgentId(0), ClientOrderIdType client_order_id_req = ClientOrderIdType(0)) {
-        AgentId original_trader_id_of_order = AgentId(0);
-        ClientOrderIdType original_client_id_of_order = ClientOrderIdType(0);
-
-        auto meta_it = order_metadata_.find(exchange_order_id);
-        if (meta_it == order_metadata_.end()) {
-            if (on_order_quantity_modified_rejected) {
-                on_order_quantity_modified_rejected(exchange_order_id, "quantity: order not found in metadata", trader_id_req, client_order_id_req);
-            }
+        if (!order_book_.get_order_owner(exchange_order_id)) {
+            _notify<&Listener::on_order_quantity_modified_rejected>(exchange_order_id, "quantity: order not found in metadata", trader_id_req, client_order_id_req);
             return false;
         }
-        original_trader_id_of_order = meta_it->second.first;
-        original_client_id_of_order = meta_it->second.second;
 
         // Callbacks should use the request's IDs
         AgentId final_trader_id_for_cb = trader_id_req;
@@ -380,32 +456,19 @@ public:
         if (result_opt) {
             const auto& result = result_opt.value();
             ID_TYPE final_uoid_after_modify = result.new_uoid.value_or(exchange_order_id); // UOID might change if not INPLACE and not same price
-
-            // Update metadata if UOID changed or order removed
-            if (result.new_uoid && result.new_uoid.value() != exchange_order_id) {
-                order_metadata_.erase(exchange_order_id);
-                if (!result.removed) {
-                    order_metadata_[final_uoid_after_modify] = {original_trader_id_of_order, original_client_id_of_order};
-                }
-            } else if (result.removed) {
-                order_metadata_.erase(exchange_order_id);
-            }
+            // The book carries the owner over to a new UOID and drops it with a removed order.
 
             // Generic quantity modification ack (if defined and used)
-            if (on_order_quantity_modified) {
-                on_order_quantity_modified(
-                        final_uoid_after_modify, // Use the potentially new UOID
-                        result.price, result.old_volume, result.new_volume, result.removed,
-                        final_trader_id_for_cb, final_client_order_id_for_cb
-                );
-            }
+            _notify<&Listener::on_order_quantity_modified>(
+                    final_uoid_after_modify, // Use the potentially new UOID
+                    result.price, result.old_volume, result.new_volume, result.removed,
+                    final_trader_id_for_cb, final_client_order_id_for_cb
+            );
 
             // Specific "partial cancel" ack if quantity was reduced but order not removed
             if (result.new_volume < result.old_volume && !result.removed) {
-                if (on_partial_cancel_limit) {
-                    SIZE_TYPE cancelled_qty = result.old_volume - result.new_volume;
-                    on_partial_cancel_limit(final_uoid_after_modify, result.price, cancelled_qty, final_trader_id_for_cb, final_client_order_id_for_cb);
-                }
+                SIZE_TYPE cancelled_qty = result.old_volume - result.new_volume;
+                _notify<&Listener::on_partial_cancel_limit>(final_uoid_after_modify, result.price, cancelled_qty, final_trader_id_for_cb, final_client_order_id_for_cb);
             }
             // If result.removed is true (e.g. new_quantity was 0), on_full_cancel_limit should be triggered by the cancel_order path.
             // modify_order_quantity to 0 should behave like a cancel.
@@ -416,32 +479,154 @@ public:
             // already calls cancel_order if new_qty_target is 0.
             return true;
         } else {
-            if (on_order_quantity_modified_rejected) {
-                on_order_quantity_modified_rejected(exchange_order_id, "quantity: core modification failed or order not found in book", final_trader_id_for_cb, final_client_order_id_for_cb);
-            }
+            _notify<&Listener::on_order_quantity_modified_rejected>(exchange_order_id, "quantity: core modification failed or order not found in book", final_trader_id_for_cb, final_client_order_id_for_cb);
             return false;
         }
     }
 
 
+    // Amends a resting order's price and quantity in place: it keeps its order ID, and keeps its queue position
+    // if the price is unchanged and the quantity does not grow (see OrderBookCore::amend_limit_order). Amends to a
+    // non-positive quantity or to a price at or through the counter side's best are rejected; cancel instead.
+    bool amend_order(ID_TYPE exchange_order_id, PRICE_TYPE new_price, SIZE_TYPE new_quantity,
+                     AgentId trader_id_req = AgentId(0), ClientOrderIdType client_order_id_req = ClientOrderIdType(0)) {
+        auto reject = [&](const std::string& reason) {
+            _notify<&Listener::on_order_amend_rejected>(exchange_order_id, reason, trader_id_req, client_order_id_req);
+            return false;
+        };
+
+        std::optional<SIDE> side_opt = order_book_.get_order_side(exchange_order_id);
+        if (!side_opt) {
+            return reject("amend: order not found in book");
+        }
+        if (new_quantity <= 0) {
+            return reject("amend: quantity must be positive");
+        }
+        SIDE side = *side_opt;
+        auto counter_best = (side == SIDE::BID) ? order_book_.get_best_ask() : order_book_.get_best_bid();
+        if (counter_best && (side == SIDE::BID ? new_price >= counter_best->first : new_price <= counter_best->first)) {
+            return reject("amend: price would cross the book");
+        }
+
+        std::optional<ModifyPriceVolResult> result_opt = order_book_.amend_limit_order(exchange_order_id, new_price, new_quantity);
+        if (!result_opt) {
+            return reject("amend: core amend failed");
+        }
+        _notify<&Listener::on_order_amended>(exchange_order_id, side, result_opt->before_price, new_price, result_opt->old_volume, result_opt->new_volume_at_new_price,
+                                              trader_id_req, client_order_id_req);
+        return true;
+    }
+
+
+    // One order-entry instruction for process_batch().
+    struct OrderInstruction {
+        enum class Type { LIMIT, MARKET, CANCEL };
+
+        Type type_ = Type::LIMIT;
+        SIDE side_ = SIDE::NONE;               // LIMIT, MARKET
+        PRICE_TYPE price_ = PRICE_DEFAULT;     // LIMIT
+        SIZE_TYPE quantity_ = SIZE_DEFAULT;    // LIMIT, MARKET
+        TIME_TYPE timeout_us_rep_ = 0;         // LIMIT
+        ID_TYPE target_order_id_ = ID_DEFAULT; // CANCEL
+        AgentId trader_id_ = AgentId(0);
+        ClientOrderIdType client_order_id_ = ClientOrderIdType(0);
+    };
+
+    // Outcome of one instruction: the resting ID of a limit order (ID_DEFAULT if nothing rested), the transient
+    // ID of a market order, or for a cancel whether it succeeded.
+    struct OrderInstructionResult {
+        ID_TYPE order_id_ = ID_DEFAULT;
+        bool accepted_ = true;
+    };
+
+    // Processes the instructions in sequence, each exactly as the matching single-order call would, with the usual
+    // callbacks and one shared fill scratch buffer. `on_result(index, result)` runs after each instruction and
+    // before the next one starts.
+    template <typename ResultHandler>
+    void process_batch(std::span<const OrderInstruction> instructions, ResultHandler&& on_result) {
+        for (std::size_t i = 0; i < instructions.size(); ++i) {
+            on_result(i, _execute_instruction(instructions[i]));
+        }
+    }
+
+    std::vector<OrderInstructionResult> process_batch(std::span<const OrderInstruction> instructions) {
+        std::vector<OrderInstructionResult> results;
+        results.reserve(instructions.size());
+        process_batch(instructions, [&results](std::size_t, const OrderInstructionResult& result) {
+            results.push_back(result);
+        });
+        return results;
+    }
+
     std::pair<std::vector<L2_DATA_TYPE>, std::vector<L2_DATA_TYPE>> get_order_book_snapshot() {
         auto snapshot = order_book_.get_state_l2();
-        if (on_order_book_snapshot) {
-            on_order_book_snapshot(snapshot.first, snapshot.second);
-        }
+        _notify<&Listener::on_order_book_snapshot>(snapshot.first, snapshot.second);
         return snapshot;
     }
 
-    std::optional<std::tuple<PRICE_TYPE, SIZE_TYPE, SIDE>> get_order_details(ID_TYPE exchange_order_id) {
-        // First, ensure the order is known to the exchange server's metadata
-        // (primarily for non-transient orders, but good check)
-        // auto meta_it = order_metadata_.find(exchange_order_id);
-        // if (meta_it == order_metadata_.end()) {
-        //     return std::nullopt; // Not a known persistent order or already cleaned up transient
-        // }
-        // This check might be too restrictive if OrderBookCore can have orders not in ExchangeServer's metadata temporarily.
-        // Rely on OrderBookWrapper for details.
+    // Snapshot of the top `max_depth` levels per side; served from the book's depth cache when it is deep enough.
+    std::pair<std::vector<L2_DATA_TYPE>, std::vector<L2_DATA_TYPE>> get_order_book_snapshot(size_t max_depth) {
+        auto snapshot = order_book_.get_state_l2(max_depth);
+        _notify<&Listener::on_order_book_snapshot>(snapshot.first, snapshot.second);
+        return snapshot;
+    }
+
+    // Read-only what-if copy of the book for evaluating hypothetical orders; it fires none of the callbacks and
+    // must be discarded before the next order reaches this exchange.
+    auto fork_order_book() const {
+        return order_book_.fork();
+    }
+
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> get_best_bid() const {
+        return order_book_.get_best_bid();
+    }
+
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> get_best_ask() const {
+        return order_book_.get_best_ask();
+    }
+
+    void set_depth_cache_levels(size_t levels) {
+        order_book_.set_depth_cache_levels(levels);
+    }
+
+    // True if any price level changed since the last clear_book_changes().
+    bool has_book_changes() const {
+        return order_book_.has_level_changes();
+    }
+
+    // Level deltas since the last clear_book_changes(), to be applied in order.
+    const std::vector<LevelChange>& get_book_changes() const {
+        return order_book_.get_level_changes();
+    }
+
+    void clear_book_changes() {
+        order_book_.clear_level_changes();
+    }
+
+    // L3 view of the top `max_depth` levels of `side`, read in place; valid until the book next changes.
+    std::vector<L3LevelView> get_order_book_l3_snapshot(SIDE side, size_t max_depth) const {
+        return order_book_.get_state_l3(side, max_depth);
+    }
+
+    // Per-order (L3) change journal of the book, off by default; see OrderBookCore::get_order_changes().
+    void set_order_changes_enabled(bool enabled) {
+        order_book_.set_order_journal_enabled(enabled);
+    }
+
+    bool has_order_changes() const {
+        return order_book_.has_order_changes();
+    }
+
+    const std::vector<OrderChange>& get_order_changes() const {
+        return order_book_.get_order_changes();
+    }
 
+    void clear_order_changes() {
+        order_book_.clear_order_changes();
+    }
+
+    std::optional<std::tuple<PRICE_TYPE, SIZE_TYPE, SIDE>> get_order_details(ID_TYPE exchange_order_id) {
+        // Rely on OrderBookWrapper for details; transient IDs never rest.
         auto side_opt = order_book_.get_order_side(exchange_order_id);
         if (!side_opt) {
             return std::nullopt;
@@ -461,53 +646,164 @@ public:
         return std::make_tuple(price_opt.value(), lob_order->quantity_, side);
     }
 
+    // Owner of a resting order, or of the transient ID of the order being matched (valid only from its callbacks).
     std::optional<std::pair<AgentId, ClientOrderIdType>> get_order_metadata(ID_TYPE exchange_order_id) {
-        auto it = order_metadata_.find(exchange_order_id);
-        if (it != order_metadata_.end()) {
-            return it->second;
+        if (std::optional<OrderOwner> owner = order_book_.get_order_owner(exchange_order_id)) {
+            return std::make_pair(AgentId(owner->trader_id_), ClientOrderIdType(owner->client_order_id_));
+        }
+        if (exchange_order_id != ID_DEFAULT && exchange_order_id == active_taker_id_) {
+            return active_taker_metadata_;
         }
         return std::nullopt;
     }
 
     size_t get_order_count() {
         return order_book_.get_num_orders(); // Orders in the book
-        // return order_metadata_.size(); // Orders known to ExchangeServer (includes transient not in book)
     }
 
     void flush() {
         order_book_.flush();
-        order_metadata_.clear();
-        active_taker_metadata_ = std::nullopt;
-        active_taker_side_ = std::nullopt;
-        transient_order_id_counter_ = TRANSIENT_ORDER_ID_COUNTER_START_VALUE_; // Reset the renamed counter
+        _clear_active_taker();
+        transient_order_id_counter_ = transient_order_id_start_; // Reset the renamed counter
+        expiry_wheel_.clear(); // Book IDs restart, so pending expiries must not outlive it
+    }
+
+    // Writes the book (see OrderBookCore::save_checkpoint), the transient ID counter, and the exchange clock with
+    // the pending expiries. Callbacks and the expiry settings are not part of the image.
+    void save_checkpoint(std::ostream& out) const {
+        checkpoint_write(out, CHECKPOINT_MAGIC);
+        order_book_.save_checkpoint(out);
+        checkpoint_write(out, transient_order_id_counter_);
+        checkpoint_write(out, current_time_);
+        checkpoint_write(out, static_cast<std::uint64_t>(expiry_wheel_.size()));
+        expiry_wheel_.for_each([&out](const TimingWheel::Entry& entry) {
+            checkpoint_write(out, entry.id_);
+            checkpoint_write(out, entry.due_);
+            checkpoint_write(out, entry.timeout_);
+        });
+    }
+
+    // Restores a save_checkpoint() image written by an exchange in the same ID space. Returns false if the image is
+    // malformed, leaving the exchange flushed (or untouched when the header does not match).
+    bool load_checkpoint(std::istream& in) {
+        std::uint32_t magic = 0;
+        if (!checkpoint_read(in, magic) || magic != CHECKPOINT_MAGIC || !order_book_.load_checkpoint(in)) {
+            return false;
+        }
+        _clear_active_taker();
+
+        ID_TYPE transient_counter = 0;
+        bool ok = checkpoint_read(in, transient_counter) && transient_counter >= transient_order_id_start_;
+        TIME_TYPE clock = 0;
+        std::uint64_t expiry_count = 0;
+        ok = ok && checkpoint_read(in, clock) && checkpoint_read(in, expiry_count);
+        if (ok) {
+            current_time_ = clock;
+            expiry_wheel_.reset(current_time_);
+        }
+        for (std::uint64_t i = 0; ok && i < expiry_count; ++i) {
+            TimingWheel::Entry entry{};
+            ok = checkpoint_read(in, entry.id_) && checkpoint_read(in, entry.due_) && checkpoint_read(in, entry.timeout_);
+            if (ok) {
+                expiry_wheel_.insert(entry.id_, entry.due_, entry.timeout_);
+            }
+        }
+        if (!ok) {
+            flush();
+            return false;
+        }
+        transient_order_id_counter_ = transient_counter;
+        return true;
     }
 
 private:
-    OrderBookWrapper order_book_;
-    // Maps Exchange Order ID to {Trader ID, Client Order ID} of the original order placer
-    std::unordered_map<ID_TYPE, std::pair<AgentId, ClientOrderIdType>> order_metadata_;
+    // Aggregated mode: one on_execution_report for the sweep in fill_scratch_. Returns the quantity filled.
+    SIZE_TYPE _report_execution(ID_TYPE order_id, SIDE side, bool market, SIZE_TYPE requested_quantity,
+                                AgentId trader_id, ClientOrderIdType client_order_id) {
+        SIZE_TYPE filled = 0;
+        for (const MatchFill& fill : fill_scratch_) {
+            filled += fill.quantity_;
+        }
+        if (!fill_scratch_.empty()) {
+            ExecutionReport report{order_id, side, market, requested_quantity, filled, trader_id, client_order_id,
+                                   std::span<const MatchFill>(fill_scratch_)};
+            _notify<&Listener::on_execution_report>(report);
+        }
+        return filled;
+    }
+
+    // Invokes a listener hook: a std::function member is called only if set, a member function always.
+    template <auto Hook, typename... Args>
+    void _notify(Args&&... args) {
+        Listener& listener = *this;
+        if constexpr (std::is_member_object_pointer_v<decltype(Hook)>) {
+            if (listener.*Hook) {
+                (listener.*Hook)(std::forward<Args>(args)...);
+            }
+        } else {
+            (listener.*Hook)(std::forward<Args>(args)...);
+        }
+    }
+
+    OrderInstructionResult _execute_instruction(const OrderInstruction& instruction) {
+        OrderInstructionResult result;
+        switch (instruction.type_) {
+            case OrderInstruction::Type::LIMIT:
+                result.order_id_ = place_limit_order(instruction.side_, instruction.price_, instruction.quantity_,
+                                                     instruction.timeout_us_rep_, instruction.trader_id_, instruction.client_order_id_);
+                break;
+            case OrderInstruction::Type::MARKET:
+                result.order_id_ = place_market_order(instruction.side_, instruction.quantity_,
+                                                      instruction.trader_id_, instruction.client_order_id_);
+                break;
+            case OrderInstruction::Type::CANCEL:
+                result.order_id_ = instruction.target_order_id_;
+                result.accepted_ = cancel_order(instruction.target_order_id_, instruction.trader_id_, instruction.client_order_id_);
+                break;
+        }
+        return result;
+    }
+
+    // Owners of resting orders are kept by the book's locator; a transient taker ID only lives for the order's own
+    // matching call, so its owner is the active taker below.
+    OrderBookWrapper<> order_book_;
 
     // Counter for transient IDs (e.g., for market orders or aggressive fills of limit orders)
     // Start from a high number to distinguish from OrderBookCore's UOIDs if they are ever mixed (they shouldn't be directly).
+    // The offset is relative to the book's ID space.
     static constexpr ID_TYPE TRANSIENT_ORDER_ID_COUNTER_START_VALUE_ = 1000000000; // Renamed
+    static constexpr std::uint32_t CHECKPOINT_MAGIC = 0x32435845; // "EXC2"
+    ID_TYPE transient_order_id_start_ = TRANSIENT_ORDER_ID_COUNTER_START_VALUE_;
     ID_TYPE transient_order_id_counter_ = TRANSIENT_ORDER_ID_COUNTER_START_VALUE_; // Renamed
 
+    // Reused across orders so that matching allocates nothing once it has grown to the deepest sweep seen.
+    std::vector<MatchFill> fill_scratch_;
+    bool aggregate_execution_reports_ = false;
+
+    TIME_TYPE current_time_ = 0; // Exchange clock, moved by advance_time()
+    bool expiry_enabled_ = false;
+    TimingWheel expiry_wheel_;
+
+    struct FillCollector {
+        std::vector<MatchFill>& fills;
+        void operator()(ID_TYPE maker_uoid, PRICE_TYPE fill_price, SIZE_TYPE fill_quantity, bool exhausted, const OrderOwner& maker_owner) {
+            fills.push_back(MatchFill{maker_uoid, fill_price, fill_quantity, exhausted, maker_owner});
+        }
+    };
+
     // Temporary state for processing current incoming order
     std::optional<std::pair<AgentId, ClientOrderIdType>> active_taker_metadata_;
     std::optional<SIDE> active_taker_side_;
+    ID_TYPE active_taker_id_ = ID_DEFAULT; // Transient ID of the current order, if it has one
 
-    // Helper to safely get metadata, throws if not found (internal consistency error)
-    std::pair<AgentId, ClientOrderIdType> _get_trader_client_ids_safe(ID_TYPE exchange_order_id) {
-        auto it = order_metadata_.find(exchange_order_id);
-        if (it != order_metadata_.end()) {
-            return it->second;
-        }
-        // This is a critical internal error if metadata for a participating order is missing.
-        throw std::runtime_error("ExchangeServer FATAL: Metadata not found for order XID " + std::to_string(exchange_order_id) + " involved in a trade/fill. System inconsistent.");
+    static SIDE _opposite_side(SIDE side) {
+        return side == SIDE::BID ? SIDE::ASK : SIDE::BID;
     }
 
-    void _remove_order_metadata_if_exists(ID_TYPE exchange_order_id) {
-        order_metadata_.erase(exchange_order_id);
+    void _clear_active_taker() {
+        active_taker_metadata_ = std::nullopt;
+        active_taker_side_ = std::nullopt;
+        active_taker_id_ = ID_DEFAULT;
     }
 };
 
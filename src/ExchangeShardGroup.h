@@ -0,0 +1,159 @@
+// file: src/ExchangeShardGroup.h
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <utility>
+
+// Runs the order-entry batches of several per-symbol exchange adapters ("shards") that fall on the same simulated
+// instant side by side. A shard whose batch is complete defers it here; the window stays open while the bus's next
+// event is an order entry for another shard at the same time, and the shard that sees it end runs every deferred
+// batch: on worker threads, with each shard's publications held back, then released shard by shard in the order
+// the shards joined the window. The bus guarantees at least one microsecond of latency, so nothing published at an
+// instant can reach a shard at that same instant, and the outcome is the same as running the batches one by one
+// (bar the interleaving of the released publications, which is fixed). Event IDs are drawn from a shared atomic
+// counter and therefore vary from run to run when batches run in parallel.
+//
+// Shard must provide the adapter's ScheduledEvent/Timestamp/AgentId types, get_id(), and, as a friend,
+// _accepts_order_entry(next), _run_shard_batch() (safe off the bus thread), and _release_shard_batch().
+template <typename Shard>
+class ExchangeShardGroup {
+public:
+    using ScheduledEvent = typename Shard::ScheduledEvent;
+    using Timestamp = typename Shard::Timestamp;
+    using AgentId = typename Shard::AgentId;
+
+    // `worker_threads` run alongside the bus thread; 0 runs every window on the bus thread.
+    explicit ExchangeShardGroup(std::size_t worker_threads) {
+        workers_.reserve(worker_threads);
+        for (std::size_t i = 0; i < worker_threads; ++i) {
+            workers_.emplace_back([this] { _worker_loop(); });
+        }
+    }
+
+    ~ExchangeShardGroup() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        work_cv_.notify_all();
+        for (std::thread& worker : workers_) worker.join();
+        for (auto& [id, shard] : shards_) shard->shard_group_ = nullptr;
+    }
+
+    ExchangeShardGroup(const ExchangeShardGroup&) = delete;
+    ExchangeShardGroup& operator=(const ExchangeShardGroup&) = delete;
+
+    // The shard must already be registered with the bus, as it is found by its agent ID.
+    void add_shard(Shard& shard) {
+        shards_[shard.get_id()] = &shard;
+        shard.shard_group_ = this;
+    }
+
+    void remove_shard(Shard& shard) {
+        window_.erase(std::remove(window_.begin(), window_.end(), &shard), window_.end());
+        shards_.erase(shard.get_id());
+        shard.shard_group_ = nullptr;
+    }
+
+    std::size_t shard_count() const { return shards_.size(); }
+    std::size_t worker_count() const { return workers_.size(); }
+
+    // Called by a shard whose order entry is complete: joins the window and runs it unless `next` extends it.
+    void finish_order_entry(Shard& shard, const std::optional<ScheduledEvent>& next, Timestamp now, bool defer) {
+        if (defer && std::find(window_.begin(), window_.end(), &shard) == window_.end()) {
+            window_.push_back(&shard);
+        }
+        if (next && next->scheduled_time == now) {
+            auto it = shards_.find(next->subscriber_id);
+            if (it != shards_.end() && it->second->_accepts_order_entry(*next)) {
+                return;
+            }
+        }
+        run_window();
+    }
+
+    // Runs and releases every deferred batch now.
+    void run_window() {
+        if (window_.empty()) {
+            return;
+        }
+        if (window_.size() == 1 || workers_.empty()) {
+            for (Shard* shard : window_) shard->_run_shard_batch();
+        } else {
+            _run_parallel();
+        }
+        for (Shard* shard : window_) shard->_release_shard_batch();
+        window_.clear();
+    }
+
+private:
+    void _run_parallel() {
+        next_task_.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_workers_ = workers_.size();
+            ++generation_;
+        }
+        work_cv_.notify_all();
+        _drain();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return busy_workers_ == 0; });
+        if (failure_) {
+            std::exception_ptr failure = std::exchange(failure_, nullptr);
+            lock.unlock();
+            std::rethrow_exception(failure);
+        }
+    }
+
+    void _drain() {
+        for (std::size_t i = next_task_.fetch_add(1, std::memory_order_relaxed); i < window_.size();
+             i = next_task_.fetch_add(1, std::memory_order_relaxed)) {
+            try {
+                window_[i]->_run_shard_batch();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!failure_) failure_ = std::current_exception();
+            }
+        }
+    }
+
+    void _worker_loop() {
+        std::size_t seen_generation = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                work_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+                if (stopping_) {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+            _drain();
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busy_workers_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+    std::unordered_map<AgentId, Shard*> shards_;
+    std::vector<Shard*> window_; // Shards with a deferred batch, in the order they joined
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::size_t generation_ = 0;
+    std::size_t busy_workers_ = 0;
+    bool stopping_ = false;
+    std::atomic<std::size_t> next_task_{0};
+    std::exception_ptr failure_;
+};
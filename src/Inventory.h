@@ -1226,6 +1226,31 @@ public:
         // std::cerr << "DEBUG: Rejected full cancel for limit order: cancel_cid=" << cid_order << ", target_cid=" << target_cid << std::endl;
     }
 
+    /**
+     * @brief Handle one limit order removed by an acknowledged mass cancel (terminal state). Removes the order.
+     * @param cid_target_order The client ID of the cancelled limit order.
+     * @throws std::out_of_range If the order is not found in acknowledged limit orders.
+     * @throws std::logic_error If internal state inconsistency is detected.
+     * @note A mass cancel has no per-order cancel request; any pending cancellations targeting this order are cleaned up.
+     */
+    void limit_order_execute_mass_cancel_acknowledge(CID_TYPE cid_target_order) {
+        // 1. Check and remove from acknowledged map
+        auto it_ack = acknowledged_orders_limit_.find(cid_target_order);
+        if (it_ack == acknowledged_orders_limit_.end()) {
+            throw std::out_of_range("Missing acknowledged limit order for mass cancel: cid_order=" + std::to_string(cid_target_order));
+        }
+        acknowledged_orders_limit_.erase(it_ack);
+
+        // 2. Clean up any pending cancellations targeting this order
+        cleanup_pending_cancellations_for_target(cid_target_order, "Limit");
+
+        // 3. Find and remove from the master map (deletes the object)
+        size_t removed_count = orders_by_cid_.erase(cid_target_order);
+        if (removed_count == 0) {
+            throw std::logic_error("Order missing from master list during mass cancel for cid_order=" + std::to_string(cid_target_order));
+        }
+    }
+
     //--------------------------------------------------------------------------
     // Snapshot / Debugging
     //--------------------------------------------------------------------------
@@ -11,6 +11,9 @@
 #include <sstream>
 #include <utility> // For std::pair, std::move
 #include <atomic>  // For static event ID counter
+#include <memory>
+#include <mutex>
+#include <new>
 
 
 namespace ModelEvents {
@@ -111,6 +114,99 @@ namespace ModelEvents {
     using PriceQuantityPair = std::pair<PriceType, QuantityType>;
     using OrderBookLevel = std::vector<PriceQuantityPair>; // Vector of price/qty pairs
 
+    // ------------------------------------------------------------------
+    // Event Allocation
+    // ------------------------------------------------------------------
+    // Events are created with make_event, which places each shared_ptr's block (control block and event together)
+    // in a per-event-type pool: a block returns to its pool's free list when the last reference goes and is reused
+    // by the next event of that type, so once the pools are warm creating an event does not reach the heap.
+
+    struct EventPoolStats {
+        std::uint64_t events_created = 0;   // Every make_event call; each was a heap allocation with make_shared
+        std::uint64_t heap_allocations = 0; // Blocks taken from the heap because the free list was empty
+    };
+
+    namespace detail {
+        inline std::atomic<std::uint64_t> events_created{0};
+        inline std::atomic<std::uint64_t> event_heap_allocations{0};
+
+        // Free list of blocks for one block type. Shard batches create events on worker threads, hence the mutex.
+        // The pool is never destroyed, as events may outlive static destruction.
+        template <typename Block>
+        class EventBlockPool {
+        public:
+            static EventBlockPool& instance() {
+                static EventBlockPool* pool = new EventBlockPool();
+                return *pool;
+            }
+
+            void* allocate() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (free_list_) {
+                        FreeBlock* block = free_list_;
+                        free_list_ = block->next;
+                        return block;
+                    }
+                }
+                event_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+                return ::operator new(sizeof(Block), std::align_val_t(alignof(Block)));
+            }
+
+            void deallocate(void* ptr) noexcept {
+                std::lock_guard<std::mutex> lock(mutex_);
+                free_list_ = new (ptr) FreeBlock{free_list_};
+            }
+
+        private:
+            struct FreeBlock {
+                FreeBlock* next;
+            };
+            static_assert(sizeof(Block) >= sizeof(FreeBlock) && alignof(Block) >= alignof(FreeBlock));
+
+            std::mutex mutex_;
+            FreeBlock* free_list_ = nullptr;
+        };
+
+        template <typename T>
+        struct EventPoolAllocator {
+            using value_type = T;
+
+            EventPoolAllocator() noexcept = default;
+            template <typename U>
+            EventPoolAllocator(const EventPoolAllocator<U>&) noexcept {}
+
+            T* allocate(std::size_t n) {
+                if (n != 1) {
+                    return std::allocator<T>().allocate(n);
+                }
+                return static_cast<T*>(EventBlockPool<T>::instance().allocate());
+            }
+
+            void deallocate(T* ptr, std::size_t n) noexcept {
+                if (n != 1) {
+                    std::allocator<T>().deallocate(ptr, n);
+                    return;
+                }
+                EventBlockPool<T>::instance().deallocate(ptr);
+            }
+
+            template <typename U>
+            bool operator==(const EventPoolAllocator<U>&) const noexcept { return true; }
+        };
+    } // namespace detail
+
+    template <typename E, typename... Args>
+    std::shared_ptr<const E> make_event(Args&&... args) {
+        detail::events_created.fetch_add(1, std::memory_order_relaxed);
+        return std::allocate_shared<E>(detail::EventPoolAllocator<E>(), std::forward<Args>(args)...);
+    }
+
+    inline EventPoolStats event_pool_stats() {
+        return EventPoolStats{detail::events_created.load(std::memory_order_relaxed),
+                              detail::event_heap_allocations.load(std::memory_order_relaxed)};
+    }
+
     // ------------------------------------------------------------------
     // Base Event
     // ------------------------------------------------------------------
@@ -189,6 +285,53 @@ namespace ModelEvents {
         }
     };
 
+    // Incremental L2 update. A delta lists only the levels that changed since the previous event of the symbol, best
+    // first, each with its new total quantity (0 means the level is gone). A snapshot (is_snapshot) lists both full
+    // sides and replaces whatever the receiver had. Sequence numbers count up by one per event of the symbol, so a
+    // gap means an update was missed and the receiver should wait for the next snapshot.
+    struct LTwoDeltaEvent : BaseEvent {
+        SymbolType symbol;
+        std::optional<Timestamp> exchange_ts;
+        Timestamp ingress_ts;
+        std::uint64_t sequence;
+        bool is_snapshot;
+        OrderBookLevel bids;
+        OrderBookLevel asks;
+
+        LTwoDeltaEvent(
+                Timestamp created_ts, SymbolType sym, std::optional<Timestamp> ex_ts, Timestamp ing_ts,
+                std::uint64_t seq, bool snapshot, OrderBookLevel b, OrderBookLevel a
+        ) : BaseEvent(created_ts), symbol(std::move(sym)), exchange_ts(ex_ts), ingress_ts(ing_ts),
+            sequence(seq), is_snapshot(snapshot), bids(std::move(b)), asks(std::move(a)) {}
+
+        std::string to_string() const override {
+            std::ostringstream oss;
+            oss << "LTwoDeltaEvent(" << BaseEvent::to_string()
+                << ", symbol=" << symbol
+                << ", exchange_ts=" << format_optional_timestamp(exchange_ts)
+                << ", ingress_ts=" << format_timestamp(ingress_ts)
+                << ", sequence=" << sequence
+                << ", is_snapshot=" << (is_snapshot ? "true" : "false")
+                << ", bids_levels=" << bids.size()
+                << ", asks_levels=" << asks.size() << ")";
+            return oss.str();
+        }
+    };
+
+    // Self wake-up of an exchange adapter that ends an L2 conflation window, so the book state held back during the
+    // window goes out even if nothing else happens.
+    struct L2PublishTimerEvent : BaseEvent {
+        SymbolType symbol;
+
+        L2PublishTimerEvent(Timestamp created_ts, SymbolType sym) : BaseEvent(created_ts), symbol(std::move(sym)) {}
+
+        std::string to_string() const override {
+            std::ostringstream oss;
+            oss << "L2PublishTimerEvent(" << BaseEvent::to_string() << ", symbol=" << symbol << ")";
+            return oss.str();
+        }
+    };
+
     struct LimitOrderEvent : BaseEvent {
         SymbolType symbol;
         Side side;
@@ -318,6 +461,31 @@ namespace ModelEvents {
         }
     };
 
+    // Cancels all resting limit orders of the sender in one request, optionally only on `side` and within the
+    // inclusive price range [min_price, max_price].
+    struct MassCancelLimitOrderEvent : BaseEvent {
+        SymbolType symbol;
+        ClientOrderIdType client_order_id;
+        std::optional<Side> side;
+        std::optional<PriceType> min_price;
+        std::optional<PriceType> max_price;
+
+        MassCancelLimitOrderEvent(
+                Timestamp created_ts, SymbolType sym, ClientOrderIdType req_cid, std::optional<Side> s = std::nullopt,
+                std::optional<PriceType> min_p = std::nullopt, std::optional<PriceType> max_p = std::nullopt
+        ) : BaseEvent(created_ts), symbol(std::move(sym)), client_order_id(req_cid),
+            side(s), min_price(min_p), max_price(max_p) {}
+        std::string to_string() const override {
+            std::ostringstream oss;
+            oss << "MassCancelLimitOrderEvent(" << BaseEvent::to_string() << ", symbol=" << symbol
+                << ", client_order_id=" << client_order_id
+                << ", side=" << (side ? side_to_string(*side) : "ANY")
+                << ", min_price=" << (min_price ? std::to_string(*min_price) : "None")
+                << ", max_price=" << (max_price ? std::to_string(*max_price) : "None") << ")";
+            return oss.str();
+        }
+    };
+
     struct BaseAckEvent : BaseEvent {
         ExchangeOrderIdType order_id;
         ClientOrderIdType client_order_id;
@@ -422,6 +590,33 @@ namespace ModelEvents {
         }
     };
 
+    // One ack for a MassCancelLimitOrderEvent, listing every order it removed (possibly none).
+    struct MassCancelLimitOrderAckEvent : BaseEvent {
+        struct CancelledOrder {
+            ExchangeOrderIdType order_id;
+            ClientOrderIdType target_order_id;
+            Side side;
+            PriceType price;
+            QuantityType quantity;
+        };
+
+        SymbolType symbol;
+        ClientOrderIdType client_order_id;
+        std::vector<CancelledOrder> cancelled_orders;
+
+        MassCancelLimitOrderAckEvent(
+                Timestamp created_ts, SymbolType sym, ClientOrderIdType req_cid, std::vector<CancelledOrder> cancelled
+        ) : BaseEvent(created_ts), symbol(std::move(sym)), client_order_id(req_cid),
+            cancelled_orders(std::move(cancelled)) {}
+        std::string to_string() const override {
+            std::ostringstream oss;
+            oss << "MassCancelLimitOrderAckEvent(" << BaseEvent::to_string() << ", symbol=" << symbol
+                << ", client_order_id=" << client_order_id
+                << ", cancelled_orders=" << cancelled_orders.size() << ")";
+            return oss.str();
+        }
+    };
+
     struct PartialCancelAckEvent : BaseCancelAckEvent {
         QuantityType cancelled_qty;
         QuantityType remaining_qty;
@@ -814,7 +1009,11 @@ using AllEventTypes = std::variant<
         std::shared_ptr<const ModelEvents::TradeEvent>,
         std::shared_ptr<const ModelEvents::TriggerExpiredLimitOrderEvent>,
         std::shared_ptr<const ModelEvents::RejectTriggerExpiredLimitOrderEvent>,
-        std::shared_ptr<const ModelEvents::AckTriggerExpiredLimitOrderEvent>
+        std::shared_ptr<const ModelEvents::AckTriggerExpiredLimitOrderEvent>,
+        std::shared_ptr<const ModelEvents::MassCancelLimitOrderEvent>,
+        std::shared_ptr<const ModelEvents::MassCancelLimitOrderAckEvent>,
+        std::shared_ptr<const ModelEvents::LTwoDeltaEvent>,
+        std::shared_ptr<const ModelEvents::L2PublishTimerEvent>
 >;
 
 template<typename... ExtraEventTypes>
@@ -834,6 +1033,8 @@ using ModelEventBus = EventBusSystem::TopicBasedEventBus<
         ModelEvents::FullFillLimitOrderEvent, ModelEvents::FullFillMarketOrderEvent,
         ModelEvents::TradeEvent, ModelEvents::TriggerExpiredLimitOrderEvent,
         ModelEvents::RejectTriggerExpiredLimitOrderEvent, ModelEvents::AckTriggerExpiredLimitOrderEvent,
+        ModelEvents::MassCancelLimitOrderEvent, ModelEvents::MassCancelLimitOrderAckEvent,
+        ModelEvents::LTwoDeltaEvent, ModelEvents::L2PublishTimerEvent,
         ExtraEventTypes...
 >;
 
@@ -854,5 +1055,7 @@ using ModelEventProcessor = EventBusSystem::EventProcessor<ActualDerivedAgent,
         ModelEvents::FullFillLimitOrderEvent, ModelEvents::FullFillMarketOrderEvent,
         ModelEvents::TradeEvent, ModelEvents::TriggerExpiredLimitOrderEvent,
         ModelEvents::RejectTriggerExpiredLimitOrderEvent, ModelEvents::AckTriggerExpiredLimitOrderEvent,
+        ModelEvents::MassCancelLimitOrderEvent, ModelEvents::MassCancelLimitOrderAckEvent,
+        ModelEvents::LTwoDeltaEvent, ModelEvents::L2PublishTimerEvent,
         ExtraEventTypes...
 >;
\ No newline at end of file
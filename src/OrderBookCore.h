@@ -7,7 +7,6 @@
 #define EXCHANGE_ORDERBOOKCORE_H
 
 #include <iostream>
-#include <list>
 #include <unordered_map>
 #include <memory> // For std::unique_ptr
 #include <iterator> // For std::prev, std::next, std::reverse_iterator
@@ -16,6 +15,10 @@
 #include <vector>
 #include <optional>
 #include <functional> // For std::greater_equal, std::less_equal
+#include <limits>
+#include <type_traits>
+#include <algorithm>
+#include <bit>
 #include "Globals.h"
 
 enum class DOUBLEOPTION { FRONT, BACK };
@@ -23,7 +26,8 @@ enum class TRIPLEOPTION { FRONT, BACK, INPLACE };
 
 class LOBOrder {
 public:
-    LOBOrder(ID_TYPE uoid, SIZE_TYPE quantity) : uoid_(uoid), quantity_(quantity) {}
+    LOBOrder() : quantity_(0), uoid_(ID_DEFAULT) {}
+    LOBOrder(ID_TYPE uoid, SIZE_TYPE quantity) : quantity_(quantity), uoid_(uoid) {}
 
     LOBOrder(const LOBOrder&) = default;
     LOBOrder(LOBOrder&&) noexcept = default;
@@ -31,13 +35,19 @@ public:
     LOBOrder& operator=(LOBOrder&&) noexcept = delete;
 
     SIZE_TYPE quantity_;
-    const ID_TYPE uoid_;
+    ID_TYPE uoid_; // Not const: pooled nodes are rebound to a new order when reused.
+};
+
+// Opaque owner tag the book stores for each resting order (the exchange puts trader and client order IDs here).
+struct OrderOwner {
+    std::uint64_t trader_id_ = 0;
+    std::uint64_t client_order_id_ = 0;
 };
 
 class LOBFillResult {
 public:
-    LOBFillResult(ID_TYPE uoid_maker, SIZE_TYPE quantity, bool exhausted)
-            : uoid_maker_(uoid_maker), quantity_(quantity), exhausted_(exhausted) {}
+    LOBFillResult(ID_TYPE uoid_maker, SIZE_TYPE quantity, bool exhausted, OrderOwner maker_owner = {})
+            : uoid_maker_(uoid_maker), quantity_(quantity), exhausted_(exhausted), maker_owner_(maker_owner) {}
 
     LOBFillResult(const LOBFillResult&) = default;
     LOBFillResult(LOBFillResult&&) noexcept = default;
@@ -47,6 +57,7 @@ public:
     const ID_TYPE uoid_maker_;
     const SIZE_TYPE quantity_;
     const bool exhausted_;
+    const OrderOwner maker_owner_;
 };
 
 class LOBClearResult {
@@ -133,198 +144,497 @@ public:
     ReplaceOrderResult& operator=(ReplaceOrderResult&&) noexcept = default;
 };
 
+// One entry of the level-change journal: the aggregate quantity a level now holds, 0 once the level is gone.
+struct LevelChange {
+    SIDE side_;
+    PRICE_TYPE price_;
+    SIZE_TYPE new_quantity_;
+};
 
-class OrderContainer {
+// One entry of the order-change (L3) journal. ADD books `uoid_` with `quantity_` ahead of `before_uoid_`
+// (ID_DEFAULT: at the back of the level). MODIFY sets its quantity to `quantity_` in place, keeping its queue
+// position. EXECUTE fills `quantity_` of it; the order leaves the level once nothing remains. DELETE removes it
+// with `quantity_` still open.
+struct OrderChange {
+    enum class Type : std::uint8_t { ADD, MODIFY, EXECUTE, DELETE };
+    Type type_;
+    SIDE side_;
+    ID_TYPE uoid_;
+    PRICE_TYPE price_;
+    SIZE_TYPE quantity_;
+    ID_TYPE before_uoid_ = ID_DEFAULT;
+};
+
+
+// Raw binary I/O for checkpoint images. Images use the host's byte order and type sizes, so they are meant to be
+// restored by the same build that wrote them.
+template <typename T>
+void checkpoint_write(std::ostream& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoint_write: type must be trivially copyable.");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool checkpoint_read(std::istream& in, T& value) {
+    static_assert(std::is_trivially_copyable_v<T>, "checkpoint_read: type must be trivially copyable.");
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+
+// UOIDs of a book live in the ID space `space`: [space << UOID_SPACE_SHIFT, (space + 1) << UOID_SPACE_SHIFT).
+// Books of different symbols given different spaces never hand out the same UOID.
+static constexpr unsigned UOID_SPACE_SHIFT = 40;
+
+inline constexpr ID_TYPE uoid_space_base(ID_TYPE space) {
+    return space << UOID_SPACE_SHIFT;
+}
+
+
+typedef std::uint32_t ORDER_HANDLE;
+static const ORDER_HANDLE ORDER_HANDLE_NULL = std::numeric_limits<ORDER_HANDLE>::max();
+
+class Price;
+
+// Intrusive queue node. prev_/next_ are handles into the owning OrderPool.
+struct OrderNode {
+    LOBOrder order;
+    ORDER_HANDLE prev_ = ORDER_HANDLE_NULL;
+    ORDER_HANDLE next_ = ORDER_HANDLE_NULL;
+};
+
+// Chunked arena of OrderNodes shared by every price level of one book. Chunks are never released or moved,
+// so node addresses stay stable; released nodes go onto a LIFO free list and are handed out again before
+// the arena grows. In steady state acquiring and releasing a node does not touch the allocator.
+class OrderPool {
 public:
-    std::list<LOBOrder>::iterator addOrder(ID_TYPE uoid, SIZE_TYPE quantity) {
-        orders_.emplace_back(uoid, quantity);
-        auto list_it = std::prev(orders_.end());
-        index_[uoid] = list_it;
-        return list_it;
+    static constexpr std::size_t CHUNK_BITS = 12;
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{1} << CHUNK_BITS;
+
+    OrderPool() = default;
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    ORDER_HANDLE acquire(ID_TYPE uoid, SIZE_TYPE quantity) {
+        if (free_head_ == ORDER_HANDLE_NULL) {
+            grow();
+        }
+        ORDER_HANDLE handle = free_head_;
+        OrderNode& n = node(handle);
+        free_head_ = n.next_;
+        n.order.uoid_ = uoid;
+        n.order.quantity_ = quantity;
+        n.prev_ = ORDER_HANDLE_NULL;
+        n.next_ = ORDER_HANDLE_NULL;
+        ++in_use_;
+        return handle;
     }
 
-    std::list<LOBOrder>::iterator addOrderToFront(ID_TYPE uoid, SIZE_TYPE quantity) {
-        orders_.emplace_front(uoid, quantity);
-        auto list_it = orders_.begin();
-        index_[uoid] = list_it;
-        return list_it;
+    void release(ORDER_HANDLE handle) {
+        OrderNode& n = node(handle);
+        n.prev_ = ORDER_HANDLE_NULL;
+        n.next_ = free_head_;
+        free_head_ = handle;
+        --in_use_;
     }
 
-    std::list<LOBOrder>::iterator addOrderAtPosition(std::list<LOBOrder>::iterator pos, ID_TYPE uoid, SIZE_TYPE quantity) {
-        auto list_it = orders_.emplace(pos, uoid, quantity);
-        index_[uoid] = list_it;
-        return list_it;
+    OrderNode& node(ORDER_HANDLE handle) {
+        return chunks_[handle >> CHUNK_BITS][handle & (CHUNK_SIZE - 1)];
     }
+    const OrderNode& node(ORDER_HANDLE handle) const {
+        return chunks_[handle >> CHUNK_BITS][handle & (CHUNK_SIZE - 1)];
+    }
+
+    std::size_t in_use() const { return in_use_; }
+    std::size_t capacity() const { return chunks_.size() * CHUNK_SIZE; }
 
-    std::optional<LOBOrder> removeOrder(ID_TYPE uoid) {
-        auto map_it = index_.find(uoid);
-        if (map_it != index_.end()) {
-            auto list_it = map_it->second;
-            LOBOrder removedOrderData = *list_it;
-            orders_.erase(list_it);
-            index_.erase(map_it);
-            return removedOrderData;
+    // Grows the pool so that `count` more orders can be acquired without allocating.
+    void reserve(std::size_t count) {
+        while (capacity() - in_use_ < count) {
+            grow();
         }
-        return std::nullopt;
     }
 
-    std::list<LOBOrder>::iterator erase(std::list<LOBOrder>::iterator list_it) {
-        if (list_it != orders_.end()) {
-            index_.erase(list_it->uoid_);
-            return orders_.erase(list_it);
+private:
+    void grow() {
+        assert(capacity() + CHUNK_SIZE <= ORDER_HANDLE_NULL && "OrderPool: handle space exhausted.");
+        const ORDER_HANDLE first = static_cast<ORDER_HANDLE>(capacity());
+        chunks_.push_back(std::make_unique<OrderNode[]>(CHUNK_SIZE));
+        OrderNode* chunk = chunks_.back().get();
+        // Thread the new chunk onto the free list so that lower handles are handed out first.
+        for (std::size_t i = 0; i < CHUNK_SIZE; ++i) {
+            chunk[i].next_ = (i + 1 < CHUNK_SIZE) ? static_cast<ORDER_HANDLE>(first + i + 1) : free_head_;
         }
-        return orders_.end();
+        free_head_ = first;
+    }
+
+    std::vector<std::unique_ptr<OrderNode[]>> chunks_;
+    ORDER_HANDLE free_head_ = ORDER_HANDLE_NULL;
+    std::size_t in_use_ = 0;
+};
+
+
+// Where a resting order lives: its level, its pool node, its side and the owner tag supplied when it was booked.
+struct OrderLocation {
+    Price* level_ = nullptr; // nullptr when the UOID is not resting in the book
+    ORDER_HANDLE node_ = ORDER_HANDLE_NULL;
+    SIDE side_ = SIDE::NONE;
+    OrderOwner owner_;
+    // Neighbours in the owner's list of resting orders (see OrderLocator::first_of_owner); ID_DEFAULT at the ends.
+    ID_TYPE owner_prev_ = ID_DEFAULT;
+    ID_TYPE owner_next_ = ID_DEFAULT;
+};
+
+// The single UOID -> OrderLocation index of a book. UOIDs are handed out sequentially, so a UOID addresses a
+// chunked table directly and every lookup is one array probe. A chunk below the newest one is recycled once
+// none of its orders is resting any more, which bounds memory by the age spread of the live orders.
+// Every resting order is also threaded onto an intrusive list per owner trader, so all orders of one trader
+// can be visited without scanning the book. Trader IDs are small sequential bus IDs, so the list heads are a
+// table indexed by trader ID; IDs past MAX_DIRECT_OWNERS fall back to a hash map.
+class OrderLocator {
+public:
+    static constexpr std::size_t CHUNK_BITS = 12;
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{1} << CHUNK_BITS;
+    static constexpr std::uint64_t MAX_DIRECT_OWNERS = std::uint64_t{1} << 16;
+
+    // UOIDs are stored relative to `uoid_base`, so a book in a high ID space still indexes from slot 0.
+    explicit OrderLocator(ID_TYPE uoid_base = 0) : uoid_base_(uoid_base) {}
+    OrderLocator(const OrderLocator&) = delete;
+    OrderLocator& operator=(const OrderLocator&) = delete;
+
+    OrderLocation* find(ID_TYPE uoid) {
+        uoid -= uoid_base_; // IDs from other spaces wrap to a chunk index past the end.
+        std::size_t chunk_idx = static_cast<std::size_t>(uoid >> CHUNK_BITS);
+        if (chunk_idx >= chunks_.size() || !chunks_[chunk_idx]) return nullptr;
+        OrderLocation& loc = chunks_[chunk_idx]->entries[uoid & (CHUNK_SIZE - 1)];
+        return loc.level_ ? &loc : nullptr;
+    }
+    const OrderLocation* find(ID_TYPE uoid) const {
+        return const_cast<OrderLocator*>(this)->find(uoid);
+    }
+
+    // Registers a resting order. The UOID must not currently be resting.
+    OrderLocation& insert(ID_TYPE uoid, const OrderLocation& location) {
+        assert(location.level_ != nullptr && "OrderLocator: a resting order needs a level.");
+        uoid -= uoid_base_;
+        std::size_t chunk_idx = static_cast<std::size_t>(uoid >> CHUNK_BITS);
+        if (chunk_idx >= chunks_.size()) {
+            chunks_.resize(chunk_idx + 1);
+        }
+        if (!chunks_[chunk_idx]) {
+            chunks_[chunk_idx] = take_chunk();
+        }
+        top_chunk_ = std::max(top_chunk_, chunk_idx);
+        Chunk& chunk = *chunks_[chunk_idx];
+        OrderLocation& loc = chunk.entries[uoid & (CHUNK_SIZE - 1)];
+        assert(loc.level_ == nullptr && "OrderLocator: UOID is already resting.");
+        loc = location;
+        ++chunk.live;
+        ++size_;
+        link_owner(uoid + uoid_base_, loc);
+        return loc;
+    }
+
+    void erase(ID_TYPE uoid) {
+        uoid -= uoid_base_;
+        std::size_t chunk_idx = static_cast<std::size_t>(uoid >> CHUNK_BITS);
+        Chunk& chunk = *chunks_[chunk_idx];
+        OrderLocation& loc = chunk.entries[uoid & (CHUNK_SIZE - 1)];
+        assert(loc.level_ != nullptr && "OrderLocator: UOID is not resting.");
+        unlink_owner(loc);
+        loc = OrderLocation{};
+        --size_;
+        if (--chunk.live == 0 && chunk_idx < top_chunk_) {
+            spare_chunks_.push_back(std::move(chunks_[chunk_idx]));
+        }
+    }
+
+    std::size_t size() const { return size_; }
+
+    // Most recently inserted resting order of `trader_id`, or ID_DEFAULT if it has none. Follow owner_next_
+    // from there to visit the rest.
+    ID_TYPE first_of_owner(std::uint64_t trader_id) const {
+        if (trader_id < MAX_DIRECT_OWNERS) {
+            return trader_id < owner_heads_.size() ? owner_heads_[trader_id] : ID_DEFAULT;
+        }
+        auto it = far_owner_heads_.find(trader_id);
+        return it != far_owner_heads_.end() ? it->second : ID_DEFAULT;
     }
 
-    LOBOrder* getOrder(ID_TYPE uoid) {
-        auto it = index_.find(uoid);
-        if (it != index_.end()) {
-            return &(*(it->second));
+    void clear() {
+        for (auto& chunk : chunks_) {
+            if (chunk) {
+                std::fill(std::begin(chunk->entries), std::end(chunk->entries), OrderLocation{});
+                chunk->live = 0;
+                spare_chunks_.push_back(std::move(chunk));
+            }
         }
-        return nullptr;
+        chunks_.clear();
+        std::fill(owner_heads_.begin(), owner_heads_.end(), ID_DEFAULT);
+        far_owner_heads_.clear();
+        top_chunk_ = 0;
+        size_ = 0;
     }
 
-    const LOBOrder* getOrder(ID_TYPE uoid) const {
-        auto it = index_.find(uoid);
-        if (it != index_.end()) {
-            return &(*(it->second));
+private:
+    struct Chunk {
+        OrderLocation entries[CHUNK_SIZE];
+        std::size_t live = 0;
+    };
+
+    std::unique_ptr<Chunk> take_chunk() {
+        if (spare_chunks_.empty()) {
+            return std::make_unique<Chunk>();
         }
-        return nullptr;
+        std::unique_ptr<Chunk> chunk = std::move(spare_chunks_.back());
+        spare_chunks_.pop_back();
+        return chunk;
     }
 
-    std::optional<std::list<LOBOrder>::iterator> getOrderListIterator(ID_TYPE uoid) {
-        auto map_it = index_.find(uoid);
-        if (map_it != index_.end()) {
-            return map_it->second;
+    ID_TYPE& owner_head(std::uint64_t trader_id) {
+        if (trader_id < MAX_DIRECT_OWNERS) {
+            if (trader_id >= owner_heads_.size()) {
+                owner_heads_.resize(trader_id + 1, ID_DEFAULT);
+            }
+            return owner_heads_[trader_id];
         }
-        return std::nullopt;
+        return far_owner_heads_[trader_id];
     }
 
-    std::optional<std::list<LOBOrder>::const_iterator> getOrderListIterator(ID_TYPE uoid) const {
-        auto map_it = index_.find(uoid);
-        if (map_it != index_.end()) {
-            return map_it->second;
+    void link_owner(ID_TYPE uoid, OrderLocation& loc) {
+        ID_TYPE& head = owner_head(loc.owner_.trader_id_);
+        loc.owner_prev_ = ID_DEFAULT;
+        loc.owner_next_ = head;
+        if (head != ID_DEFAULT) {
+            find(head)->owner_prev_ = uoid;
+        }
+        head = uoid;
+    }
+
+    void unlink_owner(const OrderLocation& loc) {
+        if (loc.owner_next_ != ID_DEFAULT) {
+            find(loc.owner_next_)->owner_prev_ = loc.owner_prev_;
+        }
+        if (loc.owner_prev_ != ID_DEFAULT) {
+            find(loc.owner_prev_)->owner_next_ = loc.owner_next_;
+        } else if (loc.owner_.trader_id_ < MAX_DIRECT_OWNERS) {
+            owner_heads_[loc.owner_.trader_id_] = loc.owner_next_;
+        } else if (loc.owner_next_ != ID_DEFAULT) {
+            far_owner_heads_[loc.owner_.trader_id_] = loc.owner_next_;
+        } else {
+            far_owner_heads_.erase(loc.owner_.trader_id_);
         }
-        return std::nullopt;
     }
 
-    auto begin() { return orders_.begin(); }
-    auto end() { return orders_.end(); }
-    [[nodiscard]] auto begin() const { return orders_.cbegin(); }
-    [[nodiscard]] auto end() const { return orders_.cend(); }
-    auto rbegin() { return orders_.rbegin(); }
-    auto rend() { return orders_.rend(); }
-    [[nodiscard]] auto rbegin() const { return orders_.crbegin(); }
-    [[nodiscard]] auto rend() const { return orders_.crend(); }
+    ID_TYPE uoid_base_;
+    std::vector<std::unique_ptr<Chunk>> chunks_;
+    std::vector<std::unique_ptr<Chunk>> spare_chunks_;
+    std::vector<ID_TYPE> owner_heads_; // Indexed by trader ID
+    std::unordered_map<std::uint64_t, ID_TYPE> far_owner_heads_;
+    std::size_t top_chunk_ = 0;
+    std::size_t size_ = 0;
+};
 
 
+// FIFO queue of the orders resting on one price level, linked through OrderPool nodes. Lookup by UOID goes
+// through the book's OrderLocator, so the container keeps no index of its own.
+class OrderContainer {
+public:
+    template <bool IsConst>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = LOBOrder;
+        using difference_type = std::ptrdiff_t;
+        using pool_type = std::conditional_t<IsConst, const OrderPool, OrderPool>;
+        using reference = std::conditional_t<IsConst, const LOBOrder&, LOBOrder&>;
+        using pointer = std::conditional_t<IsConst, const LOBOrder*, LOBOrder*>;
+
+        Iterator() = default;
+        Iterator(pool_type* pool, ORDER_HANDLE handle) : pool_(pool), handle_(handle) {}
+
+        reference operator*() const { return pool_->node(handle_).order; }
+        pointer operator->() const { return &pool_->node(handle_).order; }
+        Iterator& operator++() { handle_ = pool_->node(handle_).next_; return *this; }
+        Iterator operator++(int) { Iterator tmp = *this; ++(*this); return tmp; }
+        bool operator==(const Iterator& other) const { return handle_ == other.handle_; }
+        bool operator!=(const Iterator& other) const { return handle_ != other.handle_; }
+        ORDER_HANDLE handle() const { return handle_; }
+
+    private:
+        pool_type* pool_ = nullptr;
+        ORDER_HANDLE handle_ = ORDER_HANDLE_NULL;
+    };
+
+    explicit OrderContainer(OrderPool& pool) : pool_(&pool) {}
+    OrderContainer(const OrderContainer&) = delete;
+    OrderContainer& operator=(const OrderContainer&) = delete;
+    ~OrderContainer() { clear(); }
+
+    void push_back(ORDER_HANDLE handle) {
+        insert_before(ORDER_HANDLE_NULL, handle);
+    }
+
+    void push_front(ORDER_HANDLE handle) {
+        insert_before(head_, handle);
+    }
+
+    // Links `handle` in front of `pos`; ORDER_HANDLE_NULL as `pos` appends at the back.
+    void insert_before(ORDER_HANDLE pos, ORDER_HANDLE handle) {
+        OrderNode& n = pool_->node(handle);
+        ORDER_HANDLE prev = (pos == ORDER_HANDLE_NULL) ? tail_ : pool_->node(pos).prev_;
+        n.prev_ = prev;
+        n.next_ = pos;
+        if (prev == ORDER_HANDLE_NULL) head_ = handle; else pool_->node(prev).next_ = handle;
+        if (pos == ORDER_HANDLE_NULL) tail_ = handle; else pool_->node(pos).prev_ = handle;
+        ++size_;
+    }
+
+    // Unlinks `handle` but keeps its pool node, so it can be linked into another container. Returns the handle
+    // that followed it.
+    ORDER_HANDLE unlink(ORDER_HANDLE handle) {
+        OrderNode& n = pool_->node(handle);
+        ORDER_HANDLE prev = n.prev_;
+        ORDER_HANDLE next = n.next_;
+        if (prev == ORDER_HANDLE_NULL) head_ = next; else pool_->node(prev).next_ = next;
+        if (next == ORDER_HANDLE_NULL) tail_ = prev; else pool_->node(next).prev_ = prev;
+        --size_;
+        return next;
+    }
+
+    // Unlinks `handle` and returns its node to the pool. Returns the handle that followed it.
+    ORDER_HANDLE erase(ORDER_HANDLE handle) {
+        ORDER_HANDLE next = unlink(handle);
+        pool_->release(handle);
+        return next;
+    }
+
+    OrderNode& node(ORDER_HANDLE handle) { return pool_->node(handle); }
+    const OrderNode& node(ORDER_HANDLE handle) const { return pool_->node(handle); }
+    ORDER_HANDLE head() const { return head_; }
+    ORDER_HANDLE tail() const { return tail_; }
+
+    auto begin() { return Iterator<false>(pool_, head_); }
+    auto end() { return Iterator<false>(pool_, ORDER_HANDLE_NULL); }
+    [[nodiscard]] auto begin() const { return Iterator<true>(pool_, head_); }
+    [[nodiscard]] auto end() const { return Iterator<true>(pool_, ORDER_HANDLE_NULL); }
+
     void clear() {
-        orders_.clear();
-        index_.clear();
+        ORDER_HANDLE handle = head_;
+        while (handle != ORDER_HANDLE_NULL) {
+            ORDER_HANDLE next = pool_->node(handle).next_;
+            pool_->release(handle);
+            handle = next;
+        }
+        head_ = tail_ = ORDER_HANDLE_NULL;
+        size_ = 0;
     }
 
-    bool empty() const { return orders_.empty(); }
-    size_t size() const { return orders_.size(); }
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
 
 private:
-    std::list<LOBOrder> orders_;
-    std::unordered_map<ID_TYPE, std::list<LOBOrder>::iterator> index_;
+    OrderPool* pool_;
+    ORDER_HANDLE head_ = ORDER_HANDLE_NULL;
+    ORDER_HANDLE tail_ = ORDER_HANDLE_NULL;
+    size_t size_ = 0;
 };
 
 class Price {
 public:
-    const PRICE_TYPE price_;
+    PRICE_TYPE price_; // Not const: PriceLadder re-keys emptied levels when it reuses them.
     SIZE_TYPE total_quantity_ = 0;
+    std::uint64_t change_epoch_ = 0; // OrderBookCore change epoch in which this level was last journalled.
+    std::uint32_t change_slot_ = 0;  // Its journal entry within that epoch.
     OrderContainer container;
 
-    explicit Price(PRICE_TYPE price) : price_(price) {}
+    Price(PRICE_TYPE price, OrderPool& pool) : price_(price), container(pool) {}
 
     SIZE_TYPE get_total_quantity() const {
         return total_quantity_;
     }
 
-    LOBOrder* get_order(ID_TYPE target_uoid) {
-        return container.getOrder(target_uoid);
-    }
-    const LOBOrder* get_order(ID_TYPE target_uoid) const {
-        return container.getOrder(target_uoid);
-    }
-
     template <DOUBLEOPTION i>
-    std::list<LOBOrder>::iterator insert_order(ID_TYPE uoid, SIZE_TYPE quantity) {
-        std::list<LOBOrder>::iterator order_it;
+    ORDER_HANDLE insert_order(OrderPool& pool, ID_TYPE uoid, SIZE_TYPE quantity) {
+        ORDER_HANDLE handle = pool.acquire(uoid, quantity);
         if constexpr (i == DOUBLEOPTION::BACK) {
-            order_it = container.addOrder(uoid, quantity);
+            container.push_back(handle);
         } else if constexpr (i == DOUBLEOPTION::FRONT) {
-            order_it = container.addOrderToFront(uoid, quantity);
+            container.push_front(handle);
         }
         total_quantity_ += quantity;
-        return order_it;
+        return handle;
     }
 
-    std::list<LOBOrder>::iterator insert_order_at_position(std::list<LOBOrder>::iterator pos, ID_TYPE uoid, SIZE_TYPE quantity) {
-        auto order_it = container.addOrderAtPosition(pos, uoid, quantity);
+    ORDER_HANDLE insert_order_at_position(OrderPool& pool, ORDER_HANDLE pos, ID_TYPE uoid, SIZE_TYPE quantity) {
+        ORDER_HANDLE handle = pool.acquire(uoid, quantity);
+        container.insert_before(pos, handle);
         total_quantity_ += quantity;
-        return order_it;
+        return handle;
     }
 
-    std::optional<LOBOrder> remove_order_from_container(ID_TYPE uoid) {
-        std::optional<LOBOrder> removed_order_data = container.removeOrder(uoid);
-        if (removed_order_data) {
-            total_quantity_ -= removed_order_data->quantity_;
-        }
-        return removed_order_data;
+    // Removes the order behind `handle` from this level and returns its remaining quantity.
+    SIZE_TYPE remove_order_from_container(ORDER_HANDLE handle) {
+        SIZE_TYPE removed_quantity = container.node(handle).order.quantity_;
+        total_quantity_ -= removed_quantity;
+        container.erase(handle);
+        return removed_quantity;
     }
 
+    // Detaches the order at `handle` without releasing its pool node, for attach_order() on another level.
+    SIZE_TYPE detach_order(ORDER_HANDLE handle) {
+        SIZE_TYPE detached_quantity = container.node(handle).order.quantity_;
+        total_quantity_ -= detached_quantity;
+        container.unlink(handle);
+        return detached_quantity;
+    }
 
     template <DOUBLEOPTION i>
-    LOBClearResult clear_quantity(SIZE_TYPE& quantity_to_clear, std::vector<ID_TYPE>& exhausted_order_uoids_at_this_level) {
-        std::vector<LOBFillResult> trades;
-        exhausted_order_uoids_at_this_level.clear();
-
-        if constexpr (i == DOUBLEOPTION::FRONT) {
-            auto it = container.begin();
-            while (it != container.end() && quantity_to_clear > 0) {
-                LOBOrder& currentOrder = *it;
-                SIZE_TYPE tradeQuantity = std::min(quantity_to_clear, currentOrder.quantity_);
-
-                quantity_to_clear -= tradeQuantity;
-                currentOrder.quantity_ -= tradeQuantity;
-                total_quantity_ -= tradeQuantity;
-
-                bool exhausted = (currentOrder.quantity_ == 0);
-                trades.emplace_back(currentOrder.uoid_, tradeQuantity, exhausted);
-
-                if (exhausted) {
-                    exhausted_order_uoids_at_this_level.push_back(currentOrder.uoid_);
-                    it = container.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-        } else if constexpr (i == DOUBLEOPTION::BACK) {
-            auto it = container.rbegin();
-            while (it != container.rend() && quantity_to_clear > 0) {
-                LOBOrder& currentOrder = *it;
-                SIZE_TYPE tradeQuantity = std::min(quantity_to_clear, currentOrder.quantity_);
-
-                quantity_to_clear -= tradeQuantity;
-                currentOrder.quantity_ -= tradeQuantity;
-                total_quantity_ -= tradeQuantity;
-
-                bool exhausted = (currentOrder.quantity_ == 0);
-                trades.emplace_back(currentOrder.uoid_, tradeQuantity, exhausted);
-
-                if (exhausted) {
-                    exhausted_order_uoids_at_this_level.push_back(currentOrder.uoid_);
-                    auto fwd_iter_to_erase = std::prev(it.base());
-                    auto fwd_iter_after_erase = container.erase(fwd_iter_to_erase);
-                    it = std::reverse_iterator(fwd_iter_after_erase);
-                } else {
-                    ++it;
-                }
+    void attach_order(ORDER_HANDLE handle) {
+        if constexpr (i == DOUBLEOPTION::BACK) {
+            container.push_back(handle);
+        } else if constexpr (i == DOUBLEOPTION::FRONT) {
+            container.push_front(handle);
+        }
+        total_quantity_ += container.node(handle).order.quantity_;
+    }
+
+
+    // Fills resting orders from the FRONT or BACK of the queue. Exhausted orders are dropped from `locator`.
+    // Every fill is handed to `sink(maker_uoid, price, quantity, exhausted, maker_owner)` as it happens.
+    template <DOUBLEOPTION i, typename FillSink>
+    void clear_quantity(SIZE_TYPE& quantity_to_clear, OrderLocator& locator, FillSink&& sink) {
+        ORDER_HANDLE handle = (i == DOUBLEOPTION::FRONT) ? container.head() : container.tail();
+        while (handle != ORDER_HANDLE_NULL && quantity_to_clear > 0) {
+            OrderNode& node = container.node(handle);
+            ORDER_HANDLE following = (i == DOUBLEOPTION::FRONT) ? node.next_ : node.prev_;
+            LOBOrder& currentOrder = node.order;
+            SIZE_TYPE tradeQuantity = std::min(quantity_to_clear, currentOrder.quantity_);
+
+            quantity_to_clear -= tradeQuantity;
+            currentOrder.quantity_ -= tradeQuantity;
+            total_quantity_ -= tradeQuantity;
+
+            bool exhausted = (currentOrder.quantity_ == 0);
+            const OrderLocation* location = locator.find(currentOrder.uoid_);
+            assert(location != nullptr && "Price: resting order missing from the locator.");
+            sink(currentOrder.uoid_, price_, tradeQuantity, exhausted, location->owner_);
+
+            if (exhausted) {
+                locator.erase(currentOrder.uoid_);
+                container.erase(handle);
             }
+            handle = following;
         }
+    }
+
+    template <DOUBLEOPTION i>
+    LOBClearResult clear_quantity(SIZE_TYPE& quantity_to_clear, OrderLocator& locator) {
+        std::vector<LOBFillResult> trades;
+        clear_quantity<i>(quantity_to_clear, locator,
+                          [&trades](ID_TYPE uoid, PRICE_TYPE, SIZE_TYPE quantity, bool exhausted, const OrderOwner& owner) {
+                              trades.emplace_back(uoid, quantity, exhausted, owner);
+                          });
         return LOBClearResult(price_, std::move(trades));
     }
 
@@ -334,6 +644,22 @@ public:
 };
 
 
+// Read-only L3 view of one level: its price, aggregate quantity and resting orders in FIFO order, read in place
+// from the book. A view is valid until the book next changes.
+class L3LevelView {
+public:
+    explicit L3LevelView(const Price& level) : level_(&level) {}
+
+    PRICE_TYPE price() const { return level_->price_; }
+    SIZE_TYPE total_quantity() const { return level_->total_quantity_; }
+    size_t order_count() const { return level_->container.size(); }
+    auto begin() const { return level_->container.begin(); }
+    auto end() const { return level_->container.end(); }
+
+private:
+    const Price* level_;
+};
+
 struct PriceUniquePtrCompareAscending {
     using is_transparent = void;
     bool operator()(const std::unique_ptr<Price>& lhs, const std::unique_ptr<Price>& rhs) const {
@@ -361,36 +687,849 @@ struct PriceUniquePtrCompareDescending {
 };
 
 
+// Two-level occupancy bitmap over `size` slots: one bit per slot in 64-bit words, plus a summary bit per non-empty
+// word. Finding the next or previous occupied slot costs a countr_zero/countl_zero on at most one word per level,
+// plus a walk over summary words that only grows past one word beyond 4096 slots.
+class OccupancyBitmap {
+public:
+    static constexpr std::size_t NPOS = std::numeric_limits<std::size_t>::max();
+
+    explicit OccupancyBitmap(std::size_t size)
+            : words_((size + 63) / 64), summary_((words_.size() + 63) / 64) {}
+
+    void set(std::size_t i) {
+        words_[i >> 6] |= bit(i);
+        summary_[i >> 12] |= bit(i >> 6);
+    }
+
+    void reset(std::size_t i) {
+        std::uint64_t& word = words_[i >> 6];
+        word &= ~bit(i);
+        if (word == 0) {
+            summary_[i >> 12] &= ~bit(i >> 6);
+        }
+    }
+
+    void clear() {
+        std::fill(words_.begin(), words_.end(), 0);
+        std::fill(summary_.begin(), summary_.end(), 0);
+    }
+
+    // Lowest occupied slot >= i, or NPOS.
+    std::size_t find_next(std::size_t i) const {
+        std::size_t w = i >> 6;
+        if (w >= words_.size()) {
+            return NPOS;
+        }
+        if (std::uint64_t m = words_[w] & (~std::uint64_t{0} << (i & 63))) {
+            return (w << 6) + std::countr_zero(m);
+        }
+        std::size_t next_word = w + 1;
+        for (std::size_t s = next_word >> 6; s < summary_.size(); ++s) {
+            std::uint64_t m = summary_[s];
+            if (s == (next_word >> 6)) {
+                m &= (next_word & 63) ? (~std::uint64_t{0} << (next_word & 63)) : ~std::uint64_t{0};
+            }
+            if (m) {
+                std::size_t found = (s << 6) + std::countr_zero(m);
+                return (found << 6) + std::countr_zero(words_[found]);
+            }
+        }
+        return NPOS;
+    }
+
+    // Highest occupied slot <= i, or NPOS.
+    std::size_t find_prev(std::size_t i) const {
+        std::size_t w = i >> 6;
+        if (std::uint64_t m = words_[w] & (~std::uint64_t{0} >> (63 - (i & 63)))) {
+            return (w << 6) + 63 - std::countl_zero(m);
+        }
+        if (w == 0) {
+            return NPOS;
+        }
+        std::size_t prev_word = w - 1;
+        for (std::size_t s = (prev_word >> 6) + 1; s-- > 0;) {
+            std::uint64_t m = summary_[s];
+            if (s == (prev_word >> 6)) {
+                m &= ~std::uint64_t{0} >> (63 - (prev_word & 63));
+            }
+            if (m) {
+                std::size_t found = (s << 6) + 63 - std::countl_zero(m);
+                return (found << 6) + 63 - std::countl_zero(words_[found]);
+            }
+        }
+        return NPOS;
+    }
+
+private:
+    static std::uint64_t bit(std::size_t i) { return std::uint64_t{1} << (i & 63); }
+
+    std::vector<std::uint64_t> words_;
+    std::vector<std::uint64_t> summary_;
+};
+
+
+// Price levels kept in a ring-buffered array indexed by tick. A level at tick t (= price / TickSize) lives in
+// slot t & (capacity - 1), so lookup, insert and erase of a level are O(1). The occupied ticks [lo_, hi_]
+// may sit anywhere on the price axis; as the book drifts the window simply moves around the ring and no
+// level is ever copied. The array only doubles (and re-slots its levels) when the spread between the
+// worst and best occupied level outgrows it. Emptied Price objects are kept for reuse, so steady-state
+// level churn does not allocate either.
+//
+// Exposes the subset of the std::set interface OrderBookCore uses: iteration best-to-worst in Comp order
+// (dereferencing to const std::unique_ptr<Price>&), find, erase(iterator), size, empty and clear.
+template <typename Comp, PRICE_TYPE TickSize, std::size_t InitialTicks>
+class PriceLadder {
+    static_assert(TickSize > 0, "PriceLadder: TickSize must be positive.");
+    static_assert(InitialTicks > 0 && (InitialTicks & (InitialTicks - 1)) == 0, "PriceLadder: InitialTicks must be a power of two.");
+    static constexpr bool ASCENDING = std::is_same_v<Comp, PriceUniquePtrCompareAscending>;
+
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::unique_ptr<Price>;
+        using difference_type = std::ptrdiff_t;
+        using reference = const std::unique_ptr<Price>&;
+        using pointer = const std::unique_ptr<Price>*;
+
+        iterator() = default;
+        iterator(const PriceLadder* ladder, PRICE_TYPE tick) : ladder_(ladder), tick_(tick) {}
+
+        reference operator*() const { return ladder_->slot(tick_); }
+        pointer operator->() const { return &ladder_->slot(tick_); }
+        iterator& operator++() { tick_ = ladder_->next_occupied_after(tick_); return *this; }
+        iterator operator++(int) { iterator tmp = *this; ++(*this); return tmp; }
+        bool operator==(const iterator& other) const { return tick_ == other.tick_; }
+        bool operator!=(const iterator& other) const { return tick_ != other.tick_; }
+
+    private:
+        friend class PriceLadder;
+        const PriceLadder* ladder_ = nullptr;
+        PRICE_TYPE tick_ = END_TICK;
+    };
+    using const_iterator = iterator;
+
+    PriceLadder() : slots_(InitialTicks), occupied_(InitialTicks) {}
+    PriceLadder(const PriceLadder&) = delete;
+    PriceLadder& operator=(const PriceLadder&) = delete;
+
+    iterator begin() const { return iterator(this, count_ == 0 ? END_TICK : best_tick()); }
+    iterator end() const { return iterator(this, END_TICK); }
+
+    iterator find(PRICE_TYPE price) const {
+        PRICE_TYPE tick = to_tick(price);
+        if (count_ == 0 || tick < lo_ || tick > hi_ || !slot(tick)) {
+            return end();
+        }
+        return iterator(this, tick);
+    }
+
+    iterator erase(iterator pos) {
+        PRICE_TYPE tick = pos.tick_;
+        iterator next(this, next_occupied_after(tick));
+        std::unique_ptr<Price>& level = slot(tick);
+        level->container.clear();
+        level->total_quantity_ = 0;
+        level->change_epoch_ = 0;
+        spare_levels_.push_back(std::move(level));
+        occupied_.reset(slot_index(tick));
+        if (--count_ > 0) {
+            if (tick == lo_) lo_ = scan_up(lo_ + 1);
+            if (tick == hi_) hi_ = scan_down(hi_ - 1);
+        }
+        return next;
+    }
+
+    // Returns the level for `price`, creating it (from a recycled Price when one is available) if absent.
+    Price* find_or_create(PRICE_TYPE price, OrderPool& pool) {
+        PRICE_TYPE tick = to_tick(price);
+        if (count_ == 0) {
+            lo_ = hi_ = tick;
+        } else if (tick < lo_ || tick > hi_) {
+            PRICE_TYPE new_lo = std::min(lo_, tick);
+            PRICE_TYPE new_hi = std::max(hi_, tick);
+            if (static_cast<std::size_t>(new_hi - new_lo) >= slots_.size()) {
+                grow(static_cast<std::size_t>(new_hi - new_lo) + 1);
+            }
+            lo_ = new_lo;
+            hi_ = new_hi;
+        }
+        std::unique_ptr<Price>& level = slot(tick);
+        if (!level) {
+            if (!spare_levels_.empty()) {
+                level = std::move(spare_levels_.back());
+                spare_levels_.pop_back();
+                level->price_ = price;
+            } else {
+                level = std::make_unique<Price>(price, pool);
+            }
+            occupied_.set(slot_index(tick));
+            ++count_;
+        }
+        return level.get();
+    }
+
+    void clear() {
+        for (auto& level : slots_) {
+            level.reset();
+        }
+        spare_levels_.clear();
+        occupied_.clear();
+        count_ = 0;
+    }
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    static constexpr PRICE_TYPE END_TICK = std::numeric_limits<PRICE_TYPE>::min();
+
+    static PRICE_TYPE to_tick(PRICE_TYPE price) {
+        assert(price % TickSize == 0 && "PriceLadder: price is not on the tick grid.");
+        return price / TickSize;
+    }
+
+    std::size_t slot_index(PRICE_TYPE tick) const {
+        return static_cast<std::size_t>(tick) & (slots_.size() - 1);
+    }
+
+    std::unique_ptr<Price>& slot(PRICE_TYPE tick) {
+        return slots_[slot_index(tick)];
+    }
+    const std::unique_ptr<Price>& slot(PRICE_TYPE tick) const {
+        return slots_[slot_index(tick)];
+    }
+
+    PRICE_TYPE best_tick() const { return ASCENDING ? lo_ : hi_; }
+
+    // First occupied tick at or above / at or below `tick`; one must exist within the ring. The slots form a ring,
+    // so a search that runs off one end continues from the other.
+    PRICE_TYPE scan_up(PRICE_TYPE tick) const {
+        std::size_t from = slot_index(tick);
+        std::size_t found = occupied_.find_next(from);
+        if (found == OccupancyBitmap::NPOS) {
+            found = occupied_.find_next(0);
+        }
+        return tick + static_cast<PRICE_TYPE>((found - from) & (slots_.size() - 1));
+    }
+    PRICE_TYPE scan_down(PRICE_TYPE tick) const {
+        std::size_t from = slot_index(tick);
+        std::size_t found = occupied_.find_prev(from);
+        if (found == OccupancyBitmap::NPOS) {
+            found = occupied_.find_prev(slots_.size() - 1);
+        }
+        return tick - static_cast<PRICE_TYPE>((from - found) & (slots_.size() - 1));
+    }
+
+    // Next occupied tick after `tick` in iteration (best-to-worst) order, or END_TICK.
+    PRICE_TYPE next_occupied_after(PRICE_TYPE tick) const {
+        if constexpr (ASCENDING) {
+            return tick >= hi_ ? END_TICK : scan_up(tick + 1);
+        } else {
+            return tick <= lo_ ? END_TICK : scan_down(tick - 1);
+        }
+    }
+
+    void grow(std::size_t min_slots) {
+        std::size_t new_size = slots_.size();
+        while (new_size < min_slots) new_size *= 2;
+        std::vector<std::unique_ptr<Price>> new_slots(new_size);
+        OccupancyBitmap new_occupied(new_size);
+        if (count_ > 0) {
+            for (PRICE_TYPE tick = lo_;; tick = scan_up(tick + 1)) {
+                new_slots[static_cast<std::size_t>(tick) & (new_size - 1)] = std::move(slot(tick));
+                new_occupied.set(static_cast<std::size_t>(tick) & (new_size - 1));
+                if (tick == hi_) break;
+            }
+        }
+        slots_ = std::move(new_slots);
+        occupied_ = std::move(new_occupied);
+    }
+
+    std::vector<std::unique_ptr<Price>> slots_;
+    OccupancyBitmap occupied_;
+    std::vector<std::unique_ptr<Price>> spare_levels_;
+    std::size_t count_ = 0;
+    PRICE_TYPE lo_ = 0;
+    PRICE_TYPE hi_ = 0;
+};
+
+
+// Cumulative-quantity index over the levels of one side, ordered best price first. It is an array-backed treap
+// whose nodes carry subtree quantity and notional sums, so prefix queries by price or by cumulative quantity
+// cost O(log levels) regardless of how the levels themselves are stored.
+class DepthIndex {
+public:
+    explicit DepthIndex(bool best_is_highest) : best_is_highest_(best_is_highest) {}
+
+    // Sets the quantity held at `price`; 0 removes the level.
+    void set(PRICE_TYPE price, SIZE_TYPE quantity) {
+        if (quantity > 0) {
+            if (!assign(root_, price, quantity)) {
+                root_ = insert(root_, make_node(price, quantity));
+            }
+        } else {
+            root_ = erase(root_, price);
+        }
+    }
+
+    void clear() {
+        nodes_.clear();
+        free_nodes_.clear();
+        root_ = NIL;
+    }
+
+    SIZE_TYPE total_quantity() const {
+        return quantity_sum(root_);
+    }
+
+    // Quantity resting at `price` or better.
+    SIZE_TYPE quantity_through(PRICE_TYPE price) const {
+        SIZE_TYPE quantity = 0;
+        std::uint32_t t = root_;
+        while (t != NIL) {
+            const Node& n = nodes_[t];
+            if (better(price, n.price_)) {
+                t = n.left_;
+            } else {
+                quantity += quantity_sum(n.left_) + n.quantity_;
+                t = n.right_;
+            }
+        }
+        return quantity;
+    }
+
+    // Sum of price * quantity over the best `quantity` units, or nullopt if the side holds less than that.
+    std::optional<PRICE_TYPE> notional_for_quantity(SIZE_TYPE quantity) const {
+        if (quantity <= 0) return PRICE_TYPE{0};
+        if (quantity > total_quantity()) return std::nullopt;
+        PRICE_TYPE notional = 0;
+        std::uint32_t t = root_;
+        while (t != NIL) {
+            const Node& n = nodes_[t];
+            SIZE_TYPE left_quantity = quantity_sum(n.left_);
+            if (quantity <= left_quantity) {
+                t = n.left_;
+                continue;
+            }
+            notional += notional_sum(n.left_);
+            quantity -= left_quantity;
+            if (quantity <= n.quantity_) {
+                return notional + quantity * n.price_;
+            }
+            notional += n.quantity_ * n.price_;
+            quantity -= n.quantity_;
+            t = n.right_;
+        }
+        return notional;
+    }
+
+    // Price of the level at which the cumulative quantity from the best price first reaches `quantity`,
+    // or nullopt if the side holds less than that.
+    std::optional<PRICE_TYPE> price_at_depth(SIZE_TYPE quantity) const {
+        if (root_ == NIL || quantity > total_quantity()) return std::nullopt;
+        quantity = std::max<SIZE_TYPE>(quantity, 1);
+        std::uint32_t t = root_;
+        while (true) {
+            const Node& n = nodes_[t];
+            SIZE_TYPE left_quantity = quantity_sum(n.left_);
+            if (quantity <= left_quantity) {
+                t = n.left_;
+            } else if (quantity <= left_quantity + n.quantity_) {
+                return n.price_;
+            } else {
+                quantity -= left_quantity + n.quantity_;
+                t = n.right_;
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint32_t NIL = std::numeric_limits<std::uint32_t>::max();
+
+    struct Node {
+        PRICE_TYPE price_;
+        SIZE_TYPE quantity_;
+        SIZE_TYPE quantity_sum_;
+        PRICE_TYPE notional_sum_;
+        std::uint32_t priority_;
+        std::uint32_t left_;
+        std::uint32_t right_;
+    };
+
+    bool better(PRICE_TYPE a, PRICE_TYPE b) const {
+        return best_is_highest_ ? a > b : a < b;
+    }
+
+    SIZE_TYPE quantity_sum(std::uint32_t t) const { return t == NIL ? 0 : nodes_[t].quantity_sum_; }
+    PRICE_TYPE notional_sum(std::uint32_t t) const { return t == NIL ? 0 : nodes_[t].notional_sum_; }
+
+    void pull(std::uint32_t t) {
+        Node& n = nodes_[t];
+        n.quantity_sum_ = quantity_sum(n.left_) + n.quantity_ + quantity_sum(n.right_);
+        n.notional_sum_ = notional_sum(n.left_) + n.quantity_ * n.price_ + notional_sum(n.right_);
+    }
+
+    std::uint32_t make_node(PRICE_TYPE price, SIZE_TYPE quantity) {
+        // xorshift32; the treap only needs priorities that are independent of the keys.
+        rng_state_ ^= rng_state_ << 13;
+        rng_state_ ^= rng_state_ >> 17;
+        rng_state_ ^= rng_state_ << 5;
+        Node node{price, quantity, quantity, quantity * price, rng_state_, NIL, NIL};
+        if (!free_nodes_.empty()) {
+            std::uint32_t t = free_nodes_.back();
+            free_nodes_.pop_back();
+            nodes_[t] = node;
+            return t;
+        }
+        nodes_.push_back(node);
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    bool assign(std::uint32_t t, PRICE_TYPE price, SIZE_TYPE quantity) {
+        if (t == NIL) return false;
+        Node& n = nodes_[t];
+        bool found;
+        if (n.price_ == price) {
+            n.quantity_ = quantity;
+            found = true;
+        } else {
+            found = assign(better(price, n.price_) ? n.left_ : n.right_, price, quantity);
+        }
+        if (found) pull(t);
+        return found;
+    }
+
+    // Splits `t` into the levels better than `price` (left) and the rest (right).
+    void split(std::uint32_t t, PRICE_TYPE price, std::uint32_t& left, std::uint32_t& right) {
+        if (t == NIL) {
+            left = right = NIL;
+            return;
+        }
+        if (better(nodes_[t].price_, price)) {
+            split(nodes_[t].right_, price, nodes_[t].right_, right);
+            left = t;
+        } else {
+            split(nodes_[t].left_, price, left, nodes_[t].left_);
+            right = t;
+        }
+        pull(t);
+    }
+
+    std::uint32_t merge(std::uint32_t left, std::uint32_t right) {
+        if (left == NIL) return right;
+        if (right == NIL) return left;
+        if (nodes_[left].priority_ > nodes_[right].priority_) {
+            nodes_[left].right_ = merge(nodes_[left].right_, right);
+            pull(left);
+            return left;
+        }
+        nodes_[right].left_ = merge(left, nodes_[right].left_);
+        pull(right);
+        return right;
+    }
+
+    std::uint32_t insert(std::uint32_t t, std::uint32_t n) {
+        if (t == NIL) return n;
+        if (nodes_[n].priority_ > nodes_[t].priority_) {
+            split(t, nodes_[n].price_, nodes_[n].left_, nodes_[n].right_);
+            pull(n);
+            return n;
+        }
+        if (better(nodes_[n].price_, nodes_[t].price_)) {
+            nodes_[t].left_ = insert(nodes_[t].left_, n);
+        } else {
+            nodes_[t].right_ = insert(nodes_[t].right_, n);
+        }
+        pull(t);
+        return t;
+    }
+
+    std::uint32_t erase(std::uint32_t t, PRICE_TYPE price) {
+        if (t == NIL) return NIL;
+        Node& n = nodes_[t];
+        if (n.price_ == price) {
+            std::uint32_t merged = merge(n.left_, n.right_);
+            free_nodes_.push_back(t);
+            return merged;
+        }
+        if (better(price, n.price_)) {
+            n.left_ = erase(n.left_, price);
+        } else {
+            n.right_ = erase(n.right_, price);
+        }
+        pull(t);
+        return t;
+    }
+
+    bool best_is_highest_;
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_nodes_;
+    std::uint32_t root_ = NIL;
+    std::uint32_t rng_state_ = 2463534242u;
+};
+
+
+// Level storage policies for OrderBookCore. SetLevels keeps each side in an ordered std::set and suits sparse
+// or unbounded price grids; LadderLevels uses the array-indexed PriceLadder for dense tick grids.
+struct SetLevels {
+    template <typename Comp>
+    using Book = std::set<std::unique_ptr<Price>, Comp>;
+};
+
+template <PRICE_TYPE TickSize = 1, std::size_t InitialTicks = 1024>
+struct BasicLadderLevels {
+    template <typename Comp>
+    using Book = PriceLadder<Comp, TickSize, InitialTicks>;
+};
+
+using LadderLevels = BasicLadderLevels<>;
+
+
+template <typename LevelPolicy>
+class OrderBookFork;
+
+template <typename LevelPolicy = SetLevels>
 class OrderBookCore {
 private:
-    static ID_TYPE next_uoid_;
+    // UOIDs are allocated per book from its own ID space, so independent books share no state.
+    ID_TYPE uoid_base_ = 0;
+    ID_TYPE next_uoid_ = 1;
 
     const PriceUniquePtrCompareAscending comp_asc_unique_ptr_{};
     const PriceUniquePtrCompareDescending comp_desc_unique_ptr_{};
 
-    std::set<std::unique_ptr<Price>, PriceUniquePtrCompareDescending> buy_prices_;
-    std::set<std::unique_ptr<Price>, PriceUniquePtrCompareAscending> sell_prices_;
-    std::unordered_map<ID_TYPE, Price*> uoid_to_price_;
+    // Declared before the level sets so it outlives the Price levels whose nodes it holds.
+    std::unique_ptr<OrderPool> order_pool_ = std::make_unique<OrderPool>();
+    typename LevelPolicy::template Book<PriceUniquePtrCompareDescending> buy_prices_;
+    typename LevelPolicy::template Book<PriceUniquePtrCompareAscending> sell_prices_;
+    OrderLocator locator_;
+
+    // Journal of level changes since the last clear_level_changes(), in the order levels were first touched.
+    // Each level has one entry per epoch holding its latest quantity; a level erased and re-created within one
+    // epoch gets a second entry, so entries must be applied in order.
+    std::uint64_t change_epoch_ = 1;
+    std::vector<LevelChange> level_changes_;
+
+    // Optional journal of order-level changes since the last clear_order_changes(), in the order they happened.
+    bool order_journal_enabled_ = false;
+    std::vector<OrderChange> order_changes_;
+
+    // Optional top-N depth cache per side, flattened like get_state_l2(). Rebuilt lazily on read and
+    // invalidated only by changes at or better than the worst cached level.
+    size_t depth_cache_levels_ = 0;
+    mutable std::vector<PRICE_SIZE_TYPE> bid_depth_cache_;
+    mutable std::vector<PRICE_SIZE_TYPE> ask_depth_cache_;
+    mutable bool bid_depth_cache_valid_ = false;
+    mutable bool ask_depth_cache_valid_ = false;
+
+    // Cumulative depth per side, kept in step with every level quantity change for the volume/price queries.
+    DepthIndex bid_depth_index_{true};
+    DepthIndex ask_depth_index_{false};
+
+    template <typename CompUniquePtr>
+    static constexpr SIDE side_of() {
+        return std::is_same_v<CompUniquePtr, PriceUniquePtrCompareDescending> ? SIDE::BID : SIDE::ASK;
+    }
+
+    template <typename CompUniquePtr>
+    static constexpr SIDE counter_side_of() {
+        return side_of<CompUniquePtr>() == SIDE::BID ? SIDE::ASK : SIDE::BID;
+    }
+
+    // Must be called for every level whose total quantity changes, before the level is possibly erased.
+    void note_level_change(SIDE side, Price& level) {
+        if (level.change_epoch_ == change_epoch_) {
+            level_changes_[level.change_slot_].new_quantity_ = level.total_quantity_;
+        } else {
+            level.change_epoch_ = change_epoch_;
+            level.change_slot_ = static_cast<std::uint32_t>(level_changes_.size());
+            level_changes_.push_back({side, level.price_, level.total_quantity_});
+        }
+
+        const bool is_bid = (side == SIDE::BID);
+        (is_bid ? bid_depth_index_ : ask_depth_index_).set(level.price_, level.total_quantity_);
+
+        bool& valid = is_bid ? bid_depth_cache_valid_ : ask_depth_cache_valid_;
+        if (!valid) {
+            return;
+        }
+        const std::vector<PRICE_SIZE_TYPE>& cache = is_bid ? bid_depth_cache_ : ask_depth_cache_;
+        if (cache.size() < depth_cache_levels_ * 2) {
+            valid = false; // Cache holds the whole side, so any change is visible.
+            return;
+        }
+        PRICE_TYPE worst_cached = cache[cache.size() - 2];
+        if (is_bid ? level.price_ >= worst_cached : level.price_ <= worst_cached) {
+            valid = false;
+        }
+    }
+
+    void note_order_change(OrderChange::Type type, SIDE side, ID_TYPE uoid, PRICE_TYPE price, SIZE_TYPE quantity) {
+        if (order_journal_enabled_) {
+            order_changes_.push_back({type, side, uoid, price, quantity});
+        }
+    }
+
+    // Journals the order just linked at `handle` together with the order it was queued in front of.
+    void note_order_added(SIDE side, const Price& level, ORDER_HANDLE handle) {
+        if (!order_journal_enabled_) {
+            return;
+        }
+        const OrderNode& node = order_pool_->node(handle);
+        ID_TYPE before = (node.next_ == ORDER_HANDLE_NULL) ? ID_DEFAULT : order_pool_->node(node.next_).order.uoid_;
+        order_changes_.push_back({OrderChange::Type::ADD, side, node.order.uoid_, level.price_, node.order.quantity_, before});
+    }
+
+    // Wraps a fill sink so that fills against resting orders on `side` are journalled as EXECUTE changes.
+    template <typename FillSink>
+    auto executing_sink(SIDE side, FillSink& sink) {
+        return [this, side, &sink](ID_TYPE uoid, PRICE_TYPE price, SIZE_TYPE quantity, bool exhausted, const OrderOwner& owner) {
+            note_order_change(OrderChange::Type::EXECUTE, side, uoid, price, quantity);
+            sink(uoid, price, quantity, exhausted, owner);
+        };
+    }
+
+    template <typename BookType>
+    static void append_l3_levels(const BookType& book, size_t max_depth, std::vector<L3LevelView>& out) {
+        out.reserve(std::min(book.size(), max_depth));
+        for (auto it = book.begin(); it != book.end() && max_depth > 0; ++it, --max_depth) {
+            out.emplace_back(**it);
+        }
+    }
+
+    template <typename CompUniquePtr>
+    const DepthIndex& counter_depth_index() const {
+        return counter_side_of<CompUniquePtr>() == SIDE::BID ? bid_depth_index_ : ask_depth_index_;
+    }
+
+    template <typename BookType>
+    static void append_levels(const BookType& book, size_t max_depth, std::vector<PRICE_SIZE_TYPE>& out) {
+        out.reserve(std::min(book.size(), max_depth) * 2);
+        for (auto it = book.begin(); it != book.end() && max_depth > 0; ++it, --max_depth) {
+            out.push_back((*it)->price_);
+            out.push_back((*it)->get_total_quantity());
+        }
+    }
+
+    template <typename BookType>
+    const std::vector<PRICE_SIZE_TYPE>& depth_cache(const BookType& book, std::vector<PRICE_SIZE_TYPE>& cache, bool& valid) const {
+        if (!valid) {
+            cache.clear();
+            append_levels(book, depth_cache_levels_, cache);
+            valid = true;
+        }
+        return cache;
+    }
+
+    template <typename BookType>
+    static std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> top_of(const BookType& book) {
+        if (book.empty()) {
+            return std::nullopt;
+        }
+        const Price& best = **book.begin();
+        return std::make_pair(best.price_, best.get_total_quantity());
+    }
+
+    template<typename BookType>
+    Price* find_or_create_price_level(BookType& book, PRICE_TYPE price) {
+        if constexpr (std::is_same_v<LevelPolicy, SetLevels>) {
+            auto it = book.lower_bound(price);
+            if (it != book.end() && (*it)->price_ == price) {
+                return it->get();
+            }
+            auto new_price_obj_uptr = std::make_unique<Price>(price, *order_pool_);
+            Price* pricenode_ptr = new_price_obj_uptr.get();
+            book.insert(it, std::move(new_price_obj_uptr));
+            return pricenode_ptr;
+        } else {
+            return book.find_or_create(price, *order_pool_);
+        }
+    }
+
+    // Unlinks a resting order from its level and drops it from the locator. Returns its remaining quantity.
+    // `location` refers into the locator and must not be used afterwards.
+    SIZE_TYPE unlink_order(ID_TYPE uoid, const OrderLocation& location) {
+        Price* pricenode = location.level_;
+        ORDER_HANDLE handle = location.node_;
+        SIDE side = location.side_;
+        locator_.erase(uoid);
+        SIZE_TYPE removed_quantity = pricenode->remove_order_from_container(handle);
+        note_order_change(OrderChange::Type::DELETE, side, uoid, pricenode->price_, removed_quantity);
+        return removed_quantity;
+    }
+
+
+    // Moves the resting order at `location` to the FRONT or BACK of the level for `new_price` with `new_volume`,
+    // splicing its pool node across instead of releasing and re-acquiring one. The order is re-keyed in the
+    // locator only if `new_uoid` differs from `uoid`. Returns whether the old level was erased.
+    template <typename CompUniquePtr, DOUBLEOPTION Position>
+    bool splice_order(ID_TYPE uoid, OrderLocation* location, PRICE_TYPE new_price, SIZE_TYPE new_volume, ID_TYPE new_uoid) {
+        constexpr SIDE side = side_of<CompUniquePtr>();
+        Price* old_level = location->level_;
+        ORDER_HANDLE handle = location->node_;
+        PRICE_TYPE old_price = old_level->price_;
+
+        SIZE_TYPE old_volume = old_level->detach_order(handle);
+        note_order_change(OrderChange::Type::DELETE, side, uoid, old_price, old_volume);
+        note_level_change(side, *old_level);
+
+        LOBOrder& order = order_pool_->node(handle).order;
+        order.uoid_ = new_uoid;
+        order.quantity_ = new_volume;
+        Price* new_level = find_or_create_price_level(get_orderbook<CompUniquePtr>(), new_price);
+        new_level->template attach_order<Position>(handle);
+        if (new_uoid == uoid) {
+            location->level_ = new_level;
+        } else {
+            OrderOwner owner = location->owner_;
+            locator_.erase(uoid);
+            locator_.insert(new_uoid, {new_level, handle, side, owner});
+        }
+        note_level_change(side, *new_level);
+        note_order_added(side, *new_level, handle);
+
+        if (old_level != new_level && old_level->get_total_quantity() == 0) {
+            erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), old_price);
+            return true;
+        }
+        return false;
+    }
+
+    // Sink that groups fills into one LOBClearResult per level, for the vector-returning matching overloads.
+    static auto clearing_collector(std::vector<LOBClearResult>& clearings) {
+        return [&clearings](ID_TYPE uoid, PRICE_TYPE price, SIZE_TYPE quantity, bool exhausted, const OrderOwner& owner) {
+            if (clearings.empty() || clearings.back().price_ != price) {
+                clearings.emplace_back(price, std::vector<LOBFillResult>{});
+            }
+            clearings.back().trades_.emplace_back(uoid, quantity, exhausted, owner);
+        };
+    }
+
+    template<typename BookType>
+    void erase_price_level_if_empty(BookType& book, PRICE_TYPE price_key) {
+        auto it_to_erase = book.find(price_key);
+        if (it_to_erase != book.end() && (*it_to_erase)->get_total_quantity() == 0) {
+            book.erase(it_to_erase);
+        }
+    }
+
+    // One resting order in a checkpoint image; levels list their orders in FIFO order.
+    struct CheckpointOrder {
+        ID_TYPE uoid_;
+        SIZE_TYPE quantity_;
+        std::uint64_t trader_id_;
+        std::uint64_t client_order_id_;
+    };
+
+    static constexpr std::uint32_t CHECKPOINT_MAGIC = 0x4B43424F; // "OBCK"
+    static constexpr std::uint32_t CHECKPOINT_VERSION = 1;
+
+    template <typename BookType>
+    void save_side(std::ostream& out, const BookType& book) const {
+        checkpoint_write(out, static_cast<std::uint64_t>(book.size()));
+        std::vector<CheckpointOrder> records;
+        for (const auto& level : book) {
+            records.clear();
+            for (const LOBOrder& order : level->container) {
+                const OrderLocation* location = locator_.find(order.uoid_);
+                records.push_back({order.uoid_, order.quantity_, location->owner_.trader_id_, location->owner_.client_order_id_});
+            }
+            checkpoint_write(out, level->price_);
+            checkpoint_write(out, static_cast<std::uint64_t>(records.size()));
+            out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CheckpointOrder)));
+        }
+    }
+
+    template <typename CompUniquePtr>
+    bool load_side(std::istream& in, std::vector<CheckpointOrder>& records) {
+        std::uint64_t level_count = 0;
+        if (!checkpoint_read(in, level_count)) return false;
+        auto& book = get_orderbook<CompUniquePtr>();
+        for (std::uint64_t l = 0; l < level_count; ++l) {
+            PRICE_TYPE price = 0;
+            std::uint64_t order_count = 0;
+            if (!checkpoint_read(in, price) || !checkpoint_read(in, order_count) || order_count == 0) return false;
+            records.resize(order_count);
+            in.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(order_count * sizeof(CheckpointOrder)));
+            if (!in) return false;
+
+            Price* level = find_or_create_price_level(book, price);
+            for (const CheckpointOrder& record : records) {
+                if (record.quantity_ <= 0 || record.uoid_ <= uoid_base_ || record.uoid_ >= next_uoid_ || locator_.find(record.uoid_)) {
+                    return false;
+                }
+                ORDER_HANDLE handle = level->template insert_order<DOUBLEOPTION::BACK>(*order_pool_, record.uoid_, record.quantity_);
+                locator_.insert(record.uoid_, {level, handle, side_of<CompUniquePtr>(), OrderOwner{record.trader_id_, record.client_order_id_}});
+                note_order_added(side_of<CompUniquePtr>(), *level, handle);
+            }
+            note_level_change(side_of<CompUniquePtr>(), *level);
+        }
+        return true;
+    }
+
+public:
+    OrderBookCore() = default;
+
+    // A book whose UOIDs are drawn from ID space `id_space` (see uoid_space_base), e.g. one space per symbol.
+    explicit OrderBookCore(ID_TYPE id_space)
+            : uoid_base_(uoid_space_base(id_space)), next_uoid_(uoid_base_ + 1), locator_(uoid_base_) {}
+
+    ID_TYPE get_uoid_base() const {
+        return uoid_base_;
+    }
 
+    // Writes the resting orders (per level, in FIFO order, with UOIDs and owners) and the UOID counter as a binary
+    // image for load_checkpoint().
+    void save_checkpoint(std::ostream& out) const {
+        checkpoint_write(out, CHECKPOINT_MAGIC);
+        checkpoint_write(out, CHECKPOINT_VERSION);
+        checkpoint_write(out, uoid_base_);
+        checkpoint_write(out, next_uoid_);
+        checkpoint_write(out, static_cast<std::uint64_t>(locator_.size()));
+        save_side(out, buy_prices_);
+        save_side(out, sell_prices_);
+    }
 
+    // Replaces the book with a save_checkpoint() image written by a book in the same ID space, bulk-loading the
+    // orders into a pool reserved up front. Returns false, leaving an empty book, if the image is malformed; a
+    // header that does not match leaves the book untouched.
+    bool load_checkpoint(std::istream& in) {
+        std::uint32_t magic = 0, version = 0;
+        ID_TYPE uoid_base = 0, next_uoid = 0;
+        std::uint64_t order_count = 0;
+        if (!checkpoint_read(in, magic) || magic != CHECKPOINT_MAGIC ||
+            !checkpoint_read(in, version) || version != CHECKPOINT_VERSION ||
+            !checkpoint_read(in, uoid_base) || uoid_base != uoid_base_ ||
+            !checkpoint_read(in, next_uoid) || next_uoid <= uoid_base ||
+            !checkpoint_read(in, order_count)) {
+            return false;
+        }
 
-    template<typename BookType>
-    void erase_price_level_if_empty(BookType& book, PRICE_TYPE price_key) {
-        auto it_to_erase = book.find(price_key);
-        if (it_to_erase != book.end() && (*it_to_erase)->get_total_quantity() == 0) {
-            book.erase(it_to_erase);
+        flush();
+        next_uoid_ = next_uoid;
+        order_pool_->reserve(static_cast<std::size_t>(order_count));
+        std::vector<CheckpointOrder> records;
+        if (!load_side<PriceUniquePtrCompareDescending>(in, records) || !load_side<PriceUniquePtrCompareAscending>(in, records) ||
+            locator_.size() != order_count) {
+            flush();
+            return false;
         }
+        return true;
     }
 
-public:
-    OrderBookCore() = default;
+    // What-if view of this book; see OrderBookFork. Copies nothing, so it is cheap to create and discard.
+    OrderBookFork<LevelPolicy> fork() const {
+        return OrderBookFork<LevelPolicy>(*this);
+    }
 
     ID_TYPE generate_uoid() {
         return next_uoid_++;
     }
 
     size_t get_num_orders() const {
-        return uoid_to_price_.size();
+        return locator_.size();
     }
 
     template <typename CompUniquePtr>
@@ -430,27 +1569,25 @@ public:
     }
 
 
-    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority>
-    std::tuple<SIZE_TYPE, std::vector<LOBClearResult>> limit_match_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity) {
-        std::vector<LOBClearResult> clearings;
+    // Fill-visitor matching: `sink(maker_uoid, price, quantity, exhausted, maker_owner)` is invoked inline for
+    // every fill, best level first, and the unfilled quantity is returned. Nothing is allocated on this path
+    // unless the sink itself allocates. The sink must not modify this book.
+    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority, typename FillSink>
+    SIZE_TYPE limit_match_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity, FillSink&& sink) {
         auto price_val_comparator = get_counter_price_val_comparator<CompUniquePtr>();
         auto& counter_book = get_counter_orderbook<CompUniquePtr>();
 
-        std::vector<ID_TYPE> exhausted_uoids_from_level;
+        auto journalled_sink = executing_sink(counter_side_of<CompUniquePtr>(), sink);
 
         auto it = counter_book.begin();
         while (it != counter_book.end() && quantity > 0 && price_val_comparator((*it)->price_, price)) {
             Price* price_node = it->get();
-            exhausted_uoids_from_level.clear();
-            LOBClearResult result = price_node->template clear_quantity<FillOrderPriority>(quantity, exhausted_uoids_from_level);
-
-            if(!result.trades_.empty()){
-                clearings.push_back(std::move(result));
-            }
-
-            for (ID_TYPE uoid_to_remove : exhausted_uoids_from_level) {
-                uoid_to_price_.erase(uoid_to_remove);
+            if (order_journal_enabled_) {
+                price_node->template clear_quantity<FillOrderPriority>(quantity, locator_, journalled_sink);
+            } else {
+                price_node->template clear_quantity<FillOrderPriority>(quantity, locator_, sink);
             }
+            note_level_change(counter_side_of<CompUniquePtr>(), *price_node);
 
             if (price_node->get_total_quantity() == 0) {
                 it = counter_book.erase(it);
@@ -458,88 +1595,98 @@ public:
                 ++it;
             }
         }
-        return {quantity, std::move(clearings)};
+        return quantity;
+    }
+
+    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority>
+    std::tuple<SIZE_TYPE, std::vector<LOBClearResult>> limit_match_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity) {
+        std::vector<LOBClearResult> clearings;
+        SIZE_TYPE remaining = limit_match_price_quantity<CompUniquePtr, FillOrderPriority>(price, quantity, clearing_collector(clearings));
+        return {remaining, std::move(clearings)};
     }
 
     template <typename CompUniquePtr, DOUBLEOPTION BookOrderPriority>
-    std::optional<std::tuple<ID_TYPE, Price*>> book_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity) {
+    std::optional<std::tuple<ID_TYPE, Price*>> book_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner = {}) {
         if (quantity <= 0) {
             return std::nullopt;
         }
 
-        auto& my_book = get_orderbook<CompUniquePtr>();
-
-        auto it = my_book.lower_bound(price);
-        Price* pricenode_ptr = nullptr;
-
-        if (it != my_book.end() && (*it)->price_ == price) {
-            pricenode_ptr = it->get();
-        } else {
-            auto new_price_obj_uptr = std::make_unique<Price>(price);
-            pricenode_ptr = new_price_obj_uptr.get();
-            it = my_book.insert(it, std::move(new_price_obj_uptr));
-        }
+        Price* pricenode_ptr = find_or_create_price_level(get_orderbook<CompUniquePtr>(), price);
 
         ID_TYPE new_uoid = generate_uoid();
-        pricenode_ptr->template insert_order<BookOrderPriority>(new_uoid, quantity);
-        uoid_to_price_[new_uoid] = pricenode_ptr;
+        ORDER_HANDLE handle = pricenode_ptr->template insert_order<BookOrderPriority>(*order_pool_, new_uoid, quantity);
+        locator_.insert(new_uoid, {pricenode_ptr, handle, side_of<CompUniquePtr>(), owner});
+        note_level_change(side_of<CompUniquePtr>(), *pricenode_ptr);
+        note_order_added(side_of<CompUniquePtr>(), *pricenode_ptr, handle);
 
         return std::make_tuple(new_uoid, pricenode_ptr);
     }
 
-    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority, DOUBLEOPTION BookOrderPriority>
-    std::tuple<std::optional<std::tuple<ID_TYPE, Price*>>, SIZE_TYPE, std::vector<LOBClearResult>>
-    limit_match_book_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity) {
-        auto [remaining_quantity, clearings] = limit_match_price_quantity<CompUniquePtr, FillOrderPriority>(price, quantity);
+    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority, DOUBLEOPTION BookOrderPriority, typename FillSink>
+    std::tuple<std::optional<std::tuple<ID_TYPE, Price*>>, SIZE_TYPE>
+    limit_match_book_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner, FillSink&& sink) {
+        SIZE_TYPE remaining_quantity = limit_match_price_quantity<CompUniquePtr, FillOrderPriority>(price, quantity, sink);
 
         std::optional<std::tuple<ID_TYPE, Price*>> placed_order_info;
         if (remaining_quantity > 0) {
-            placed_order_info = book_price_quantity<CompUniquePtr, BookOrderPriority>(price, remaining_quantity);
+            placed_order_info = book_price_quantity<CompUniquePtr, BookOrderPriority>(price, remaining_quantity, owner);
         }
-        return {placed_order_info, remaining_quantity, std::move(clearings)};
+        return {placed_order_info, remaining_quantity};
     }
 
-    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority>
-    std::tuple<SIZE_TYPE, std::vector<LOBClearResult>> market_match_quantity(SIZE_TYPE quantity) {
+    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority, DOUBLEOPTION BookOrderPriority>
+    std::tuple<std::optional<std::tuple<ID_TYPE, Price*>>, SIZE_TYPE, std::vector<LOBClearResult>>
+    limit_match_book_price_quantity(PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner = {}) {
         std::vector<LOBClearResult> clearings;
+        auto [placed_order_info, remaining_quantity] = limit_match_book_price_quantity<CompUniquePtr, FillOrderPriority, BookOrderPriority>(
+                price, quantity, owner, clearing_collector(clearings));
+        return {placed_order_info, remaining_quantity, std::move(clearings)};
+    }
+
+    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority, typename FillSink>
+    SIZE_TYPE market_match_quantity(SIZE_TYPE quantity, FillSink&& sink) {
         auto& counter_book = get_counter_orderbook<CompUniquePtr>();
-        std::vector<ID_TYPE> exhausted_uoids_from_level;
+
+        auto journalled_sink = executing_sink(counter_side_of<CompUniquePtr>(), sink);
 
         auto it = counter_book.begin();
         while (it != counter_book.end() && quantity > 0) {
             Price* price_node = it->get();
-            exhausted_uoids_from_level.clear();
-            LOBClearResult result = price_node->template clear_quantity<FillOrderPriority>(quantity, exhausted_uoids_from_level);
-            if(!result.trades_.empty()){
-                clearings.push_back(std::move(result));
-            }
-            for (ID_TYPE uoid_to_remove : exhausted_uoids_from_level) {
-                uoid_to_price_.erase(uoid_to_remove);
+            if (order_journal_enabled_) {
+                price_node->template clear_quantity<FillOrderPriority>(quantity, locator_, journalled_sink);
+            } else {
+                price_node->template clear_quantity<FillOrderPriority>(quantity, locator_, sink);
             }
+            note_level_change(counter_side_of<CompUniquePtr>(), *price_node);
             if (price_node->get_total_quantity() == 0) {
                 it = counter_book.erase(it);
             } else {
                 ++it;
             }
         }
-        return {quantity, std::move(clearings)};
+        return quantity;
+    }
+
+    template <typename CompUniquePtr, DOUBLEOPTION FillOrderPriority>
+    std::tuple<SIZE_TYPE, std::vector<LOBClearResult>> market_match_quantity(SIZE_TYPE quantity) {
+        std::vector<LOBClearResult> clearings;
+        SIZE_TYPE remaining = market_match_quantity<CompUniquePtr, FillOrderPriority>(quantity, clearing_collector(clearings));
+        return {remaining, std::move(clearings)};
     }
 
     template <typename CompUniquePtr>
     std::optional<std::tuple<PRICE_TYPE, SIZE_TYPE>> delete_limit_order(ID_TYPE target_uoid) {
-        auto map_it = uoid_to_price_.find(target_uoid);
-        if (map_it != uoid_to_price_.end()) {
-            Price* pricenode = map_it->second;
+        OrderLocation* location = locator_.find(target_uoid);
+        if (location) {
+            Price* pricenode = location->level_;
             PRICE_TYPE price_of_pricenode = pricenode->price_;
 
-            std::optional<LOBOrder> order_removed_data = pricenode->remove_order_from_container(target_uoid);
-            if (order_removed_data) {
-                uoid_to_price_.erase(map_it);
-                if (pricenode->get_total_quantity() == 0) {
-                    erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), price_of_pricenode);
-                }
-                return std::make_tuple(price_of_pricenode, order_removed_data->quantity_);
+            SIZE_TYPE removed_quantity = unlink_order(target_uoid, *location);
+            note_level_change(side_of<CompUniquePtr>(), *pricenode);
+            if (pricenode->get_total_quantity() == 0) {
+                erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), price_of_pricenode);
             }
+            return std::make_tuple(price_of_pricenode, removed_quantity);
         }
         return std::nullopt;
     }
@@ -547,16 +1694,12 @@ public:
 
     template <typename CompUniquePtr, TRIPLEOPTION PriorityOption>
     std::optional<ModifyVolResult> modify_limit_order_vol(ID_TYPE order_id, SIZE_TYPE new_volume) {
-        auto map_it = uoid_to_price_.find(order_id);
-        if (map_it == uoid_to_price_.end()) {
-            return std::nullopt;
-        }
-        Price* pricenode = map_it->second;
-        LOBOrder* order = pricenode->get_order(order_id);
-
-        if (!order) {
+        OrderLocation* location = locator_.find(order_id);
+        if (!location) {
             return std::nullopt;
         }
+        Price* pricenode = location->level_;
+        LOBOrder* order = &order_pool_->node(location->node_).order;
 
         SIZE_TYPE old_volume = order->quantity_;
         PRICE_TYPE current_price = pricenode->price_;
@@ -564,8 +1707,8 @@ public:
         bool removed = false;
 
         if (new_volume <= 0) {
-            pricenode->remove_order_from_container(order_id);
-            uoid_to_price_.erase(order_id);
+            unlink_order(order_id, *location);
+            note_level_change(side_of<CompUniquePtr>(), *pricenode);
             removed = true;
             if (pricenode->get_total_quantity() == 0) {
                 erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), current_price);
@@ -578,31 +1721,22 @@ public:
             pricenode->total_quantity_ += new_volume;
             order->quantity_ = new_volume;
             new_uoid_opt = order_id;
+            note_level_change(side_of<CompUniquePtr>(), *pricenode);
+            note_order_change(OrderChange::Type::MODIFY, side_of<CompUniquePtr>(), order_id, current_price, new_volume);
         } else {
-            pricenode->remove_order_from_container(order_id);
-            uoid_to_price_.erase(order_id);
-
             ID_TYPE new_gen_uoid = generate_uoid();
             new_uoid_opt = new_gen_uoid;
-
-            if constexpr (PriorityOption == TRIPLEOPTION::FRONT) {
-                pricenode->template insert_order<DOUBLEOPTION::FRONT>(new_gen_uoid, new_volume);
-            } else {
-                pricenode->template insert_order<DOUBLEOPTION::BACK>(new_gen_uoid, new_volume);
-            }
-            uoid_to_price_[new_gen_uoid] = pricenode;
+            constexpr DOUBLEOPTION position = (PriorityOption == TRIPLEOPTION::FRONT) ? DOUBLEOPTION::FRONT : DOUBLEOPTION::BACK;
+            splice_order<CompUniquePtr, position>(order_id, location, current_price, new_volume, new_gen_uoid);
         }
         return ModifyVolResult(current_price, old_volume, new_volume, removed, new_uoid_opt);
     }
 
     template <typename CompUniquePtr, TRIPLEOPTION PriorityOption>
     std::optional<ModifyVolResult> remove_limit_order_vol(ID_TYPE order_id, SIZE_TYPE cancel_amount) {
-        auto map_it = uoid_to_price_.find(order_id);
-        if (map_it == uoid_to_price_.end()) return std::nullopt;
-
-        Price* pricenode = map_it->second;
-        LOBOrder* order = pricenode->get_order(order_id);
-        if(!order) return std::nullopt;
+        const OrderLocation* location = locator_.find(order_id);
+        if (!location) return std::nullopt;
+        const LOBOrder* order = &order_pool_->node(location->node_).order;
 
         SIZE_TYPE new_volume = (cancel_amount >= order->quantity_) ? 0 : (order->quantity_ - cancel_amount);
         return modify_limit_order_vol<CompUniquePtr, PriorityOption>(order_id, new_volume);
@@ -611,25 +1745,19 @@ public:
 
     template <typename CompUniquePtr, TRIPLEOPTION PriorityOption>
     std::optional<std::tuple<ID_TYPE, ReplaceOrderResult>> replace_limit_order_vol(ID_TYPE order_id_old, SIZE_TYPE volume_new) {
-        auto map_it = uoid_to_price_.find(order_id_old);
-        if (map_it == uoid_to_price_.end()) {
-            return std::nullopt;
-        }
-        Price* pricenode = map_it->second;
-
-        auto opt_old_order_list_iter = pricenode->container.getOrderListIterator(order_id_old);
-        if(!opt_old_order_list_iter){
+        OrderLocation* location = locator_.find(order_id_old);
+        if (!location) {
             return std::nullopt;
         }
-        std::list<LOBOrder>::iterator old_order_list_iter = *opt_old_order_list_iter;
-        SIZE_TYPE old_volume = old_order_list_iter->quantity_;
+        Price* pricenode = location->level_;
+        OrderOwner owner = location->owner_;
         PRICE_TYPE price_val = pricenode->price_;
 
         ID_TYPE order_id_new = generate_uoid();
 
-        pricenode->total_quantity_ -= old_volume;
-        auto next_iter_hint_for_inplace_insert = pricenode->container.erase(old_order_list_iter);
-        uoid_to_price_.erase(order_id_old);
+        ORDER_HANDLE next_handle_for_inplace_insert = order_pool_->node(location->node_).next_;
+        SIZE_TYPE old_volume = unlink_order(order_id_old, *location);
+        note_level_change(side_of<CompUniquePtr>(), *pricenode);
 
         bool old_order_effectively_removed = true;
 
@@ -640,34 +1768,36 @@ public:
             return std::make_tuple(order_id_new, ReplaceOrderResult(price_val, old_volume, old_order_effectively_removed));
         }
 
+        ORDER_HANDLE new_handle;
         if constexpr (PriorityOption == TRIPLEOPTION::INPLACE) {
-            pricenode->insert_order_at_position(next_iter_hint_for_inplace_insert, order_id_new, volume_new);
+            new_handle = pricenode->insert_order_at_position(*order_pool_, next_handle_for_inplace_insert, order_id_new, volume_new);
         } else if constexpr (PriorityOption == TRIPLEOPTION::FRONT) {
-            pricenode->template insert_order<DOUBLEOPTION::FRONT>(order_id_new, volume_new);
+            new_handle = pricenode->template insert_order<DOUBLEOPTION::FRONT>(*order_pool_, order_id_new, volume_new);
         } else {
-            pricenode->template insert_order<DOUBLEOPTION::BACK>(order_id_new, volume_new);
+            new_handle = pricenode->template insert_order<DOUBLEOPTION::BACK>(*order_pool_, order_id_new, volume_new);
         }
-        uoid_to_price_[order_id_new] = pricenode;
+        locator_.insert(order_id_new, {pricenode, new_handle, side_of<CompUniquePtr>(), owner});
+        note_level_change(side_of<CompUniquePtr>(), *pricenode);
+        note_order_added(side_of<CompUniquePtr>(), *pricenode, new_handle);
 
         return std::make_tuple(order_id_new, ReplaceOrderResult(price_val, old_volume, old_order_effectively_removed));
     }
 
 
+    // Moves an order to `new_price`. INPLACE keeps its UOID (a no-op at the same price); FRONT/BACK re-key it to a
+    // new UOID. Either way it joins the new level at the given end, spliced across without a new pool node.
     template <typename CompUniquePtr, TRIPLEOPTION PriorityOption>
     std::optional<ModifyPriceResult> modify_limit_order_price(PRICE_TYPE new_price, ID_TYPE order_id_old) {
-        auto map_it = uoid_to_price_.find(order_id_old);
-        if (map_it == uoid_to_price_.end()) {
+        OrderLocation* location = locator_.find(order_id_old);
+        if (!location) {
             return std::nullopt;
         }
 
-        Price* old_pricenode = map_it->second;
-        const LOBOrder* old_order_const_ptr = old_pricenode->get_order(order_id_old);
-        assert(old_order_const_ptr != nullptr && "OrderBookCore: Inconsistency - UOID in map but not in Price level.");
-        assert(old_order_const_ptr->quantity_ > 0 && "OrderBookCore: Inconsistency - Resting order has zero or negative volume.");
+        const LOBOrder& old_order = order_pool_->node(location->node_).order;
+        assert(old_order.quantity_ > 0 && "OrderBookCore: Inconsistency - Resting order has zero or negative volume.");
 
-        PRICE_TYPE old_price = old_pricenode->price_;
-        SIZE_TYPE original_volume = old_order_const_ptr->quantity_;
-        ID_TYPE final_uoid = order_id_old; // For INPLACE, this will remain order_id_old
+        PRICE_TYPE old_price = location->level_->price_;
+        SIZE_TYPE original_volume = old_order.quantity_;
 
         if constexpr (PriorityOption == TRIPLEOPTION::INPLACE) {
             if (old_price == new_price) {
@@ -676,65 +1806,31 @@ public:
             }
         }
 
-        // If execution reaches here, the order will be moved or re-booked.
-        // Remove the order from its current location.
-        auto removed_data = old_pricenode->remove_order_from_container(order_id_old);
-        assert(removed_data.has_value() && removed_data->uoid_ == order_id_old && "Failed to remove order for price change.");
-        uoid_to_price_.erase(order_id_old); // Remove from global UOID map
-
-        if (old_pricenode->get_total_quantity() == 0) {
-            erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), old_price);
-        }
-
-        // Re-book the order
-        if constexpr (PriorityOption == TRIPLEOPTION::INPLACE) {
-            // For INPLACE with price change, re-book with the SAME UOID at the back of the new price level.
-            Price* new_pricenode_ptr = nullptr;
-            auto& target_book = get_orderbook<CompUniquePtr>();
-            auto it_new_price_level = target_book.lower_bound(new_price);
-
-            if (it_new_price_level != target_book.end() && (*it_new_price_level)->price_ == new_price) {
-                new_pricenode_ptr = it_new_price_level->get();
-            } else {
-                auto new_price_obj_uptr = std::make_unique<Price>(new_price);
-                new_pricenode_ptr = new_price_obj_uptr.get();
-                target_book.insert(it_new_price_level, std::move(new_price_obj_uptr));
-            }
-            // Insert with original UOID (order_id_old) at the back of the queue.
-            new_pricenode_ptr->template insert_order<DOUBLEOPTION::BACK>(order_id_old, original_volume);
-            uoid_to_price_[order_id_old] = new_pricenode_ptr; // Re-map the original UOID to the new price node.
-            // final_uoid is already order_id_old, which is intended.
-        } else { // TRIPLEOPTION::FRONT or TRIPLEOPTION::BACK
-            // For FRONT/BACK, a new UOID is generated by book_price_quantity.
-            constexpr DOUBLEOPTION bookPriority = (PriorityOption == TRIPLEOPTION::FRONT) ? DOUBLEOPTION::FRONT : DOUBLEOPTION::BACK;
-            auto book_result_tuple_opt = book_price_quantity<CompUniquePtr, bookPriority>(new_price, original_volume);
-            assert(book_result_tuple_opt.has_value());
-            final_uoid = std::get<0>(*book_result_tuple_opt); // New UOID from booking
-        }
+        // INPLACE with a price change keeps the UOID and joins the back of the new level.
+        ID_TYPE final_uoid = (PriorityOption == TRIPLEOPTION::INPLACE) ? order_id_old : generate_uoid();
+        constexpr DOUBLEOPTION position = (PriorityOption == TRIPLEOPTION::FRONT) ? DOUBLEOPTION::FRONT : DOUBLEOPTION::BACK;
+        splice_order<CompUniquePtr, position>(order_id_old, location, new_price, original_volume, final_uoid);
         return ModifyPriceResult(old_price, original_volume, final_uoid);
     }
 
     template <typename CompUniquePtr, TRIPLEOPTION PriorityOption>
     std::optional<ModifyPriceVolResult> modify_limit_order_price_vol(PRICE_TYPE new_price, SIZE_TYPE new_volume, ID_TYPE order_id_old) {
-        auto map_it = uoid_to_price_.find(order_id_old);
-        if (map_it == uoid_to_price_.end()) {
+        OrderLocation* location = locator_.find(order_id_old);
+        if (!location) {
             return std::nullopt;
         }
 
-        Price* old_pricenode = map_it->second;
-        LOBOrder* old_order_modifiable_ptr = old_pricenode->get_order(order_id_old);
-        assert(old_order_modifiable_ptr != nullptr && "OrderBookCore: Inconsistency - UOID in map but not in Price level (price_vol).");
+        Price* old_pricenode = location->level_;
+        LOBOrder* old_order_modifiable_ptr = &order_pool_->node(location->node_).order;
         assert(old_order_modifiable_ptr->quantity_ > 0 && "OrderBookCore: Inconsistency - Resting order has zero or negative volume (price_vol).");
 
         PRICE_TYPE old_price = old_pricenode->price_;
         SIZE_TYPE old_volume = old_order_modifiable_ptr->quantity_;
-        ID_TYPE final_uoid = order_id_old;
-        bool old_level_removed_flag = false;
 
         if (new_volume <= 0) {
-            auto removed_data = old_pricenode->remove_order_from_container(order_id_old);
-            assert(removed_data.has_value() && removed_data->uoid_ == order_id_old);
-            uoid_to_price_.erase(order_id_old);
+            bool old_level_removed_flag = false;
+            unlink_order(order_id_old, *location);
+            note_level_change(side_of<CompUniquePtr>(), *old_pricenode);
             if (old_pricenode->get_total_quantity() == 0) {
                 erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), old_price);
                 old_level_removed_flag = true;
@@ -747,73 +1843,206 @@ public:
                 old_pricenode->total_quantity_ -= old_volume;
                 old_pricenode->total_quantity_ += new_volume;
                 old_order_modifiable_ptr->quantity_ = new_volume;
+                note_level_change(side_of<CompUniquePtr>(), *old_pricenode);
+                note_order_change(OrderChange::Type::MODIFY, side_of<CompUniquePtr>(), order_id_old, old_price, new_volume);
                 return ModifyPriceVolResult(old_price, old_volume, new_volume, false, order_id_old);
             }
         }
 
-        auto removed_data = old_pricenode->remove_order_from_container(order_id_old);
-        assert(removed_data.has_value() && removed_data->uoid_ == order_id_old);
-        uoid_to_price_.erase(order_id_old);
-        if (old_pricenode->get_total_quantity() == 0) {
-            erase_price_level_if_empty(get_orderbook<CompUniquePtr>(), old_price);
-            old_level_removed_flag = true;
-        }
-
-        bool generateNewUoid = true; // Default for FRONT/BACK or INPLACE with price change
+        // INPLACE with a price change keeps the UOID and joins the back of the new level.
+        ID_TYPE final_uoid = (PriorityOption == TRIPLEOPTION::INPLACE) ? order_id_old : generate_uoid();
+        constexpr DOUBLEOPTION position = (PriorityOption == TRIPLEOPTION::FRONT) ? DOUBLEOPTION::FRONT : DOUBLEOPTION::BACK;
+        bool old_level_removed_flag = splice_order<CompUniquePtr, position>(order_id_old, location, new_price, new_volume, final_uoid);
+        return ModifyPriceVolResult(old_price, old_volume, new_volume, old_level_removed_flag, final_uoid);
+    }
 
-        if constexpr (PriorityOption == TRIPLEOPTION::INPLACE) {
-            generateNewUoid = false;
-            final_uoid = order_id_old;
-        } else {
-            final_uoid = generate_uoid(); // Generate for FRONT/BACK
+    // Exchange-style amend: the order keeps its UOID and owner, and keeps its queue position when the price is
+    // unchanged and the quantity does not grow; otherwise it moves to the back of the level for `new_price`. The
+    // pooled node is reused either way. The caller is responsible for not amending across the counter side.
+    template <typename CompUniquePtr>
+    std::optional<ModifyPriceVolResult> amend_limit_order(ID_TYPE order_id, PRICE_TYPE new_price, SIZE_TYPE new_volume) {
+        OrderLocation* location = locator_.find(order_id);
+        if (!location || new_volume <= 0) {
+            return std::nullopt;
         }
 
-        Price* new_pricenode_ptr = nullptr;
-        auto& target_book = get_orderbook<CompUniquePtr>();
-        auto it_new_price_level = target_book.lower_bound(new_price);
-
-        if (it_new_price_level != target_book.end() && (*it_new_price_level)->price_ == new_price) {
-            new_pricenode_ptr = it_new_price_level->get();
-        } else {
-            auto new_price_obj_uptr = std::make_unique<Price>(new_price);
-            new_pricenode_ptr = new_price_obj_uptr.get();
-            target_book.insert(it_new_price_level, std::move(new_price_obj_uptr));
+        Price* level = location->level_;
+        LOBOrder& order = order_pool_->node(location->node_).order;
+        PRICE_TYPE old_price = level->price_;
+        SIZE_TYPE old_volume = order.quantity_;
+
+        if (new_price == old_price && new_volume <= old_volume) {
+            level->total_quantity_ -= old_volume - new_volume;
+            order.quantity_ = new_volume;
+            note_level_change(side_of<CompUniquePtr>(), *level);
+            note_order_change(OrderChange::Type::MODIFY, side_of<CompUniquePtr>(), order_id, old_price, new_volume);
+            return ModifyPriceVolResult(old_price, old_volume, new_volume, false, order_id);
+        }
+
+        bool old_level_removed = splice_order<CompUniquePtr, DOUBLEOPTION::BACK>(order_id, location, new_price, new_volume, order_id);
+        return ModifyPriceVolResult(old_price, old_volume, new_volume, old_level_removed, order_id);
+    }
+
+    // Cancels the resting orders of `trader_id` in one walk of its owner list, optionally restricted to one side
+    // and to an inclusive price range. `on_cancel(uoid, side, price, quantity, owner)` runs for each order once it
+    // has left the book. Returns the number of orders cancelled.
+    template <typename CancelSink>
+    std::size_t cancel_orders_of_owner(std::uint64_t trader_id, std::optional<SIDE> side, std::optional<PRICE_TYPE> min_price,
+                                       std::optional<PRICE_TYPE> max_price, CancelSink&& on_cancel) {
+        std::size_t cancelled = 0;
+        ID_TYPE uoid = locator_.first_of_owner(trader_id);
+        while (uoid != ID_DEFAULT) {
+            OrderLocation* location = locator_.find(uoid);
+            ID_TYPE next_uoid = location->owner_next_; // `location` is invalid once the order is unlinked.
+            Price* level = location->level_;
+            PRICE_TYPE price = level->price_;
+            SIDE order_side = location->side_;
+            if ((!side || *side == order_side) && (!min_price || price >= *min_price) && (!max_price || price <= *max_price)) {
+                OrderOwner owner = location->owner_;
+                SIZE_TYPE quantity = unlink_order(uoid, *location);
+                note_level_change(order_side, *level);
+                if (level->get_total_quantity() == 0) {
+                    if (order_side == SIDE::BID) {
+                        erase_price_level_if_empty(buy_prices_, price);
+                    } else {
+                        erase_price_level_if_empty(sell_prices_, price);
+                    }
+                }
+                on_cancel(uoid, order_side, price, quantity, owner);
+                ++cancelled;
+            }
+            uoid = next_uoid;
         }
+        return cancelled;
+    }
 
-        // Corrected: Use explicit DOUBLEOPTION based on PriorityOption
-        if constexpr (PriorityOption == TRIPLEOPTION::INPLACE) { // INPLACE (with price change) goes to back of new queue
-            new_pricenode_ptr->template insert_order<DOUBLEOPTION::BACK>(final_uoid, new_volume);
-        } else if constexpr (PriorityOption == TRIPLEOPTION::FRONT) {
-            new_pricenode_ptr->template insert_order<DOUBLEOPTION::FRONT>(final_uoid, new_volume);
-        } else { // TRIPLEOPTION::BACK
-            new_pricenode_ptr->template insert_order<DOUBLEOPTION::BACK>(final_uoid, new_volume);
+    std::optional<SIDE> get_side_of_order(ID_TYPE uoid) const {
+        const OrderLocation* location = locator_.find(uoid);
+        if (location) {
+            return location->side_;
         }
-        uoid_to_price_[final_uoid] = new_pricenode_ptr;
+        return std::nullopt;
+    }
 
-        return ModifyPriceVolResult(old_price, old_volume, new_volume, old_level_removed_flag, final_uoid);
+    std::optional<OrderOwner> get_owner_of_order(ID_TYPE uoid) const {
+        const OrderLocation* location = locator_.find(uoid);
+        if (location) {
+            return location->owner_;
+        }
+        return std::nullopt;
     }
 
     std::optional<PRICE_TYPE> get_price_of_order(ID_TYPE uoid) const {
-        auto it = uoid_to_price_.find(uoid);
-        if (it != uoid_to_price_.end()) {
-            return it->second->price_;
+        const OrderLocation* location = locator_.find(uoid);
+        if (location) {
+            return location->level_->price_;
         }
         return std::nullopt;
     }
 
     const LOBOrder* get_order(ID_TYPE target_uoid) const {
-        auto it = uoid_to_price_.find(target_uoid);
-        if (it != uoid_to_price_.end()) {
-            return it->second->get_order(target_uoid);
-        }
-        return nullptr;
+        const OrderLocation* location = locator_.find(target_uoid);
+        return location ? &order_pool_->node(location->node_).order : nullptr;
     }
 
     void flush() {
+        if (order_journal_enabled_) {
+            for (const L3LevelView& level : get_state_l3(SIDE::BID, buy_prices_.size())) {
+                for (const LOBOrder& order : level) note_order_change(OrderChange::Type::DELETE, SIDE::BID, order.uoid_, level.price(), order.quantity_);
+            }
+            for (const L3LevelView& level : get_state_l3(SIDE::ASK, sell_prices_.size())) {
+                for (const LOBOrder& order : level) note_order_change(OrderChange::Type::DELETE, SIDE::ASK, order.uoid_, level.price(), order.quantity_);
+            }
+        }
+        for (const auto& priceUPtr : buy_prices_) note_level_change(SIDE::BID, *priceUPtr);
+        for (const auto& priceUPtr : sell_prices_) note_level_change(SIDE::ASK, *priceUPtr);
+        for (LevelChange& change : level_changes_) change.new_quantity_ = 0; // Every level is gone after the flush.
+        bid_depth_index_.clear();
+        ask_depth_index_.clear();
         buy_prices_.clear();
         sell_prices_.clear();
-        uoid_to_price_.clear();
-        next_uoid_ = 1;
+        locator_.clear();
+        bid_depth_cache_valid_ = false;
+        ask_depth_cache_valid_ = false;
+        next_uoid_ = uoid_base_ + 1;
+    }
+
+    // Level-change journal: (side, price, new total quantity) for every level touched since the last
+    // clear_level_changes(). Applying the entries in order to the L2 state as of that call yields the current one.
+    bool has_level_changes() const {
+        return !level_changes_.empty();
+    }
+
+    const std::vector<LevelChange>& get_level_changes() const {
+        return level_changes_;
+    }
+
+    void clear_level_changes() {
+        level_changes_.clear();
+        ++change_epoch_;
+    }
+
+    // Order-change (L3) journal, off by default. Applying the entries in order to an L3 snapshot taken at the last
+    // clear_order_changes() yields the current book, queue positions included.
+    void set_order_journal_enabled(bool enabled) {
+        order_journal_enabled_ = enabled;
+        if (!enabled) {
+            order_changes_.clear();
+        }
+    }
+
+    bool is_order_journal_enabled() const {
+        return order_journal_enabled_;
+    }
+
+    bool has_order_changes() const {
+        return !order_changes_.empty();
+    }
+
+    const std::vector<OrderChange>& get_order_changes() const {
+        return order_changes_;
+    }
+
+    void clear_order_changes() {
+        order_changes_.clear();
+    }
+
+    // Best level of each side as (price, total quantity), O(1) for both level policies.
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> get_best_bid() const {
+        return top_of(buy_prices_);
+    }
+
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> get_best_ask() const {
+        return top_of(sell_prices_);
+    }
+
+    // Enables a cached top-`levels` view per side that get_state_l2(max_depth) serves when max_depth <= levels.
+    // 0 disables the cache.
+    void set_depth_cache_levels(size_t levels) {
+        depth_cache_levels_ = levels;
+        bid_depth_cache_valid_ = false;
+        ask_depth_cache_valid_ = false;
+        bid_depth_cache_.clear();
+        ask_depth_cache_.clear();
+    }
+
+    size_t get_depth_cache_levels() const {
+        return depth_cache_levels_;
+    }
+
+    // Top `max_depth` levels per side, in the same flattened layout as get_state_l2(). Costs O(max_depth).
+    std::pair<std::vector<PRICE_SIZE_TYPE>, std::vector<PRICE_SIZE_TYPE>> get_state_l2(size_t max_depth) const {
+        std::vector<PRICE_SIZE_TYPE> bids, asks;
+        if (max_depth > 0 && max_depth <= depth_cache_levels_) {
+            const auto& bid_cache = depth_cache(buy_prices_, bid_depth_cache_, bid_depth_cache_valid_);
+            const auto& ask_cache = depth_cache(sell_prices_, ask_depth_cache_, ask_depth_cache_valid_);
+            bids.assign(bid_cache.begin(), bid_cache.begin() + std::min(bid_cache.size(), max_depth * 2));
+            asks.assign(ask_cache.begin(), ask_cache.begin() + std::min(ask_cache.size(), max_depth * 2));
+        } else {
+            append_levels(buy_prices_, max_depth, bids);
+            append_levels(sell_prices_, max_depth, asks);
+        }
+        return {bids, asks};
     }
 
     std::pair<std::vector<PRICE_SIZE_TYPE>, std::vector<PRICE_SIZE_TYPE>> get_state_l2() const {
@@ -832,6 +2061,18 @@ public:
         return {bids, asks};
     }
 
+    // Top `max_depth` levels of `side`, best first, as in-place views of their order queues. Nothing but the views
+    // themselves is copied.
+    std::vector<L3LevelView> get_state_l3(SIDE side, size_t max_depth) const {
+        std::vector<L3LevelView> levels;
+        if (side == SIDE::BID) {
+            append_l3_levels(buy_prices_, max_depth, levels);
+        } else if (side == SIDE::ASK) {
+            append_l3_levels(sell_prices_, max_depth, levels);
+        }
+        return levels;
+    }
+
     void printOrderBook() const {
         std::cout << "------ SELL SIDE ------ (Price, Total Quantity)" << std::endl;
         for (const auto& priceUPtr : sell_prices_) {
@@ -842,64 +2083,272 @@ public:
         for (const auto& priceUPtr : buy_prices_) {
             std::cout << "Price: " << priceUPtr->price_ << ", Qty: " << priceUPtr->get_total_quantity() << std::endl;
         }
-        std::cout << "======== Orders in uoid_to_price_ map (" << uoid_to_price_.size() << " entries) ======== " << std::endl;
+        std::cout << "======== Orders in locator (" << locator_.size() << " entries) ======== " << std::endl;
     }
 
+    // Depth queries against the counter side of CompUniquePtr, best price first. All are O(log levels).
+
+    // Notional (sum of price * quantity) needed to take `volume`, or PRICE_DEFAULT if the side holds less.
     template <typename CompUniquePtr>
     PRICE_TYPE get_price_for_volume(SIZE_TYPE volume) const {
-        SIZE_TYPE remaining_vol = volume;
-        PRICE_TYPE current_total_price = 0;
-        const auto& counter_book = get_counter_orderbook_const<CompUniquePtr>();
-        for (const auto& pricenode_uptr : counter_book) {
-            if (remaining_vol == 0) break;
-            if (remaining_vol >= pricenode_uptr->get_total_quantity()) {
-                remaining_vol -= pricenode_uptr->get_total_quantity();
-                current_total_price += pricenode_uptr->get_total_quantity() * pricenode_uptr->price_;
-            } else {
-                current_total_price += remaining_vol * pricenode_uptr->price_;
-                remaining_vol = 0;
-            }
-        }
-        if (remaining_vol > 0) return PRICE_DEFAULT;
-        return current_total_price;
+        return counter_depth_index<CompUniquePtr>().notional_for_quantity(volume).value_or(PRICE_DEFAULT);
     }
 
     template <typename CompUniquePtr>
     SIZE_TYPE get_available_volume() const {
-        SIZE_TYPE volume = 0;
-        const auto& counter_book = get_counter_orderbook_const<CompUniquePtr>();
-        for (const auto& pricenode_uptr : counter_book) {
-            volume += pricenode_uptr->get_total_quantity();
-        }
-        return volume;
+        return counter_depth_index<CompUniquePtr>().total_quantity();
     }
 
+    // Volume resting at `target_price` or better.
     template <typename CompUniquePtr>
     SIZE_TYPE get_volume_for_price(PRICE_TYPE target_price) const {
-        SIZE_TYPE current_total_volume = 0;
-        const auto& counter_book = get_counter_orderbook_const<CompUniquePtr>();
-        auto price_val_comparator = get_counter_price_val_comparator<CompUniquePtr>();
+        return counter_depth_index<CompUniquePtr>().quantity_through(target_price);
+    }
 
-        for (const auto& pricenode_uptr : counter_book) {
-            if (price_val_comparator(pricenode_uptr->price_, target_price)) {
-                current_total_volume += pricenode_uptr->get_total_quantity();
-            } else {
-                break;
+    // Price of the level at which the cumulative volume first reaches `volume`, or nullopt if the side holds less.
+    template <typename CompUniquePtr>
+    std::optional<PRICE_TYPE> get_price_at_depth(SIZE_TYPE volume) const {
+        return counter_depth_index<CompUniquePtr>().price_at_depth(volume);
+    }
+};
+
+
+// Copy-on-write what-if view of an OrderBookCore. Creating a fork copies nothing: the fork reads the base book's
+// levels in place and records its own fills and cancels of base orders in a small overlay, while orders booked on
+// the fork rest in a private core whose UOIDs come from a separate ID space. Within a price level, base orders
+// keep time priority over fork orders and fills are FIFO. The base book must not change while the fork is in use.
+template <typename LevelPolicy>
+class OrderBookFork {
+public:
+    static constexpr ID_TYPE DEFAULT_ID_SPACE = (ID_TYPE{1} << (64 - UOID_SPACE_SHIFT)) - 1;
+
+    explicit OrderBookFork(const OrderBookCore<LevelPolicy>& base, ID_TYPE id_space = DEFAULT_ID_SPACE)
+            : base_(&base), local_(id_space) {}
+
+    OrderBookFork(const OrderBookFork&) = delete;
+    OrderBookFork& operator=(const OrderBookFork&) = delete;
+
+    // `side` is the side of the incoming order, as in OrderBookWrapper. The sink has the OrderBookCore fill-sink
+    // signature and sees base and fork orders alike.
+    template <typename FillSink>
+    SIZE_TYPE limit_match_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity, FillSink&& sink) {
+        if (side == SIDE::BID) return sweep<PriceUniquePtrCompareDescending, true>(price, quantity, sink);
+        return sweep<PriceUniquePtrCompareAscending, true>(price, quantity, sink);
+    }
+
+    template <typename FillSink>
+    SIZE_TYPE market_match_quantity(SIDE side, SIZE_TYPE quantity, FillSink&& sink) {
+        if (side == SIDE::BID) return sweep<PriceUniquePtrCompareDescending, false>(PRICE_DEFAULT, quantity, sink);
+        return sweep<PriceUniquePtrCompareAscending, false>(PRICE_DEFAULT, quantity, sink);
+    }
+
+    // Matches, then rests any remainder on the fork. Returns the fork UOID of the resting part, if any, and the
+    // quantity that was left after matching.
+    template <typename FillSink>
+    std::tuple<std::optional<ID_TYPE>, SIZE_TYPE> limit_match_book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity,
+                                                                                  OrderOwner owner, FillSink&& sink) {
+        SIZE_TYPE remaining = limit_match_price_quantity(side, price, quantity, sink);
+        std::optional<ID_TYPE> resting_uoid;
+        if (remaining > 0) {
+            resting_uoid = book_price_quantity(side, price, remaining, owner);
+        }
+        return {resting_uoid, remaining};
+    }
+
+    // Rests an order on the fork without matching.
+    std::optional<ID_TYPE> book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner = {}) {
+        std::optional<std::tuple<ID_TYPE, Price*>> placed;
+        if (side == SIDE::BID) {
+            placed = local_.template book_price_quantity<PriceUniquePtrCompareDescending, DOUBLEOPTION::BACK>(price, quantity, owner);
+        } else {
+            placed = local_.template book_price_quantity<PriceUniquePtrCompareAscending, DOUBLEOPTION::BACK>(price, quantity, owner);
+        }
+        if (!placed) return std::nullopt;
+        return std::get<0>(*placed);
+    }
+
+    // Cancels a base or fork order on the fork only. Returns the quantity it still had, or nullopt if it is not
+    // resting on the fork.
+    std::optional<SIZE_TYPE> cancel_order(ID_TYPE uoid) {
+        if (std::optional<SIDE> side = local_.get_side_of_order(uoid)) {
+            auto removed = (*side == SIDE::BID)
+                    ? local_.template delete_limit_order<PriceUniquePtrCompareDescending>(uoid)
+                    : local_.template delete_limit_order<PriceUniquePtrCompareAscending>(uoid);
+            return std::get<1>(*removed);
+        }
+        std::optional<SIDE> side = base_->get_side_of_order(uoid);
+        if (!side) return std::nullopt;
+        SIZE_TYPE remaining = base_remaining(uoid, base_->get_order(uoid)->quantity_);
+        if (remaining == 0) return std::nullopt;
+        base_order_taken_[uoid] += remaining;
+        base_level_taken(*side)[*base_->get_price_of_order(uoid)] += remaining;
+        return remaining;
+    }
+
+    // Quantity an order still has on the fork (0 if it is filled, cancelled or unknown).
+    SIZE_TYPE get_order_quantity(ID_TYPE uoid) const {
+        if (const LOBOrder* order = local_.get_order(uoid)) return order->quantity_;
+        if (const LOBOrder* order = base_->get_order(uoid)) return base_remaining(uoid, order->quantity_);
+        return 0;
+    }
+
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> get_best_bid() const {
+        return best_level<PriceUniquePtrCompareDescending>();
+    }
+
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> get_best_ask() const {
+        return best_level<PriceUniquePtrCompareAscending>();
+    }
+
+    // Top `max_depth` levels per side of the fork, in the flattened layout of OrderBookCore::get_state_l2().
+    std::pair<std::vector<PRICE_SIZE_TYPE>, std::vector<PRICE_SIZE_TYPE>> get_state_l2(size_t max_depth) const {
+        std::vector<PRICE_SIZE_TYPE> bids, asks;
+        collect_levels<PriceUniquePtrCompareDescending>(max_depth, bids);
+        collect_levels<PriceUniquePtrCompareAscending>(max_depth, asks);
+        return {bids, asks};
+    }
+
+private:
+    template <typename CompUniquePtr>
+    static constexpr SIDE side_of() {
+        return std::is_same_v<CompUniquePtr, PriceUniquePtrCompareDescending> ? SIDE::BID : SIDE::ASK;
+    }
+
+    static constexpr bool better(SIDE side, PRICE_TYPE a, PRICE_TYPE b) {
+        return side == SIDE::BID ? a > b : a < b;
+    }
+
+    std::unordered_map<PRICE_TYPE, SIZE_TYPE>& base_level_taken(SIDE side) {
+        return side == SIDE::BID ? base_bid_level_taken_ : base_ask_level_taken_;
+    }
+    const std::unordered_map<PRICE_TYPE, SIZE_TYPE>& base_level_taken(SIDE side) const {
+        return side == SIDE::BID ? base_bid_level_taken_ : base_ask_level_taken_;
+    }
+
+    SIZE_TYPE base_remaining(ID_TYPE uoid, SIZE_TYPE quantity) const {
+        auto it = base_order_taken_.find(uoid);
+        return it == base_order_taken_.end() ? quantity : quantity - it->second;
+    }
+
+    SIZE_TYPE base_level_remaining(SIDE side, const Price& level) const {
+        const auto& taken = base_level_taken(side);
+        auto it = taken.find(level.price_);
+        return it == taken.end() ? level.get_total_quantity() : level.get_total_quantity() - it->second;
+    }
+
+    // Base levels of `side` that still hold quantity on the fork, best first.
+    template <typename BookType>
+    auto skip_exhausted(SIDE side, const BookType& book, typename BookType::const_iterator it) const {
+        while (it != book.end() && base_level_remaining(side, **it) == 0) ++it;
+        return it;
+    }
+
+    template <typename FillSink>
+    void take_from_base_level(SIDE side, const Price& level, SIZE_TYPE& quantity, FillSink& sink) {
+        SIZE_TYPE taken_here = 0;
+        for (auto it = level.container.begin(); it != level.container.end() && quantity > 0; ++it) {
+            SIZE_TYPE remaining = base_remaining(it->uoid_, it->quantity_);
+            if (remaining == 0) continue;
+            SIZE_TYPE trade = std::min(quantity, remaining);
+            quantity -= trade;
+            taken_here += trade;
+            base_order_taken_[it->uoid_] += trade;
+            sink(it->uoid_, level.price_, trade, trade == remaining, *base_->get_owner_of_order(it->uoid_));
+        }
+        base_level_taken(side)[level.price_] += taken_here;
+    }
+
+    // Walks the counter side of CompUniquePtr, merging base and fork levels by price.
+    template <typename CompUniquePtr, bool Bounded, typename FillSink>
+    SIZE_TYPE sweep(PRICE_TYPE limit_price, SIZE_TYPE quantity, FillSink& sink) {
+        constexpr SIDE counter_side = side_of<CompUniquePtr>() == SIDE::BID ? SIDE::ASK : SIDE::BID;
+        const auto& base_book = base_->template get_counter_orderbook_const<CompUniquePtr>();
+        auto crosses = base_->template get_counter_price_val_comparator<CompUniquePtr>();
+
+        auto base_it = base_book.begin();
+        while (quantity > 0) {
+            base_it = skip_exhausted(counter_side, base_book, base_it);
+            auto local_best = (counter_side == SIDE::BID) ? local_.get_best_bid() : local_.get_best_ask();
+            bool has_base = (base_it != base_book.end());
+            if (!has_base && !local_best) break;
+
+            PRICE_TYPE level_price = (has_base && (!local_best || !better(counter_side, local_best->first, (*base_it)->price_)))
+                    ? (*base_it)->price_ : local_best->first;
+            if (Bounded && !crosses(level_price, limit_price)) break;
+
+            if (has_base && (*base_it)->price_ == level_price) {
+                take_from_base_level(counter_side, **base_it, quantity, sink);
+            }
+            if (quantity > 0 && local_best && local_best->first == level_price) {
+                quantity = local_.template limit_match_price_quantity<CompUniquePtr, DOUBLEOPTION::FRONT>(level_price, quantity, sink);
+            }
+        }
+        return quantity;
+    }
+
+    template <typename BookComp>
+    std::optional<std::pair<PRICE_TYPE, SIZE_TYPE>> best_level() const {
+        std::vector<PRICE_SIZE_TYPE> levels;
+        collect_levels<BookComp>(1, levels);
+        if (levels.empty()) return std::nullopt;
+        return std::make_pair(levels[0], levels[1]);
+    }
+
+    // Merges the base levels (net of the overlay) and the fork levels of the side kept with BookComp.
+    template <typename BookComp>
+    void collect_levels(size_t max_depth, std::vector<PRICE_SIZE_TYPE>& out) const {
+        constexpr SIDE side = side_of<BookComp>();
+        const auto& base_book = base_->template get_orderbook_const<BookComp>();
+        const auto& local_book = local_.template get_orderbook_const<BookComp>();
+        auto base_it = skip_exhausted(side, base_book, base_book.begin());
+        auto local_it = local_book.begin();
+        while (max_depth > 0 && (base_it != base_book.end() || local_it != local_book.end())) {
+            bool take_base = base_it != base_book.end() &&
+                             (local_it == local_book.end() || !better(side, (*local_it)->price_, (*base_it)->price_));
+            bool take_local = local_it != local_book.end() &&
+                              (base_it == base_book.end() || !better(side, (*base_it)->price_, (*local_it)->price_));
+            PRICE_TYPE price = take_base ? (*base_it)->price_ : (*local_it)->price_;
+            SIZE_TYPE quantity = 0;
+            if (take_base) {
+                quantity += base_level_remaining(side, **base_it);
+                base_it = skip_exhausted(side, base_book, std::next(base_it));
+            }
+            if (take_local) {
+                quantity += (*local_it)->get_total_quantity();
+                ++local_it;
             }
+            out.push_back(price);
+            out.push_back(quantity);
+            --max_depth;
         }
-        return current_total_volume;
     }
-};
 
-ID_TYPE OrderBookCore::next_uoid_{1};
+    const OrderBookCore<LevelPolicy>* base_;
+    OrderBookCore<SetLevels> local_;
+    std::unordered_map<ID_TYPE, SIZE_TYPE> base_order_taken_;
+    std::unordered_map<PRICE_TYPE, SIZE_TYPE> base_bid_level_taken_;
+    std::unordered_map<PRICE_TYPE, SIZE_TYPE> base_ask_level_taken_;
+};
 
 
+// Side-dispatching facade over OrderBookCore. The side of a resting order is read from the core's locator,
+// so the wrapper keeps no order state of its own.
+template <typename LevelPolicy = SetLevels>
 class OrderBookWrapper {
 private:
-    OrderBookCore core_;
-    std::unordered_map<ID_TYPE, SIDE> order_side_map_;
+    OrderBookCore<LevelPolicy> core_;
 
 public:
+    OrderBookWrapper() = default;
+    explicit OrderBookWrapper(ID_TYPE id_space) : core_(id_space) {}
+
+    ID_TYPE get_uoid_base() const { return core_.get_uoid_base(); }
+
+    OrderBookFork<LevelPolicy> fork() const { return core_.fork(); }
+
+    void save_checkpoint(std::ostream& out) const { core_.save_checkpoint(out); }
+    bool load_checkpoint(std::istream& in) { return core_.load_checkpoint(in); }
+
     void print_book() const {
         core_.printOrderBook();
     }
@@ -908,30 +2357,30 @@ public:
     size_t get_num_orders() const { return core_.get_num_orders(); }
     const LOBOrder* get_lob_order(ID_TYPE order_id) const { return core_.get_order(order_id); }
     std::optional<SIDE> get_order_side(ID_TYPE order_id) const {
-        auto it = order_side_map_.find(order_id);
-        if (it != order_side_map_.end()) {
-            return it->second;
-        }
-        return std::nullopt;
+        return core_.get_side_of_order(order_id);
+    }
+    std::optional<OrderOwner> get_order_owner(ID_TYPE order_id) const {
+        return core_.get_owner_of_order(order_id);
     }
     std::optional<PRICE_TYPE> get_price_for_order(ID_TYPE order_id) const {
         return core_.get_price_of_order(order_id);
     }
 
     template <DOUBLEOPTION FillOrderPrio, DOUBLEOPTION BookOrderPrio>
-    auto limit_match_book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity) {
+    auto limit_match_book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner = {}) {
         if (side == SIDE::BID) {
-            auto result = core_.template limit_match_book_price_quantity<PriceUniquePtrCompareDescending, FillOrderPrio, BookOrderPrio>(price, quantity);
-            if (std::get<0>(result).has_value()) {
-                order_side_map_[std::get<0>(std::get<0>(result).value())] = SIDE::BID;
-            }
-            return result;
+            return core_.template limit_match_book_price_quantity<PriceUniquePtrCompareDescending, FillOrderPrio, BookOrderPrio>(price, quantity, owner);
         } else {
-            auto result = core_.template limit_match_book_price_quantity<PriceUniquePtrCompareAscending, FillOrderPrio, BookOrderPrio>(price, quantity);
-            if (std::get<0>(result).has_value()) {
-                order_side_map_[std::get<0>(std::get<0>(result).value())] = SIDE::ASK;
-            }
-            return result;
+            return core_.template limit_match_book_price_quantity<PriceUniquePtrCompareAscending, FillOrderPrio, BookOrderPrio>(price, quantity, owner);
+        }
+    }
+
+    template <DOUBLEOPTION FillOrderPrio, DOUBLEOPTION BookOrderPrio, typename FillSink>
+    auto limit_match_book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner, FillSink&& sink) {
+        if (side == SIDE::BID) {
+            return core_.template limit_match_book_price_quantity<PriceUniquePtrCompareDescending, FillOrderPrio, BookOrderPrio>(price, quantity, owner, sink);
+        } else {
+            return core_.template limit_match_book_price_quantity<PriceUniquePtrCompareAscending, FillOrderPrio, BookOrderPrio>(price, quantity, owner, sink);
         }
     }
 
@@ -953,172 +2402,168 @@ public:
         }
     }
 
-    template <DOUBLEOPTION BookOrderPrio>
-    auto book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity) {
-        std::optional<std::tuple<ID_TYPE, Price*>> result;
+    template <DOUBLEOPTION FillOrderPrio, typename FillSink>
+    SIZE_TYPE market_match_quantity(SIDE side, SIZE_TYPE quantity, FillSink&& sink) {
         if (side == SIDE::BID) {
-            result = core_.template book_price_quantity<PriceUniquePtrCompareDescending, BookOrderPrio>(price, quantity);
+            return core_.template market_match_quantity<PriceUniquePtrCompareDescending, FillOrderPrio>(quantity, sink);
         } else {
-            result = core_.template book_price_quantity<PriceUniquePtrCompareAscending, BookOrderPrio>(price, quantity);
+            return core_.template market_match_quantity<PriceUniquePtrCompareAscending, FillOrderPrio>(quantity, sink);
         }
-        if (result) {
-            order_side_map_[std::get<0>(result.value())] = side;
+    }
+
+    template <DOUBLEOPTION BookOrderPrio>
+    auto book_price_quantity(SIDE side, PRICE_TYPE price, SIZE_TYPE quantity, OrderOwner owner = {}) {
+        if (side == SIDE::BID) {
+            return core_.template book_price_quantity<PriceUniquePtrCompareDescending, BookOrderPrio>(price, quantity, owner);
+        } else {
+            return core_.template book_price_quantity<PriceUniquePtrCompareAscending, BookOrderPrio>(price, quantity, owner);
         }
-        return result;
     }
 
     auto delete_limit_order(ID_TYPE target_uoid) {
-        auto map_it = order_side_map_.find(target_uoid);
-        if (map_it == order_side_map_.end()) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(target_uoid);
+        if (!order_side) {
             return std::optional<std::tuple<PRICE_TYPE, SIZE_TYPE>>{};
         }
-        SIDE order_side = map_it->second;
-
-        std::optional<std::tuple<PRICE_TYPE, SIZE_TYPE>> result;
-        if (order_side == SIDE::BID) {
-            result = core_.template delete_limit_order<PriceUniquePtrCompareDescending>(target_uoid);
+        if (*order_side == SIDE::BID) {
+            return core_.template delete_limit_order<PriceUniquePtrCompareDescending>(target_uoid);
         } else {
-            result = core_.template delete_limit_order<PriceUniquePtrCompareAscending>(target_uoid);
-        }
-
-        if (result) {
-            order_side_map_.erase(map_it);
+            return core_.template delete_limit_order<PriceUniquePtrCompareAscending>(target_uoid);
         }
-        return result;
     }
 
     template <TRIPLEOPTION PrioOpt>
     auto modify_limit_order_vol(ID_TYPE order_id, SIZE_TYPE new_volume) {
-        auto map_it = order_side_map_.find(order_id);
-        if (map_it == order_side_map_.end()) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(order_id);
+        if (!order_side) {
             return std::optional<ModifyVolResult>{};
         }
-        SIDE order_side = map_it->second;
-
-        std::optional<ModifyVolResult> result;
-        if (order_side == SIDE::BID) {
-            result = core_.template modify_limit_order_vol<PriceUniquePtrCompareDescending, PrioOpt>(order_id, new_volume);
+        if (*order_side == SIDE::BID) {
+            return core_.template modify_limit_order_vol<PriceUniquePtrCompareDescending, PrioOpt>(order_id, new_volume);
         } else {
-            result = core_.template modify_limit_order_vol<PriceUniquePtrCompareAscending, PrioOpt>(order_id, new_volume);
+            return core_.template modify_limit_order_vol<PriceUniquePtrCompareAscending, PrioOpt>(order_id, new_volume);
         }
-
-        if (result) {
-            if (result->removed) {
-                order_side_map_.erase(order_id);
-            } else if (result->new_uoid && result->new_uoid.value() != order_id) {
-                order_side_map_.erase(order_id);
-                order_side_map_[result->new_uoid.value()] = order_side;
-            }
-        }
-        return result;
     }
 
     template <TRIPLEOPTION PrioOpt>
     auto remove_limit_order_vol(ID_TYPE order_id, SIZE_TYPE cancel_amount) {
-        auto map_it = order_side_map_.find(order_id);
-        if (map_it == order_side_map_.end()) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(order_id);
+        if (!order_side) {
             return std::optional<ModifyVolResult>{};
         }
-        SIDE order_side = map_it->second;
-        std::optional<ModifyVolResult> result;
-
-        if (order_side == SIDE::BID) {
-            result = core_.template remove_limit_order_vol<PriceUniquePtrCompareDescending, PrioOpt>(order_id, cancel_amount);
+        if (*order_side == SIDE::BID) {
+            return core_.template remove_limit_order_vol<PriceUniquePtrCompareDescending, PrioOpt>(order_id, cancel_amount);
         } else {
-            result = core_.template remove_limit_order_vol<PriceUniquePtrCompareAscending, PrioOpt>(order_id, cancel_amount);
-        }
-         if (result) {
-            if (result->removed) {
-                order_side_map_.erase(order_id);
-            } else if (result->new_uoid && result->new_uoid.value() != order_id) {
-                order_side_map_.erase(order_id);
-                order_side_map_[result->new_uoid.value()] = order_side;
-            }
+            return core_.template remove_limit_order_vol<PriceUniquePtrCompareAscending, PrioOpt>(order_id, cancel_amount);
         }
-        return result;
     }
 
     template <TRIPLEOPTION PrioOpt>
     auto replace_limit_order_vol(ID_TYPE order_id_old, SIZE_TYPE volume_new) {
-        auto map_it = order_side_map_.find(order_id_old);
-        if (map_it == order_side_map_.end()) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(order_id_old);
+        if (!order_side) {
             return std::optional<std::tuple<ID_TYPE, ReplaceOrderResult>>{};
         }
-        SIDE order_side = map_it->second;
-
-        std::optional<std::tuple<ID_TYPE, ReplaceOrderResult>> result;
-        if (order_side == SIDE::BID) {
-            result = core_.template replace_limit_order_vol<PriceUniquePtrCompareDescending, PrioOpt>(order_id_old, volume_new);
+        if (*order_side == SIDE::BID) {
+            return core_.template replace_limit_order_vol<PriceUniquePtrCompareDescending, PrioOpt>(order_id_old, volume_new);
         } else {
-            result = core_.template replace_limit_order_vol<PriceUniquePtrCompareAscending, PrioOpt>(order_id_old, volume_new);
-        }
-
-        if (result) {
-            order_side_map_.erase(order_id_old);
-            ID_TYPE new_uoid_from_core = std::get<0>(result.value());
-            if(volume_new > 0) {
-                order_side_map_[new_uoid_from_core] = order_side;
-            }
+            return core_.template replace_limit_order_vol<PriceUniquePtrCompareAscending, PrioOpt>(order_id_old, volume_new);
         }
-        return result;
     }
 
     template <TRIPLEOPTION NewOrderPrio>
     auto modify_limit_order_price_vol(ID_TYPE order_id, PRICE_TYPE price, SIZE_TYPE volume) {
-        auto map_it = order_side_map_.find(order_id);
-        if (map_it == order_side_map_.end()) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(order_id);
+        if (!order_side) {
             return std::optional<ModifyPriceVolResult>{};
         }
-        SIDE order_side = map_it->second;
-
-        std::optional<ModifyPriceVolResult> result;
-        if (order_side == SIDE::BID) {
-            result = core_.template modify_limit_order_price_vol<PriceUniquePtrCompareDescending, NewOrderPrio>(price, volume, order_id);
+        if (*order_side == SIDE::BID) {
+            return core_.template modify_limit_order_price_vol<PriceUniquePtrCompareDescending, NewOrderPrio>(price, volume, order_id);
         } else {
-            result = core_.template modify_limit_order_price_vol<PriceUniquePtrCompareAscending, NewOrderPrio>(price, volume, order_id);
+            return core_.template modify_limit_order_price_vol<PriceUniquePtrCompareAscending, NewOrderPrio>(price, volume, order_id);
         }
+    }
 
-        if (result) {
-            order_side_map_.erase(order_id);
-            if (result->new_uoid) {
-                order_side_map_[result->new_uoid.value()] = order_side;
-            }
+    auto amend_limit_order(ID_TYPE order_id, PRICE_TYPE price, SIZE_TYPE volume) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(order_id);
+        if (!order_side) {
+            return std::optional<ModifyPriceVolResult>{};
+        }
+        if (*order_side == SIDE::BID) {
+            return core_.template amend_limit_order<PriceUniquePtrCompareDescending>(order_id, price, volume);
+        } else {
+            return core_.template amend_limit_order<PriceUniquePtrCompareAscending>(order_id, price, volume);
         }
-        return result;
+    }
+
+    template <typename CancelSink>
+    std::size_t cancel_orders_of_owner(std::uint64_t trader_id, std::optional<SIDE> side, std::optional<PRICE_TYPE> min_price,
+                                       std::optional<PRICE_TYPE> max_price, CancelSink&& on_cancel) {
+        return core_.cancel_orders_of_owner(trader_id, side, min_price, max_price, std::forward<CancelSink>(on_cancel));
     }
 
     template <TRIPLEOPTION NewOrderPrio>
     auto modify_limit_order_price(ID_TYPE order_id, PRICE_TYPE price) {
-        auto map_it = order_side_map_.find(order_id);
-        if (map_it == order_side_map_.end()) {
+        std::optional<SIDE> order_side = core_.get_side_of_order(order_id);
+        if (!order_side) {
             return std::optional<ModifyPriceResult>{};
         }
-        SIDE order_side = map_it->second;
-
-        std::optional<ModifyPriceResult> result;
-        if (order_side == SIDE::BID) {
-            result = core_.template modify_limit_order_price<PriceUniquePtrCompareDescending, NewOrderPrio>(price, order_id);
+        if (*order_side == SIDE::BID) {
+            return core_.template modify_limit_order_price<PriceUniquePtrCompareDescending, NewOrderPrio>(price, order_id);
         } else {
-            result = core_.template modify_limit_order_price<PriceUniquePtrCompareAscending, NewOrderPrio>(price, order_id);
-        }
-
-        if (result) {
-            order_side_map_.erase(order_id);
-            if (result->new_uoid) {
-                order_side_map_[result->new_uoid.value()] = order_side;
-            }
+            return core_.template modify_limit_order_price<PriceUniquePtrCompareAscending, NewOrderPrio>(price, order_id);
         }
-        return result;
     }
 
     void flush() {
         core_.flush();
-        order_side_map_.clear();
     }
 
     auto get_state_l2() const {
         return core_.get_state_l2();
     }
+
+    auto get_state_l2(size_t max_depth) const {
+        return core_.get_state_l2(max_depth);
+    }
+
+    // Depth queries take the side of the incoming order and look at the opposite side of the book.
+    PRICE_TYPE get_price_for_volume(SIDE side, SIZE_TYPE volume) const {
+        if (side == SIDE::BID) return core_.template get_price_for_volume<PriceUniquePtrCompareDescending>(volume);
+        return core_.template get_price_for_volume<PriceUniquePtrCompareAscending>(volume);
+    }
+
+    SIZE_TYPE get_available_volume(SIDE side) const {
+        if (side == SIDE::BID) return core_.template get_available_volume<PriceUniquePtrCompareDescending>();
+        return core_.template get_available_volume<PriceUniquePtrCompareAscending>();
+    }
+
+    SIZE_TYPE get_volume_for_price(SIDE side, PRICE_TYPE price) const {
+        if (side == SIDE::BID) return core_.template get_volume_for_price<PriceUniquePtrCompareDescending>(price);
+        return core_.template get_volume_for_price<PriceUniquePtrCompareAscending>(price);
+    }
+
+    std::optional<PRICE_TYPE> get_price_at_depth(SIDE side, SIZE_TYPE volume) const {
+        if (side == SIDE::BID) return core_.template get_price_at_depth<PriceUniquePtrCompareDescending>(volume);
+        return core_.template get_price_at_depth<PriceUniquePtrCompareAscending>(volume);
+    }
+
+    auto get_best_bid() const { return core_.get_best_bid(); }
+    auto get_best_ask() const { return core_.get_best_ask(); }
+
+    void set_depth_cache_levels(size_t levels) { core_.set_depth_cache_levels(levels); }
+
+    std::vector<L3LevelView> get_state_l3(SIDE side, size_t max_depth) const { return core_.get_state_l3(side, max_depth); }
+
+    void set_order_journal_enabled(bool enabled) { core_.set_order_journal_enabled(enabled); }
+    bool is_order_journal_enabled() const { return core_.is_order_journal_enabled(); }
+    bool has_order_changes() const { return core_.has_order_changes(); }
+    const std::vector<OrderChange>& get_order_changes() const { return core_.get_order_changes(); }
+    void clear_order_changes() { core_.clear_order_changes(); }
+
+    bool has_level_changes() const { return core_.has_level_changes(); }
+    const std::vector<LevelChange>& get_level_changes() const { return core_.get_level_changes(); }
+    void clear_level_changes() { core_.clear_level_changes(); }
 };
 
 #endif //EXCHANGE_ORDERBOOKCORE_H
\ No newline at end of file
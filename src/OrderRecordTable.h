@@ -0,0 +1,271 @@
+// file: src/OrderRecordTable.h
+#pragma once
+
+#include "Globals.h"
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include <cassert>
+#include <functional>
+
+// Hash map operations and direct table probes of an OrderRecordTable so far, for comparing layouts.
+struct OrderRecordTableStats {
+    std::uint64_t hash_probes = 0;
+    std::uint64_t table_probes = 0;
+};
+
+// One record per order, kept in a slab and found either by exchange order ID or by owner (trader, client order ID).
+// Exchange order IDs count up from two bases (resting and transient IDs), so each range addresses a chunked table
+// of slab slots directly and a lookup by ID is an array probe; IDs outside both ranges fall back to a hash map.
+// Only the owner index is hashed, once when an order is linked to its owner and once when it is unlinked.
+// As in OrderLocator, a chunk below the newest one of its range is recycled once none of its IDs has a record.
+template <typename Record>
+class OrderRecordTable {
+public:
+    using OwnerKey = std::pair<std::uint64_t, std::uint64_t>; // (trader ID, client order ID)
+
+    // IDs in [id_base, transient_id_base) and [transient_id_base, id_base + range_span) are indexed directly.
+    OrderRecordTable(ID_TYPE id_base, ID_TYPE transient_id_base, ID_TYPE range_span)
+            : ranges_{IdRange(id_base, transient_id_base - id_base),
+                      IdRange(transient_id_base, id_base + range_span - transient_id_base)} {}
+
+    OrderRecordTable(const OrderRecordTable&) = delete;
+    OrderRecordTable& operator=(const OrderRecordTable&) = delete;
+
+    Record* find(ID_TYPE id) {
+        Slot slot = _find_slot(id);
+        return slot != NO_SLOT ? &slab_[slot].record_ : nullptr;
+    }
+
+    // The record of `id`, default-constructed if it has none.
+    Record& emplace(ID_TYPE id) {
+        Slot& slot = _slot_ref(id);
+        if (slot == NO_SLOT) {
+            slot = _take_slot(id);
+        }
+        return slab_[slot].record_;
+    }
+
+    // Drops the record of `id`, and its owner link if any.
+    void erase(ID_TYPE id) {
+        Slot slot = _find_slot(id);
+        if (slot == NO_SLOT) {
+            return;
+        }
+        _unlink(slot);
+        _release_id(id);
+        slab_[slot] = Entry{};
+        free_slots_.push_back(slot);
+        --size_;
+    }
+
+    // Links the record of `id` (which must exist) to its owner. A later link of the same owner takes over the key.
+    void link_owner(ID_TYPE id, std::uint64_t trader_id, std::uint64_t client_order_id) {
+        Slot slot = _find_slot(id);
+        assert(slot != NO_SLOT && "OrderRecordTable: linking an ID without a record.");
+        _unlink(slot);
+        Entry& entry = slab_[slot];
+        entry.owner_ = OwnerKey{trader_id, client_order_id};
+        entry.linked_ = true;
+        ++stats_.hash_probes;
+        owner_index_[entry.owner_] = slot;
+    }
+
+    // Returns false if the record of `id` was not linked.
+    bool unlink_owner(ID_TYPE id) {
+        Slot slot = _find_slot(id);
+        return slot != NO_SLOT && _unlink(slot);
+    }
+
+    std::optional<OwnerKey> owner(ID_TYPE id) {
+        Slot slot = _find_slot(id);
+        if (slot == NO_SLOT || !slab_[slot].linked_) {
+            return std::nullopt;
+        }
+        return slab_[slot].owner_;
+    }
+
+    std::optional<ID_TYPE> find_by_owner(std::uint64_t trader_id, std::uint64_t client_order_id) {
+        ++stats_.hash_probes;
+        auto it = owner_index_.find(OwnerKey{trader_id, client_order_id});
+        if (it == owner_index_.end()) {
+            return std::nullopt;
+        }
+        return slab_[it->second].id_;
+    }
+
+    std::size_t size() const { return size_; }
+    const OrderRecordTableStats& stats() const { return stats_; }
+
+    void clear() {
+        for (IdRange& range : ranges_) {
+            for (auto& chunk : range.chunks_) {
+                if (chunk) {
+                    std::fill(std::begin(chunk->slots_), std::end(chunk->slots_), NO_SLOT);
+                    chunk->live_ = 0;
+                    spare_chunks_.push_back(std::move(chunk));
+                }
+            }
+            range.chunks_.clear();
+            range.top_chunk_ = 0;
+        }
+        overflow_index_.clear();
+        owner_index_.clear();
+        slab_.clear();
+        free_slots_.clear();
+        size_ = 0;
+    }
+
+private:
+    using Slot = std::uint32_t;
+    static constexpr Slot NO_SLOT = std::numeric_limits<Slot>::max();
+    static constexpr std::size_t CHUNK_BITS = 12;
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{1} << CHUNK_BITS;
+
+    struct Entry {
+        ID_TYPE id_ = ID_DEFAULT;
+        OwnerKey owner_{};
+        bool linked_ = false;
+        Record record_{};
+    };
+
+    struct Chunk {
+        Chunk() { std::fill(std::begin(slots_), std::end(slots_), NO_SLOT); }
+        Slot slots_[CHUNK_SIZE];
+        std::size_t live_ = 0;
+    };
+
+    struct IdRange {
+        IdRange(ID_TYPE base, ID_TYPE span) : base_(base), span_(span) {}
+
+        ID_TYPE base_;
+        ID_TYPE span_;
+        std::vector<std::unique_ptr<Chunk>> chunks_;
+        std::size_t top_chunk_ = 0;
+    };
+
+    struct OwnerKeyHash {
+        std::size_t operator()(const OwnerKey& key) const {
+            std::size_t h1 = std::hash<std::uint64_t>{}(key.first);
+            std::size_t h2 = std::hash<std::uint64_t>{}(key.second);
+            return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
+        }
+    };
+
+    bool _unlink(Slot slot) {
+        Entry& entry = slab_[slot];
+        if (!entry.linked_) {
+            return false;
+        }
+        ++stats_.hash_probes;
+        auto it = owner_index_.find(entry.owner_);
+        if (it != owner_index_.end() && it->second == slot) { // Unless a later order of the same owner took the key
+            owner_index_.erase(it);
+        }
+        entry.linked_ = false;
+        return true;
+    }
+
+    IdRange* _range_of(ID_TYPE id) {
+        for (IdRange& range : ranges_) {
+            if (id - range.base_ < range.span_) { // IDs below the base wrap past the span
+                return &range;
+            }
+        }
+        return nullptr;
+    }
+
+    Slot _find_slot(ID_TYPE id) {
+        IdRange* range = _range_of(id);
+        if (!range) {
+            ++stats_.hash_probes;
+            auto it = overflow_index_.find(id);
+            return it != overflow_index_.end() ? it->second : NO_SLOT;
+        }
+        ++stats_.table_probes;
+        ID_TYPE offset = id - range->base_;
+        std::size_t chunk_idx = static_cast<std::size_t>(offset >> CHUNK_BITS);
+        if (chunk_idx >= range->chunks_.size() || !range->chunks_[chunk_idx]) {
+            return NO_SLOT;
+        }
+        return range->chunks_[chunk_idx]->slots_[offset & (CHUNK_SIZE - 1)];
+    }
+
+    // The index cell of `id`, creating its chunk if needed.
+    Slot& _slot_ref(ID_TYPE id) {
+        IdRange* range = _range_of(id);
+        if (!range) {
+            ++stats_.hash_probes;
+            return overflow_index_.try_emplace(id, NO_SLOT).first->second;
+        }
+        ++stats_.table_probes;
+        ID_TYPE offset = id - range->base_;
+        std::size_t chunk_idx = static_cast<std::size_t>(offset >> CHUNK_BITS);
+        if (chunk_idx >= range->chunks_.size()) {
+            range->chunks_.resize(chunk_idx + 1);
+        }
+        if (!range->chunks_[chunk_idx]) {
+            range->chunks_[chunk_idx] = _take_chunk();
+        }
+        range->top_chunk_ = std::max(range->top_chunk_, chunk_idx);
+        return range->chunks_[chunk_idx]->slots_[offset & (CHUNK_SIZE - 1)];
+    }
+
+    Slot _take_slot(ID_TYPE id) {
+        Slot slot;
+        if (free_slots_.empty()) {
+            slot = static_cast<Slot>(slab_.size());
+            slab_.emplace_back();
+        } else {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        }
+        slab_[slot].id_ = id;
+        if (IdRange* range = _range_of(id)) {
+            ++range->chunks_[static_cast<std::size_t>((id - range->base_) >> CHUNK_BITS)]->live_;
+        }
+        ++size_;
+        return slot;
+    }
+
+    void _release_id(ID_TYPE id) {
+        IdRange* range = _range_of(id);
+        if (!range) {
+            ++stats_.hash_probes;
+            overflow_index_.erase(id);
+            return;
+        }
+        ++stats_.table_probes;
+        ID_TYPE offset = id - range->base_;
+        std::size_t chunk_idx = static_cast<std::size_t>(offset >> CHUNK_BITS);
+        Chunk& chunk = *range->chunks_[chunk_idx];
+        chunk.slots_[offset & (CHUNK_SIZE - 1)] = NO_SLOT;
+        if (--chunk.live_ == 0 && chunk_idx < range->top_chunk_) {
+            spare_chunks_.push_back(std::move(range->chunks_[chunk_idx]));
+        }
+    }
+
+    std::unique_ptr<Chunk> _take_chunk() {
+        if (spare_chunks_.empty()) {
+            return std::make_unique<Chunk>();
+        }
+        std::unique_ptr<Chunk> chunk = std::move(spare_chunks_.back());
+        spare_chunks_.pop_back();
+        return chunk;
+    }
+
+    IdRange ranges_[2];
+    std::vector<std::unique_ptr<Chunk>> spare_chunks_;
+    std::unordered_map<ID_TYPE, Slot> overflow_index_;
+    std::unordered_map<OwnerKey, Slot, OwnerKeyHash> owner_index_;
+    std::vector<Entry> slab_;
+    std::vector<Slot> free_slots_;
+    std::size_t size_ = 0;
+    OrderRecordTableStats stats_;
+};
@@ -34,7 +34,8 @@ class TradingPrePublishHook : public EventBusSystem::PrePublishHook<TradingPrePu
             ModelEvents::PartialFillMarketOrderEvent,
             ModelEvents::FullFillLimitOrderEvent, ModelEvents::FullFillMarketOrderEvent, ModelEvents::TradeEvent,
             ModelEvents::TriggerExpiredLimitOrderEvent, ModelEvents::RejectTriggerExpiredLimitOrderEvent,
-            ModelEvents::AckTriggerExpiredLimitOrderEvent> {
+            ModelEvents::AckTriggerExpiredLimitOrderEvent, ModelEvents::MassCancelLimitOrderEvent,
+            ModelEvents::MassCancelLimitOrderAckEvent, ModelEvents::LTwoDeltaEvent, ModelEvents::L2PublishTimerEvent> {
 public:
     using Base = EventBusSystem::PrePublishHook<TradingPrePublishHook, ModelEvents::CheckLimitOrderExpirationEvent,
         ModelEvents::Bang, ModelEvents::LTwoOrderBookEvent,
@@ -51,7 +52,8 @@ public:
         ModelEvents::PartialFillMarketOrderEvent,
         ModelEvents::FullFillLimitOrderEvent, ModelEvents::FullFillMarketOrderEvent, ModelEvents::TradeEvent,
         ModelEvents::TriggerExpiredLimitOrderEvent, ModelEvents::RejectTriggerExpiredLimitOrderEvent,
-        ModelEvents::AckTriggerExpiredLimitOrderEvent>;
+        ModelEvents::AckTriggerExpiredLimitOrderEvent, ModelEvents::MassCancelLimitOrderEvent,
+        ModelEvents::MassCancelLimitOrderAckEvent, ModelEvents::LTwoDeltaEvent, ModelEvents::L2PublishTimerEvent>;
     using AgentId = EventBusSystem::AgentId;
     using TopicId = EventBusSystem::TopicId;
     using Timestamp = EventBusSystem::Timestamp;
@@ -220,6 +222,26 @@ public:
         this->on_pre_publish_AckTriggerExpiredLimitOrderEvent(event, pid, tid, ts, bus);
     }
 
+    void handle_pre_publish(const ModelEvents::MassCancelLimitOrderEvent &event, AgentId pid, TopicId tid,
+                            Timestamp ts, const BusT *bus) {
+        this->on_pre_publish_MassCancelLimitOrderEvent(event, pid, tid, ts, bus);
+    }
+
+    void handle_pre_publish(const ModelEvents::MassCancelLimitOrderAckEvent &event, AgentId pid, TopicId tid,
+                            Timestamp ts, const BusT *bus) {
+        this->on_pre_publish_MassCancelLimitOrderAckEvent(event, pid, tid, ts, bus);
+    }
+
+    void handle_pre_publish(const ModelEvents::LTwoDeltaEvent &event, AgentId pid, TopicId tid, Timestamp ts,
+                            const BusT *bus) {
+        this->on_pre_publish_LTwoDeltaEvent(event, pid, tid, ts, bus);
+    }
+
+    void handle_pre_publish(const ModelEvents::L2PublishTimerEvent &event, AgentId pid, TopicId tid, Timestamp ts,
+                            const BusT *bus) {
+        this->on_pre_publish_L2PublishTimerEvent(event, pid, tid, ts, bus);
+    }
+
     // --- Virtual on_pre_publish_SpecificEvent methods for derived classes to override ---
     // Default implementations call on_pre_publish_event_default_dispatch.
 
@@ -375,6 +397,26 @@ public:
         on_pre_publish_event_default_dispatch(e, pid, tid, ts, b);
     }
 
+    virtual void on_pre_publish_MassCancelLimitOrderEvent(const ModelEvents::MassCancelLimitOrderEvent &e,
+                                                          AgentId pid, TopicId tid, Timestamp ts, const BusT *b) {
+        on_pre_publish_event_default_dispatch(e, pid, tid, ts, b);
+    }
+
+    virtual void on_pre_publish_MassCancelLimitOrderAckEvent(const ModelEvents::MassCancelLimitOrderAckEvent &e,
+                                                             AgentId pid, TopicId tid, Timestamp ts, const BusT *b) {
+        on_pre_publish_event_default_dispatch(e, pid, tid, ts, b);
+    }
+
+    virtual void on_pre_publish_LTwoDeltaEvent(const ModelEvents::LTwoDeltaEvent &e, AgentId pid, TopicId tid,
+                                               Timestamp ts, const BusT *b) {
+        on_pre_publish_event_default_dispatch(e, pid, tid, ts, b);
+    }
+
+    virtual void on_pre_publish_L2PublishTimerEvent(const ModelEvents::L2PublishTimerEvent &e, AgentId pid,
+                                                    TopicId tid, Timestamp ts, const BusT *b) {
+        on_pre_publish_event_default_dispatch(e, pid, tid, ts, b);
+    }
+
 
     // Templated fallback to call the base's default handler.
     // This is crucial for the CRTP mechanism of EventBusSystem::PrePublishHook.
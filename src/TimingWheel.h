@@ -0,0 +1,209 @@
+// file: src/TimingWheel.h
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include "Globals.h"
+
+#include <array>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+// Hierarchical timing wheel of order expiries keyed by simulated time (TIME_TYPE units). Time is cut into ticks of
+// `tick` units; an entry fires on the first advance() that reaches the tick boundary at or after its due time, so it
+// is at most one tick late and never early. With the default tick of one unit it fires exactly at its due time.
+// Level l has 64 slots of 64^l ticks each; an entry sits on the level of the highest 6-bit tick group in which it
+// differs from the wheel's current tick and cascades one level down when the wheel reaches its slot. Occupancy
+// bitmaps let advance() and next_due_time() jump straight to the next non-empty slot, and each slot keeps the
+// earliest due time it holds, so idle stretches cost nothing and callers never wake up just for a cascade.
+// Entries are never removed early: callers check on fire whether the ID is still live.
+class TimingWheel {
+public:
+    struct Entry {
+        ID_TYPE id_;
+        TIME_TYPE due_;
+        TIME_TYPE timeout_; // As requested, reported back when the entry fires
+    };
+
+    explicit TimingWheel(TIME_TYPE tick = 1) : tick_(std::max<TIME_TYPE>(tick, 1)) {}
+
+    TIME_TYPE tick() const { return tick_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void insert(ID_TYPE id, TIME_TYPE due, TIME_TYPE timeout) {
+        _place(Entry{id, due, timeout});
+        ++size_;
+    }
+
+    // Fires every entry due at or before `now`, in (due time, ID) order within each tick.
+    template <typename Sink>
+    void advance(TIME_TYPE now, Sink&& sink) {
+        std::uint64_t target = _tick_floor(now);
+        _fire(ready_, sink);
+        while (std::optional<std::uint64_t> next = _next_tick()) {
+            if (*next > target) {
+                break;
+            }
+            current_tick_ = *next;
+            _process_current_tick();
+            _fire(ready_, sink);
+        }
+        // Safe to jump: every occupied slot starts after `target`.
+        current_tick_ = std::max(current_tick_, target);
+    }
+
+    // Earliest time at which advance() fires an entry, nullopt if empty. The earliest entry is in the first occupied
+    // slot of the lowest occupied level (or in overflow_ if all levels are empty), so this is O(levels).
+    std::optional<TIME_TYPE> next_due_time() const {
+        if (!ready_.empty()) {
+            return static_cast<TIME_TYPE>(current_tick_) * tick_;
+        }
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            if (occupied_[level] != 0) {
+                unsigned slot = static_cast<unsigned>(std::countr_zero(occupied_[level]));
+                return static_cast<TIME_TYPE>(_tick_ceil(slot_min_due_[level][slot])) * tick_;
+            }
+        }
+        if (!overflow_.empty()) {
+            return static_cast<TIME_TYPE>(_tick_ceil(overflow_min_due_)) * tick_;
+        }
+        return std::nullopt;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Entry& entry : ready_) fn(entry);
+        for (const auto& level : slots_) {
+            for (const auto& slot : level) {
+                for (const Entry& entry : slot) fn(entry);
+            }
+        }
+        for (const Entry& entry : overflow_) fn(entry);
+    }
+
+    // Drops all entries and moves the wheel to `now`.
+    void reset(TIME_TYPE now) {
+        clear();
+        current_tick_ = _tick_floor(now);
+    }
+
+    // Drops all entries; the wheel's position in time is kept.
+    void clear() {
+        ready_.clear();
+        for (auto& level : slots_) {
+            for (auto& slot : level) slot.clear();
+        }
+        occupied_.fill(0);
+        overflow_.clear();
+        size_ = 0;
+    }
+
+private:
+    static constexpr unsigned LEVEL_BITS = 6;
+    static constexpr unsigned SLOTS = 1u << LEVEL_BITS;
+    static constexpr unsigned LEVELS = 6; // 2^36 ticks ahead; anything later waits in overflow_
+    static constexpr std::uint64_t SLOT_MASK = SLOTS - 1;
+
+    std::uint64_t _tick_floor(TIME_TYPE t) const { return t <= 0 ? 0 : static_cast<std::uint64_t>(t / tick_); }
+    std::uint64_t _tick_ceil(TIME_TYPE t) const { return t <= 0 ? 0 : static_cast<std::uint64_t>((t + tick_ - 1) / tick_); }
+
+    void _place(const Entry& entry) {
+        std::uint64_t due_tick = _tick_ceil(entry.due_);
+        if (due_tick <= current_tick_) {
+            ready_.push_back(entry);
+            return;
+        }
+        unsigned level = static_cast<unsigned>(std::bit_width(due_tick ^ current_tick_) - 1) / LEVEL_BITS;
+        if (level >= LEVELS) {
+            overflow_min_due_ = overflow_.empty() ? entry.due_ : std::min(overflow_min_due_, entry.due_);
+            overflow_.push_back(entry);
+            return;
+        }
+        unsigned slot = static_cast<unsigned>((due_tick >> (level * LEVEL_BITS)) & SLOT_MASK);
+        std::uint64_t slot_bit = std::uint64_t(1) << slot;
+        TIME_TYPE& min_due = slot_min_due_[level][slot];
+        min_due = (occupied_[level] & slot_bit) ? std::min(min_due, entry.due_) : entry.due_;
+        slots_[level][slot].push_back(entry);
+        occupied_[level] |= slot_bit;
+    }
+
+    // Start tick of the first occupied slot. Lower levels always come first: their slots lie inside the current
+    // slot of every level above.
+    std::optional<std::uint64_t> _next_tick() const {
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            if (occupied_[level] == 0) {
+                continue;
+            }
+            unsigned shift = level * LEVEL_BITS;
+            std::uint64_t block = current_tick_ >> (shift + LEVEL_BITS);
+            unsigned slot = static_cast<unsigned>(std::countr_zero(occupied_[level]));
+            return (((block << LEVEL_BITS) | slot) << shift);
+        }
+        if (!overflow_.empty()) {
+            // Re-place overflow entries when the wheel wraps its top level.
+            return ((current_tick_ >> (LEVELS * LEVEL_BITS)) + 1) << (LEVELS * LEVEL_BITS);
+        }
+        return std::nullopt;
+    }
+
+    void _process_current_tick() {
+        if ((current_tick_ & ((std::uint64_t(1) << (LEVELS * LEVEL_BITS)) - 1)) == 0 && !overflow_.empty()) {
+            cascade_scratch_.swap(overflow_);
+            for (const Entry& entry : cascade_scratch_) _place(entry);
+            cascade_scratch_.clear();
+        }
+        for (unsigned level = LEVELS - 1; level > 0; --level) {
+            unsigned shift = level * LEVEL_BITS;
+            if ((current_tick_ & ((std::uint64_t(1) << shift) - 1)) != 0) {
+                continue; // Not on a slot boundary of this level
+            }
+            unsigned slot = static_cast<unsigned>((current_tick_ >> shift) & SLOT_MASK);
+            if ((occupied_[level] & (std::uint64_t(1) << slot)) == 0) {
+                continue;
+            }
+            occupied_[level] &= ~(std::uint64_t(1) << slot);
+            cascade_scratch_.swap(slots_[level][slot]);
+            for (const Entry& entry : cascade_scratch_) _place(entry);
+            cascade_scratch_.clear();
+        }
+        unsigned slot = static_cast<unsigned>(current_tick_ & SLOT_MASK);
+        if (occupied_[0] & (std::uint64_t(1) << slot)) {
+            occupied_[0] &= ~(std::uint64_t(1) << slot);
+            std::vector<Entry>& due = slots_[0][slot];
+            ready_.insert(ready_.end(), due.begin(), due.end());
+            due.clear();
+        }
+    }
+
+    template <typename Sink>
+    void _fire(std::vector<Entry>& entries, Sink& sink) {
+        if (entries.empty()) {
+            return;
+        }
+        // The sink may insert (e.g. an order placed from a callback), so fire from a separate buffer.
+        fire_scratch_.swap(entries);
+        std::sort(fire_scratch_.begin(), fire_scratch_.end(), [](const Entry& a, const Entry& b) {
+            return a.due_ != b.due_ ? a.due_ < b.due_ : a.id_ < b.id_;
+        });
+        size_ -= fire_scratch_.size();
+        for (const Entry& entry : fire_scratch_) sink(entry);
+        fire_scratch_.clear();
+    }
+
+    TIME_TYPE tick_;
+    std::uint64_t current_tick_ = 0;
+    size_t size_ = 0;
+    std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> slots_;
+    std::array<std::uint64_t, LEVELS> occupied_{};
+    std::array<std::array<TIME_TYPE, SLOTS>, LEVELS> slot_min_due_{}; // Earliest due time per occupied slot
+    std::vector<Entry> ready_;    // Due at or before current_tick_, fired on the next advance()
+    std::vector<Entry> overflow_; // Beyond the top level's range
+    TIME_TYPE overflow_min_due_ = 0;
+    std::vector<Entry> cascade_scratch_;
+    std::vector<Entry> fire_scratch_;
+};
+
+#endif //TIMING_WHEEL_H
@@ -17,6 +17,9 @@
 #include <chrono>
 #include <utility>
 #include <random>
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
 #include "Logging.h"
 
 // Define Latency Profiles (keep as is)
@@ -56,7 +59,8 @@ using AllSimulationEventTypesList = EventBusSystem::TypeList<
     ModelEvents::LimitOrderExpiredEvent, ModelEvents::PartialFillLimitOrderEvent, ModelEvents::PartialFillMarketOrderEvent,
     ModelEvents::FullFillLimitOrderEvent, ModelEvents::FullFillMarketOrderEvent, ModelEvents::TradeEvent,
     ModelEvents::TriggerExpiredLimitOrderEvent, ModelEvents::RejectTriggerExpiredLimitOrderEvent,
-    ModelEvents::AckTriggerExpiredLimitOrderEvent
+    ModelEvents::AckTriggerExpiredLimitOrderEvent, ModelEvents::MassCancelLimitOrderEvent,
+    ModelEvents::MassCancelLimitOrderAckEvent, ModelEvents::LTwoDeltaEvent, ModelEvents::L2PublishTimerEvent
 >;
 
 // Helper to unpack TypeList into variadic template arguments (keep this)
@@ -100,30 +104,63 @@ public:
     >;
 
 
+    // Limit order expiry goes through the CancelFairyApp round trip by default, which keeps the original event trace.
+    // `use_cancel_fairy = false` expires orders inside the exchange instead (see set_native_expiry).
     explicit TradingSimulation(
             const SymbolType& symbol,
-            unsigned int bus_seed = 0
+            unsigned int bus_seed = 0,
+            bool use_cancel_fairy = true
+    )
+            : TradingSimulation(std::vector<SymbolType>{symbol}, bus_seed, use_cancel_fairy) {}
+
+    // One exchange adapter (and book, in its own order ID space) per symbol; the bus routes each `*.SYMBOL` topic
+    // to its symbol's adapter. Batches of different symbols at the same simulated instant run concurrently on up to
+    // `exchange_threads` threads (0: one per symbol, capped at the core count); see ExchangeShardGroup.
+    explicit TradingSimulation(
+            const std::vector<SymbolType>& symbols,
+            unsigned int bus_seed = 0,
+            bool use_cancel_fairy = true,
+            std::size_t exchange_threads = 0
     )
             : event_bus_(Timestamp{}, bus_seed), // This will now correctly instantiate
                                                // TopicBasedEventBus with the single list from ModelEventBus<>
-              symbol_(symbol),
+              symbols_(symbols),
               latency_rng_(bus_seed + 1) {
-        // ... (rest of constructor as before)
+        if (symbols_.empty()) {
+            throw std::invalid_argument("TradingSimulation needs at least one symbol.");
+        }
+        symbol_ = symbols_.front();
+
         environment_processor_ = std::make_shared<EnvironmentProcessor>();
         environment_processor_id_ = event_bus_.register_entity(environment_processor_.get());
 
-        cancel_fairy_ = std::make_shared<CancelFairyApp>();
-        cancel_fairy_id_ = event_bus_.register_entity(cancel_fairy_.get());
+        if (use_cancel_fairy) {
+            cancel_fairy_ = std::make_shared<CancelFairyApp>();
+            cancel_fairy_id_ = event_bus_.register_entity(cancel_fairy_.get());
+        }
 
-        exchange_adapter_ = std::make_shared<EventModelExchangeAdapter>(symbol_);
-        exchange_adapter_id_ = event_bus_.register_entity(exchange_adapter_.get());
+        for (std::size_t i = 0; i < symbols_.size(); ++i) {
+            auto adapter = std::make_shared<EventModelExchangeAdapter>(symbols_[i], static_cast<ID_TYPE>(i));
+            exchange_adapter_ids_.push_back(event_bus_.register_entity(adapter.get()));
+            adapter->set_native_expiry(!use_cancel_fairy);
+            exchange_adapters_.push_back(std::move(adapter));
+        }
 
         environment_processor_->setup_subscriptions();
-        cancel_fairy_->setup_subscriptions();
-        exchange_adapter_->setup_subscriptions();
+        if (cancel_fairy_) cancel_fairy_->setup_subscriptions();
+        for (const auto& adapter : exchange_adapters_) adapter->setup_subscriptions();
 
-        LogMessage(LogLevel::INFO, get_logger_source(), "TradingSimulation initialized for symbol: " + symbol_);
-        LogMessage(LogLevel::INFO, get_logger_source(), "Assigned IDs: Environment=" + std::to_string(environment_processor_id_) + ", CancelFairy=" + std::to_string(cancel_fairy_id_) + ", ExchangeAdapter=" + std::to_string(exchange_adapter_id_));
+        if (exchange_adapters_.size() > 1) {
+            std::size_t threads = exchange_threads;
+            if (threads == 0) {
+                threads = std::min<std::size_t>(exchange_adapters_.size(), std::max(1u, std::thread::hardware_concurrency()));
+            }
+            exchange_shards_ = std::make_unique<EventModelExchangeAdapter::ShardGroup>(threads - 1); // Bus thread works too
+            for (const auto& adapter : exchange_adapters_) exchange_shards_->add_shard(*adapter);
+        }
+
+        LogMessage(LogLevel::INFO, get_logger_source(), "TradingSimulation initialized for " + std::to_string(symbols_.size()) + " symbol(s), first: " + symbol_);
+        LogMessage(LogLevel::INFO, get_logger_source(), "Assigned IDs: Environment=" + std::to_string(environment_processor_id_) + ", CancelFairy=" + std::to_string(cancel_fairy_id_) + ", first ExchangeAdapter=" + std::to_string(exchange_adapter_ids_.front()));
 
         configure_core_component_latencies();
     }
@@ -139,7 +176,8 @@ public:
         }
         traders_.clear();
 
-        if (exchange_adapter_) event_bus_.deregister_entity(exchange_adapter_id_);
+        exchange_shards_.reset();
+        for (AgentId adapter_id : exchange_adapter_ids_) event_bus_.deregister_entity(adapter_id);
         if (cancel_fairy_) event_bus_.deregister_entity(cancel_fairy_id_);
         if (environment_processor_) event_bus_.deregister_entity(environment_processor_id_);
     }
@@ -181,6 +219,7 @@ public:
             return EventBusSystem::INVALID_AGENT_ID;
         }
         trader->setup_subscriptions();
+        for (const auto& adapter : exchange_adapters_) adapter->prepare_trader(trader_id);
         traders_[trader_id] = trader;
         LogMessage(LogLevel::INFO, get_logger_source(), "Added trader with ID: " + std::to_string(trader_id));
 
@@ -200,6 +239,14 @@ public:
     std::shared_ptr<const ModelEvents::LTwoOrderBookEvent> create_order_book_snapshot(
             FloatOrderBookLevel bids_float,
             FloatOrderBookLevel asks_float
+    ) {
+        return create_order_book_snapshot(symbol_, std::move(bids_float), std::move(asks_float));
+    }
+
+    std::shared_ptr<const ModelEvents::LTwoOrderBookEvent> create_order_book_snapshot(
+            const SymbolType& symbol,
+            FloatOrderBookLevel bids_float,
+            FloatOrderBookLevel asks_float
     ) {
         ModelEvents::OrderBookLevel bids_int;
         bids_int.reserve(bids_float.size());
@@ -220,21 +267,21 @@ public:
         }
 
         Timestamp current_time = event_bus_.get_current_time();
-        auto order_book_event_ptr = std::make_shared<const ModelEvents::LTwoOrderBookEvent>(
+        auto order_book_event_ptr = ModelEvents::make_event<ModelEvents::LTwoOrderBookEvent>(
                 current_time,
-                symbol_,
+                symbol,
                 current_time,
                 current_time,
                 std::move(bids_int),
                 std::move(asks_int)
         );
 
-        std::string stream_id = "orderbook_snapshot_" + symbol_;
-        std::string topic = "LTwoOrderBookEvent." + symbol_;
+        std::string stream_id = "orderbook_snapshot_" + symbol;
+        std::string topic = "LTwoOrderBookEvent." + symbol;
 
         event_bus_.publish(environment_processor_id_, topic, order_book_event_ptr, stream_id);
 
-        LogMessage(LogLevel::DEBUG, get_logger_source(), "Published LTwoOrderBookEvent (Publisher ID: " + std::to_string(environment_processor_id_) + ") for symbol " + symbol_);
+        LogMessage(LogLevel::DEBUG, get_logger_source(), "Published LTwoOrderBookEvent (Publisher ID: " + std::to_string(environment_processor_id_) + ") for symbol " + symbol);
         return order_book_event_ptr;
     }
 
@@ -266,6 +313,17 @@ public:
     SimulationEventBus& get_event_bus() { return event_bus_; }
     const SimulationEventBus& get_event_bus() const { return event_bus_; }
 
+    const std::vector<SymbolType>& get_symbols() const { return symbols_; }
+
+    std::shared_ptr<EventModelExchangeAdapter> get_exchange_adapter(const SymbolType& symbol) const {
+        for (std::size_t i = 0; i < symbols_.size(); ++i) {
+            if (symbols_[i] == symbol) {
+                return exchange_adapters_[i];
+            }
+        }
+        return nullptr;
+    }
+
 private:
     std::string get_logger_source() const { return "TradingSimulation"; }
 
@@ -273,10 +331,14 @@ private:
         LogMessage(LogLevel::INFO, get_logger_source(), "Configuring core component latencies...");
         LatencyParameters min_fixed_latency = LatencyParameters::Fixed(1.0, 1.0);
 
-        event_bus_.set_inter_agent_latency(exchange_adapter_id_, cancel_fairy_id_, min_fixed_latency);
-        event_bus_.set_inter_agent_latency(cancel_fairy_id_, exchange_adapter_id_, min_fixed_latency);
-        event_bus_.set_inter_agent_latency(exchange_adapter_id_, environment_processor_id_, min_fixed_latency);
-        event_bus_.set_inter_agent_latency(environment_processor_id_, exchange_adapter_id_, min_fixed_latency);
+        for (AgentId adapter_id : exchange_adapter_ids_) {
+            if (cancel_fairy_) {
+                event_bus_.set_inter_agent_latency(adapter_id, cancel_fairy_id_, min_fixed_latency);
+                event_bus_.set_inter_agent_latency(cancel_fairy_id_, adapter_id, min_fixed_latency);
+            }
+            event_bus_.set_inter_agent_latency(adapter_id, environment_processor_id_, min_fixed_latency);
+            event_bus_.set_inter_agent_latency(environment_processor_id_, adapter_id, min_fixed_latency);
+        }
     }
 
     void configure_trader_latencies(AgentId trader_id) {
@@ -285,8 +347,10 @@ private:
                        "No trader latency profiles defined for trader ID: " + std::to_string(trader_id) +
                        ". Using a default Lognormal(1000, 0.67, 5000).");
             LatencyParameters trader_latency = LatencyParameters::Lognormal(1000.0, 0.67, 5000.0);
-            event_bus_.set_inter_agent_latency(trader_id, exchange_adapter_id_, trader_latency);
-            event_bus_.set_inter_agent_latency(exchange_adapter_id_, trader_id, trader_latency);
+            for (AgentId adapter_id : exchange_adapter_ids_) {
+                event_bus_.set_inter_agent_latency(trader_id, adapter_id, trader_latency);
+                event_bus_.set_inter_agent_latency(adapter_id, trader_id, trader_latency);
+            }
             event_bus_.set_inter_agent_latency(environment_processor_id_, trader_id, trader_latency);
             return;
         }
@@ -303,22 +367,26 @@ private:
                    "Cap: " + std::to_string(selected_profile.cap_us) + "µs)");
 
         LatencyParameters trader_latency = selected_profile.to_latency_parameters();
-        event_bus_.set_inter_agent_latency(trader_id, exchange_adapter_id_, trader_latency);
-        event_bus_.set_inter_agent_latency(exchange_adapter_id_, trader_id, trader_latency);
+        for (AgentId adapter_id : exchange_adapter_ids_) {
+            event_bus_.set_inter_agent_latency(trader_id, adapter_id, trader_latency);
+            event_bus_.set_inter_agent_latency(adapter_id, trader_id, trader_latency);
+        }
         event_bus_.set_inter_agent_latency(environment_processor_id_, trader_id, trader_latency);
     }
 
     SimulationEventBus event_bus_; // Correctly typed EventBus
-    SymbolType symbol_;
+    std::vector<SymbolType> symbols_;
+    SymbolType symbol_; // First symbol, the default for single-symbol helpers
     std::default_random_engine latency_rng_;
 
     AgentId environment_processor_id_;
-    AgentId exchange_adapter_id_;
-    AgentId cancel_fairy_id_;
+    std::vector<AgentId> exchange_adapter_ids_;
+    AgentId cancel_fairy_id_ = EventBusSystem::INVALID_AGENT_ID;
 
     std::shared_ptr<EnvironmentProcessor> environment_processor_;
-    std::shared_ptr<EventModelExchangeAdapter> exchange_adapter_;
+    std::vector<std::shared_ptr<EventModelExchangeAdapter>> exchange_adapters_;
     std::shared_ptr<CancelFairyApp> cancel_fairy_;
+    std::unique_ptr<EventModelExchangeAdapter::ShardGroup> exchange_shards_; // Only with several symbols
 
     std::unordered_map<AgentId, TraderInterfacePtr> traders_;
 };
\ No newline at end of file
@@ -46,8 +46,6 @@ namespace trading {
             const double min_timeout_s_;
             const double max_timeout_s_;
             double default_price_float_;
-            ModelEvents::OrderBookLevel current_bids_;
-            ModelEvents::OrderBookLevel current_asks_;
             std::optional<ClientOrderIdType> active_bid_cid_;
             std::optional<ClientOrderIdType> active_ask_cid_;
             std::default_random_engine random_engine_;
@@ -92,8 +90,6 @@ namespace trading {
                 min_timeout_s_(min_timeout_s),
                 max_timeout_s_(max_timeout_s),
                 default_price_float_(50000.0),
-                current_bids_(),
-                current_asks_(),
                 active_bid_cid_(std::nullopt),
                 active_ask_cid_(std::nullopt),
                 random_engine_((zimm_seed == 0) ? std::random_device{}() : zimm_seed),
@@ -160,20 +156,22 @@ namespace trading {
             // Helper: imbalance calculation
             // ------------------------------------------------------------------ #
             double _calculate_imbalance_adjustment_bps() {
-                if (current_bids_.empty() && current_asks_.empty()) {
+                const ModelEvents::OrderBookLevel& bids = this->local_book().bids();
+                const ModelEvents::OrderBookLevel& asks = this->local_book().asks();
+                if (bids.empty() && asks.empty()) {
                     return 0.0;
                 }
 
                 QuantityType bid_vol_int = 0;
-                size_t levels_to_sum_bid = std::min(imbalance_levels_, current_bids_.size());
+                size_t levels_to_sum_bid = std::min(imbalance_levels_, bids.size());
                 for (size_t i = 0; i < levels_to_sum_bid; ++i) {
-                    bid_vol_int += current_bids_[i].second;
+                    bid_vol_int += bids[i].second;
                 }
 
                 QuantityType ask_vol_int = 0;
-                size_t levels_to_sum_ask = std::min(imbalance_levels_, current_asks_.size());
+                size_t levels_to_sum_ask = std::min(imbalance_levels_, asks.size());
                 for (size_t i = 0; i < levels_to_sum_ask; ++i) {
-                    ask_vol_int += current_asks_[i].second;
+                    ask_vol_int += asks[i].second;
                 }
 
                 // Convert to double for calculation using helpers from Model.h
@@ -216,15 +214,17 @@ namespace trading {
 
                 // --- Decide base price ---
                 double base_bid_float;
-                if (!current_asks_.empty()) {
+                const ModelEvents::OrderBookLevel& bids = this->local_book().bids();
+                const ModelEvents::OrderBookLevel& asks = this->local_book().asks();
+                if (!asks.empty()) {
                     // Use helper from Model.h
-                    double best_ask_float = ModelEvents::price_to_float(current_asks_[0].first);
+                    double best_ask_float = ModelEvents::price_to_float(asks[0].first);
                     double spread_bps = spread_dist(random_engine_);
                     // Use constant from Model.h
                     base_bid_float = best_ask_float * (1.0 - spread_bps / ModelEvents::BPS_DIVISOR);
-                } else if (!current_bids_.empty()) {
+                } else if (!bids.empty()) {
                     // Use helper from Model.h
-                    double best_bid_float = ModelEvents::price_to_float(current_bids_[0].first);
+                    double best_bid_float = ModelEvents::price_to_float(bids[0].first);
                     // Use constant from Model.h
                     base_bid_float = best_bid_float * (1.0 - edge_dist(random_engine_) / ModelEvents::BPS_DIVISOR);
                 } else {
@@ -281,15 +281,17 @@ namespace trading {
 
                 // --- Decide base price ---
                 double base_ask_float;
-                if (!current_bids_.empty()) {
+                const ModelEvents::OrderBookLevel& bids = this->local_book().bids();
+                const ModelEvents::OrderBookLevel& asks = this->local_book().asks();
+                if (!bids.empty()) {
                     // Use helper from Model.h
-                    double best_bid_float = ModelEvents::price_to_float(current_bids_[0].first);
+                    double best_bid_float = ModelEvents::price_to_float(bids[0].first);
                     double spread_bps = spread_dist(random_engine_);
                     // Use constant from Model.h
                     base_ask_float = best_bid_float * (1.0 + spread_bps / ModelEvents::BPS_DIVISOR);
-                } else if (!current_asks_.empty()) {
+                } else if (!asks.empty()) {
                     // Use helper from Model.h
-                    double best_ask_float = ModelEvents::price_to_float(current_asks_[0].first);
+                    double best_ask_float = ModelEvents::price_to_float(asks[0].first);
                     // Use constant from Model.h
                     base_ask_float = best_ask_float * (1.0 + edge_dist(random_engine_) / ModelEvents::BPS_DIVISOR);
                 } else {
@@ -337,9 +339,10 @@ namespace trading {
         protected: // Implement the pure virtual on_... methods from AlgoBase
 
             // --- Event Handlers (Overrides) ---
-            void on_LTwoOrderBookEvent(const ModelEvents::LTwoOrderBookEvent& event) override {
-                current_bids_ = event.bids;
-                current_asks_ = event.asks;
+            void on_LTwoOrderBookEvent(const ModelEvents::LTwoOrderBookEvent& event) override {}
+
+            // Quotes off local_book(), so requote once per book update whichever feed carried it.
+            void on_local_book_updated() override {
                 check_and_place_orders();
             }
 
@@ -388,6 +391,24 @@ namespace trading {
                 }
             }
 
+            void on_MassCancelLimitOrderAckEvent(const ModelEvents::MassCancelLimitOrderAckEvent& event) override {
+                LogMessage(LogLevel::INFO, this->get_logger_source(), "Received Mass Cancel ACK for Cancel Request CID: " + std::to_string(event.client_order_id) +
+                                                    ", Cancelled: " + std::to_string(event.cancelled_orders.size()));
+                bool re_quote = false;
+                for (const auto& cancelled : event.cancelled_orders) {
+                    if (active_bid_cid_ && *active_bid_cid_ == cancelled.target_order_id) {
+                        active_bid_cid_.reset();
+                        re_quote = true;
+                    } else if (active_ask_cid_ && *active_ask_cid_ == cancelled.target_order_id) {
+                        active_ask_cid_.reset();
+                        re_quote = true;
+                    }
+                }
+                if(re_quote) {
+                    check_and_place_orders();
+                }
+            }
+
             void on_PartialCancelLimitAckEvent(const ModelEvents::PartialCancelLimitAckEvent& event) override {
                 LogMessage(LogLevel::INFO, this->get_logger_source(), "Received Partial Cancel ACK for Target CID: " + std::to_string(event.target_order_id) +
                                                     " (Cancel Request CID: " + std::to_string(event.client_order_id) + ")" +
@@ -423,8 +444,6 @@ namespace trading {
             void on_Bang(const ModelEvents::Bang& event) override {
                 LogMessage(LogLevel::INFO, this->get_logger_source(), "Received Bang! Resetting state.");
                 this->create_full_cancel_all_limit_orders();
-                current_bids_.clear();
-                current_asks_.clear();
                 active_bid_cid_.reset();
                 active_ask_cid_.reset();
             }
@@ -0,0 +1,91 @@
+// file: tests/AdapterOrderRecordTest.cpp
+// Once an order entry has been processed, the exchange adapter must hold order records for resting orders only:
+// fully filled takers, unfilled market remainders and cancelled orders must not leave records behind.
+
+#include "src/Model.h"
+#include "src/EventBus.h"
+#include "src/TradingSimulation.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+const ModelEvents::SymbolType SYMBOL = "BTC/USD";
+constexpr EventBusSystem::AgentId TRADER = 1001;
+
+class OrderEntry {
+public:
+    explicit OrderEntry(EventModelExchangeAdapter& adapter) : adapter_(adapter) {}
+
+    void limit(ModelEvents::Side side, ModelEvents::PriceType price, ModelEvents::QuantityType quantity) {
+        adapter_.handle_event(ModelEvents::LimitOrderEvent(EventBusSystem::Timestamp{}, SYMBOL, side, price, quantity,
+                                                           std::chrono::seconds(60), ++client_order_id_),
+                              0, TRADER, EventBusSystem::Timestamp{}, 0, 0);
+    }
+
+    void market(ModelEvents::Side side, ModelEvents::QuantityType quantity) {
+        adapter_.handle_event(ModelEvents::MarketOrderEvent(EventBusSystem::Timestamp{}, SYMBOL, side, quantity,
+                                                            std::chrono::seconds(60), ++client_order_id_),
+                              0, TRADER, EventBusSystem::Timestamp{}, 0, 0);
+    }
+
+private:
+    EventModelExchangeAdapter& adapter_;
+    ModelEvents::ClientOrderIdType client_order_id_ = 0;
+};
+
+void check_records(EventModelExchangeAdapter& adapter, const std::string& label) {
+    check(adapter.order_record_count() == adapter.resting_order_count(),
+          label + ": " + std::to_string(adapter.order_record_count()) + " order records for " +
+          std::to_string(adapter.resting_order_count()) + " resting orders");
+}
+
+void run(bool aggregate_execution_reports) {
+    const std::string mode = aggregate_execution_reports ? "aggregated" : "per-fill";
+    TradingSimulation sim(SYMBOL, 1);
+    EventModelExchangeAdapter& adapter = *sim.get_exchange_adapter(SYMBOL);
+    adapter.set_batch_order_entry(false);
+    adapter.set_aggregate_execution_reports(aggregate_execution_reports);
+    OrderEntry entry(adapter);
+
+    entry.limit(ModelEvents::Side::SELL, 101, 5);
+    entry.limit(ModelEvents::Side::SELL, 102, 5);
+    entry.limit(ModelEvents::Side::SELL, 103, 5);
+    check_records(adapter, mode + " resting asks");
+
+    entry.market(ModelEvents::Side::BUY, 7); // Fills one level and part of the next
+    check_records(adapter, mode + " filled market order");
+
+    entry.limit(ModelEvents::Side::BUY, 102, 6); // Takes what is left at 102 and rests the remainder
+    check_records(adapter, mode + " partially filled limit order");
+
+    entry.market(ModelEvents::Side::BUY, 20); // Sweeps the asks and leaves an unfilled remainder
+    check_records(adapter, mode + " market order with an unfilled remainder");
+
+    entry.market(ModelEvents::Side::SELL, 1); // Partially fills the resting bid
+    entry.market(ModelEvents::Side::SELL, 10); // Takes the rest of it and leaves an unfilled remainder
+    check_records(adapter, mode + " book swept on both sides");
+    check(adapter.resting_order_count() == 0, mode + ": book is empty");
+}
+
+} // namespace
+
+int main() {
+    run(false);
+    run(true);
+    if (failures == 0) {
+        std::cout << "AdapterOrderRecordTest passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+// file: tests/ReplaceLimitOrderVolTest.cpp
+// replace_limit_order_vol must journal the level once the replacement order is booked, so that the level journal
+// and the depth index agree with the level's resting quantity.
+
+#include "src/EventBus.h"
+#include "src/OrderBookCore.h"
+
+#include <iostream>
+#include <tuple>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+template <TRIPLEOPTION PrioOpt>
+void check_replace(const char* name) {
+    OrderBookWrapper<> book;
+    auto first = book.book_price_quantity<DOUBLEOPTION::BACK>(SIDE::BID, 100, 10);
+    book.book_price_quantity<DOUBLEOPTION::BACK>(SIDE::BID, 100, 5);
+    ID_TYPE first_uoid = std::get<0>(*first);
+    book.clear_level_changes();
+
+    auto replaced = book.replace_limit_order_vol<PrioOpt>(first_uoid, 25);
+    check(replaced.has_value(), name);
+
+    const auto& changes = book.get_level_changes();
+    check(changes.size() == 1, "one level change per replaced level");
+    if (!changes.empty()) {
+        check(changes.back().side_ == SIDE::BID && changes.back().price_ == 100, "level change for the replaced level");
+        check(changes.back().new_quantity_ == 30, "level change carries the replacement quantity");
+    }
+    // Bid-side depth is what an ask can take.
+    check(book.get_available_volume(SIDE::ASK) == 30, "depth index holds the replacement quantity");
+    check(book.get_volume_for_price(SIDE::ASK, 100) == 30, "depth at the replaced price holds the replacement quantity");
+}
+
+} // namespace
+
+int main() {
+    check_replace<TRIPLEOPTION::INPLACE>("replace in place");
+    check_replace<TRIPLEOPTION::FRONT>("replace to front");
+    check_replace<TRIPLEOPTION::BACK>("replace to back");
+    if (failures == 0) {
+        std::cout << "ReplaceLimitOrderVolTest passed" << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}